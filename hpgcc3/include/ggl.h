@@ -189,6 +189,74 @@ void ggl_freescr();        // FREE SCREEN BUFFER
  */
 void ggl_gethpgscreen(gglsurface *srf);
 
+#ifndef __HPGRAPHICS_TYPE_DEFINED
+#define __HPGRAPHICS_TYPE_DEFINED 1
+typedef struct hpg_graphics hpg_t;
+#endif
+struct hpg_font;
+
+/*!
+ * \brief Draws an area of a surface onto an HPG image.
+ *
+ * The surface is read in place, without copying it to an intermediate
+ * buffer: a gray16 surface has the layout of a 4 bits per pixel
+ * ::hpg_static_t and is drawn with ::hpg_blit_static.  GGL can then render
+ * into a surface that is composed onto any HPG image, of any depth.
+ * The destination is clipped to the image and its clipping region.
+ *
+ * \param dest   The HPG image to draw onto
+ * \param dx     The left coordinate of the area on the image
+ * \param dy     The top coordinate of the area on the image
+ * \param src    The surface to read. The area starts at the coordinates
+ *               x and y given in the proper fields of the ::gglsurface
+ *               structure.
+ * \param width  The width in pixels of the rectangular region
+ * \param height The height in pixels of the rectangular region
+ * \param flags  HPG_BLIT_* flags, see ::hpg_blit_static
+ *
+ * \sa ggl_hpgblt
+ */
+void ggl_blthpg(hpg_t *dest,int dx,int dy,gglsurface *src,int width,int height,int flags);
+
+/*!
+ * \brief Copies an area of an HPG image onto a surface.
+ *
+ * The pixels are read with ::hpg_get_pixel and written straight into the
+ * surface, 8 at a time.  HPG colors are reduced to their 4 most significant
+ * bits.  The area is clipped to the image; as with ggl_bitblt, there's no
+ * clipping on the surface.
+ *
+ * \param dest   The surface to draw onto. The area starts at the
+ *               coordinates x and y given in the proper fields of the
+ *               ::gglsurface structure.
+ * \param src    The HPG image to read
+ * \param sx     The left coordinate of the area on the image
+ * \param sy     The top coordinate of the area on the image
+ * \param width  The width in pixels of the rectangular region
+ * \param height The height in pixels of the rectangular region
+ *
+ * \sa ggl_blthpg
+ */
+void ggl_hpgblt(gglsurface *dest,hpg_t *src,int sx,int sy,int width,int height);
+
+/*!
+ * \brief Draws text with an HPG font onto a surface.
+ *
+ * The glyphs come from the cache of hpg_draw_text_fast_on (see
+ * ::hpg_font_get_glyph) and are written straight into the surface.  The
+ * paper pixels are left untouched.  A newline character starts a new line
+ * at x.  There's no clipping.
+ *
+ * \param srf   The surface to draw onto. The coordinates are relative to
+ *              the x and y fields of the ::gglsurface structure.
+ * \param font  The HPG font
+ * \param s     A null-terminated string
+ * \param x     The left coordinate of the text
+ * \param y     The top coordinate of the text
+ * \param color The color, as returned by ggl_mkcolor
+ */
+void ggl_hpgtext(gglsurface *srf,struct hpg_font *font,char *s,int x,int y,int color);
+
 /*!
  * \brief Sets a 16-color display mode.
  *
@@ -399,6 +467,93 @@ void ggl_rect(gglsurface *srf,int x1,int y1,int x2,int y2,int color); // low-lev
  */
 void ggl_rectp(gglsurface *srf,int x1,int y1,int x2,int y2,int *color); // low-level rectangle with 8x8 pattern
 
+// filled shapes, drawn as spans with ggl_hline
+
+/*!
+ * \brief Draws a filled circle on a surface.
+ *
+ * Fills all pixels (x,y) with (x-xc)^2+(y-yc)^2 <= r^2+r, which is the area
+ * enclosed by a midpoint circle of radius r. The circle is drawn one
+ * horizontal span per row using ggl_hline. There's no clipping.
+ *
+ * \param srf   The surface to draw onto.
+ * \param xc    X coordinate of the center.
+ * \param yc    Y coordinate of the center.
+ * \param r     Radius in pixels.
+ * \param color The color pattern, as in ggl_hline.
+ *
+ * \sa ggl_fillcirclep
+ * \sa ggl_fillellipse
+ */
+void ggl_fillcircle(gglsurface *srf,int xc,int yc,int r,int color);
+
+/*!
+ * \brief Draws a filled circle on a surface with a 2D pattern.
+ *
+ * Same as ggl_fillcircle, using an 8x8 pattern as in ggl_rectp.
+ *
+ * \sa ggl_fillcircle
+ * \sa ggl_rectp
+ */
+void ggl_fillcirclep(gglsurface *srf,int xc,int yc,int r,int *pattern);
+
+/*!
+ * \brief Draws a filled ellipse on a surface.
+ *
+ * Fills the axis-aligned ellipse of center (xc,yc) that spans
+ * rx pixels to each side and ry pixels up and down: all pixels with
+ * ((x-xc)/(rx+1/2))^2+((y-yc)/(ry+1/2))^2 <= 1. Exact integer arithmetic
+ * is used, one horizontal span per row. There's no clipping.
+ *
+ * \param srf   The surface to draw onto.
+ * \param xc    X coordinate of the center.
+ * \param yc    Y coordinate of the center.
+ * \param rx    Horizontal radius in pixels.
+ * \param ry    Vertical radius in pixels.
+ * \param color The color pattern, as in ggl_hline.
+ *
+ * \sa ggl_fillellipsep
+ * \sa ggl_fillcircle
+ */
+void ggl_fillellipse(gglsurface *srf,int xc,int yc,int rx,int ry,int color);
+
+/*!
+ * \brief Draws a filled ellipse on a surface with a 2D pattern.
+ *
+ * Same as ggl_fillellipse, using an 8x8 pattern as in ggl_rectp.
+ *
+ * \sa ggl_fillellipse
+ * \sa ggl_rectp
+ */
+void ggl_fillellipsep(gglsurface *srf,int xc,int yc,int rx,int ry,int *pattern);
+
+/*!
+ * \brief Draws a filled polygon on a surface.
+ *
+ * Fills a polygon with the even-odd rule using an edge table and exact
+ * integer edge stepping, one ggl_hline per span. Pixels on the right and
+ * bottom borders are not filled, so polygons sharing an edge never
+ * overlap. The polygon is closed automatically. There's no clipping.
+ *
+ * \param srf     The surface to draw onto.
+ * \param pts     Array of vertex coordinates x0,y0,x1,y1,...
+ * \param npoints Number of vertices (2*npoints integers in pts).
+ * \param color   The color pattern, as in ggl_hline.
+ *
+ * \sa ggl_fillpolyp
+ */
+void ggl_fillpoly(gglsurface *srf,int *pts,int npoints,int color);
+
+/*!
+ * \brief Draws a filled polygon on a surface with a 2D pattern.
+ *
+ * Same as ggl_fillpoly, using an 8x8 pattern as in ggl_rectp.
+ *
+ * \sa ggl_fillpoly
+ * \sa ggl_rectp
+ */
+void ggl_fillpolyp(gglsurface *srf,int *pts,int npoints,int *pattern);
+
 // rectangle blt
 // note: see gglsurface above for complete understanding of the behavior of these routines
 // ggl_bitblt loops from top to bottom
@@ -468,6 +623,78 @@ void ggl_revblt(gglsurface *dest,gglsurface *src,int width, int height); // copy
  * \sa ggl_revblt
  */
 void ggl_ovlblt(gglsurface *dest,gglsurface *src,int width, int height); // copy overlapped regions
+
+// shift-specialized versions of the 3 routines above
+// there's one row kernel for each of the 8 possible nibble shifts between
+// src and dest, the kernel is picked once per call when both surfaces have a
+// width multiple of 8 pixels (once per row otherwise)
+
+/*!
+ * \brief Copies a rectangular surface. Forward direction, fast version.
+ *
+ * Same as ::ggl_bitblt, but uses a separate unrolled copy loop for each of
+ * the 8 possible nibble shifts between source and destination. The loop is
+ * chosen only once per call when the width of both surfaces is a multiple of
+ * 8 pixels (full-screen and word-aligned off-screen buffers), and once per
+ * row otherwise.
+ *
+ * \param dest   The surface to draw onto. The area will be copied at the
+ *               coordinates x and y given in the proper fields of the
+ *               ::gglsurface structure.
+ * \param src    The source surface. The region to copy will start at the
+ *               coordinates x and y given in the proper fields of the
+ *               ::gglsurface structure.
+ * \param width  The width in pixels of the rectangular region to copy.
+ * \param height The height in pixels of the rectangular region to copy.
+ *
+ * \sa ggl_bitblt
+ * \sa ggl_fastrevblt
+ * \sa ggl_fastovlblt
+ */
+void ggl_fastblt(gglsurface *dest,gglsurface *src,int width, int height);
+
+/*!
+ * \brief Copies a rectangular surface. Reverse direction, fast version.
+ *
+ * Same as ::ggl_revblt, using the shift-specialized loops of ::ggl_fastblt.
+ * Rows are copied from bottom to top, and each row from right to left.
+ *
+ * \param dest   The surface to draw onto. The area will be copied at the
+ *               coordinates x and y given in the proper fields of the
+ *               ::gglsurface structure.
+ * \param src    The source surface. The region to copy will start at the
+ *               coordinates x and y given in the proper fields of the
+ *               ::gglsurface structure.
+ * \param width  The width in pixels of the rectangular region to copy.
+ * \param height The height in pixels of the rectangular region to copy.
+ *
+ * \sa ggl_revblt
+ * \sa ggl_fastblt
+ * \sa ggl_fastovlblt
+ */
+void ggl_fastrevblt(gglsurface *dest,gglsurface *src,int width, int height);
+
+/*!
+ * \brief Copies a rectangular surface. Safe to use when areas overlap, fast version.
+ *
+ * Same as ::ggl_ovlblt, choosing between ::ggl_fastblt and ::ggl_fastrevblt
+ * based on the addresses of both areas.
+ *
+ * \param dest   The surface to draw onto. The area will be copied at the
+ *               coordinates x and y given in the proper fields of the
+ *               ::gglsurface structure.
+ * \param src    The source surface. The region to copy will start at the
+ *               coordinates x and y given in the proper fields of the
+ *               ::gglsurface structure.
+ * \param width  The width in pixels of the rectangular region to copy.
+ * \param height The height in pixels of the rectangular region to copy.
+ *
+ * \sa ggl_ovlblt
+ * \sa ggl_fastblt
+ * \sa ggl_fastrevblt
+ */
+void ggl_fastovlblt(gglsurface *dest,gglsurface *src,int width, int height);
+
 // ggl_bitbltmask behaves exactly as ggl_bitblt but using tcol as a transparent color
 
 
@@ -477,7 +704,7 @@ void ggl_ovlblt(gglsurface *dest,gglsurface *src,int width, int height); // copy
  * Performs a bitblit copy operation where the given color is considered
  * transparent, thus not affecting the background color. The direction
  * of the memory movement is from top to bottom.
- * Note: This is a macro that calls ggl_bitbltoper with the proper operator.
+ * Note: This is a macro that calls ggl_fastbltoper with the proper operator.
  *
  * \param dest   The surface to draw onto. The area will be copied at the
  *               coordinates x and y given in the proper fields of the 
@@ -492,8 +719,9 @@ void ggl_ovlblt(gglsurface *dest,gglsurface *src,int width, int height); // copy
  *
  * \sa ggl_bitblt
  * \sa ggl_bitbltoper
+ * \sa ggl_fastbltoper
  */
-#define ggl_bitbltmask(dest,src,width,height,tcol)  ggl_bitbltoper(dest,src,width,height,tcol,&ggl_opmask)
+#define ggl_bitbltmask(dest,src,width,height,tcol)  ggl_fastbltoper(dest,src,width,height,tcol,&ggl_opmask)
 
 
 // rectangle scrolling routines
@@ -574,6 +802,377 @@ void ggl_scrolllf(gglsurface *dest,int width, int height, int npixels); // scrol
  */
 void ggl_scrollrt(gglsurface *dest,int width, int height, int npixels); // scroll npixels right
 
+// hardware scrolling virtual screen
+
+/*!
+ * \brief Horizontal granularity of the virtual screen, in pixels.
+ *
+ * The LCD controller addresses the frame buffer in halfwords, so the
+ * visible window of a ::gglvscreen can only start at multiples of 4 pixels.
+ */
+#define GGL_VSCR_XSTEP 4
+
+/*!
+ * \brief A virtual screen larger than the LCD, scrolled by the hardware.
+ *
+ * The LCD displays a window of the virtual screen. Scrolling moves the
+ * window by reprogramming the LCD start address registers, so no pixels
+ * are moved and only the newly exposed strip needs to be drawn.
+ * Draw on \c srf with coordinates offset by \c posx and \c posy to
+ * reach the visible window. All fields are read-only.
+ *
+ * \sa ggl_vscrinit
+ */
+typedef struct {
+    gglsurface srf;         //! The whole virtual screen (srf.width = virtual width)
+    int height;             //! Virtual height in pixels
+    int posx,posy;          //! Top-left corner of the visible window within srf
+    int viewwidth,viewheight;   //! Size of the visible window
+    int *physaddr;          //! Physical address of the frame buffer
+    unsigned int lcdstate[STATEBUFSIZE/4];  //! LCD state to restore on exit
+} gglvscreen;
+
+/*!
+ * \brief Allocates a virtual screen and displays it.
+ *
+ * Allocates a cleared virtual frame buffer of the given size, saves the
+ * LCD state and switches the LCD to 16-gray mode showing the top-left
+ * corner of the virtual screen. The width is rounded up to a multiple of
+ * ::GGL_VSCR_XSTEP, and both dimensions are at least one screen.
+ * A virtual size of at least twice the screen in the scrolling direction
+ * is recommended, see ggl_vscrollup.
+ * Do not use together with HPG, which manages the LCD itself.
+ *
+ * \param vs      The virtual screen to initialize.
+ * \param vwidth  Virtual width in pixels.
+ * \param vheight Virtual height in pixels.
+ * \return 1 if successful, 0 if out of memory or the width is too large.
+ *
+ * \sa ggl_vscrexit
+ */
+int ggl_vscrinit(gglvscreen *vs,int vwidth,int vheight);
+
+/*!
+ * \brief Restores the LCD and frees a virtual screen.
+ *
+ * \param vs The virtual screen, initialized with ggl_vscrinit.
+ */
+void ggl_vscrexit(gglvscreen *vs);
+
+/*!
+ * \brief Moves the visible window of a virtual screen.
+ *
+ * Shows the window with top-left corner at (x,y) within the virtual screen.
+ * The position is clipped to the virtual screen, and x is rounded down to
+ * a multiple of ::GGL_VSCR_XSTEP. No pixels are moved.
+ * No VSYNC is performed.
+ *
+ * \param vs The virtual screen.
+ * \param x  Horizontal position of the window.
+ * \param y  Vertical position of the window.
+ */
+void ggl_vscrsetpos(gglvscreen *vs,int x,int y);
+
+/*!
+ * \brief Scrolls the contents of the screen up using the hardware.
+ *
+ * Same effect as ggl_scrollup on the whole screen, but the window is moved
+ * down instead of moving the pixels. When the window reaches the bottom of
+ * the virtual screen, the part that remains visible is copied once to the
+ * top and the window continues from there, so with a virtual height of N
+ * screens a full copy happens only every N-1 screens of scrolling.
+ * After the call the exposed strip is at rows posy+viewheight-npixels to
+ * posy+viewheight-1 of \c srf, and its contents are undefined.
+ *
+ * \param vs      The virtual screen.
+ * \param npixels Number of pixels to scroll, up to one screen.
+ * \return The number of pixels actually scrolled.
+ *
+ * \sa ggl_vscrolldn
+ * \sa ggl_vscrolllf
+ * \sa ggl_vscrollrt
+ */
+int ggl_vscrollup(gglvscreen *vs,int npixels);
+
+/*!
+ * \brief Scrolls the contents of the screen down using the hardware.
+ *
+ * Same as ggl_vscrollup in the opposite direction. After the call the
+ * exposed strip is at rows posy to posy+npixels-1 of \c srf.
+ *
+ * \sa ggl_vscrollup
+ */
+int ggl_vscrolldn(gglvscreen *vs,int npixels);
+
+/*!
+ * \brief Scrolls the contents of the screen left using the hardware.
+ *
+ * Same as ggl_vscrollup, horizontally. npixels is rounded down to a
+ * multiple of ::GGL_VSCR_XSTEP. After the call the exposed strip is at
+ * columns posx+viewwidth-n to posx+viewwidth-1 of \c srf, where n is the
+ * returned value.
+ *
+ * \sa ggl_vscrollup
+ */
+int ggl_vscrolllf(gglvscreen *vs,int npixels);
+
+/*!
+ * \brief Scrolls the contents of the screen right using the hardware.
+ *
+ * Same as ggl_vscrolllf in the opposite direction. After the call the
+ * exposed strip is at columns posx to posx+n-1 of \c srf, where n is the
+ * returned value.
+ *
+ * \sa ggl_vscrolllf
+ */
+int ggl_vscrollrt(gglvscreen *vs,int npixels);
+
+
+/*!
+ * \brief Maximum number of buffers of a ::gglframes chain.
+ */
+#define GGL_FRAME_MAXBUFFERS 3
+
+/*!
+ * \brief Flag for ggl_frameinit: never wait in ggl_frameend.
+ *
+ * A frame that is still queued when a newer one is finished is discarded
+ * and replaced by the newer frame (counted in gglframes::discarded), so
+ * the application can render ahead freely and the newest frame is always
+ * the one shown. Without this flag, ggl_frameend waits for the queued
+ * frame to reach the screen.
+ */
+#define GGL_FRAME_DISCARD 2
+
+/*!
+ * \brief Number of scanlines before the end of a frame when the timer
+ * based flip may take place.
+ */
+#define GGL_FRAME_VMARGIN 8
+
+/*!
+ * \brief A chain of screen buffers shown at the LCD frame rate.
+ *
+ * One buffer is on screen, at most one is queued to be shown at the next
+ * presentation slot, and the application draws on another. Presentation
+ * slots happen once every \c interval LCD frames, so an LCD refreshing
+ * at f Hz gives f, f/2, f/3... frames per second. The queued buffer is
+ * shown by an interrupt handler, so the application never has to wait
+ * for the vertical sync. When it does have to wait for a free buffer, the
+ * CPU is idle until the next interrupt instead of spinning.
+ *
+ * The handler is a 1 ms timed event that polls the LCD line counter and
+ * flips during the last ::GGL_FRAME_VMARGIN lines of each frame. The LCD
+ * frame interrupt can't be used: the S3C2410 only raises it for TFT
+ * panels, and the calculator has an STN panel.
+ *
+ * All fields are read-only. The statistics can be cleared with
+ * ggl_frameresetstats.
+ *
+ * \sa ggl_frameinit
+ */
+typedef struct {
+    gglsurface buffer[GGL_FRAME_MAXBUFFERS];    //! Screen buffers, LCD_W pixels wide
+    int *physaddr[GGL_FRAME_MAXBUFFERS];        //! Physical address of each buffer
+    int nbuffers;           //! Number of buffers, 2 or 3
+    int height;             //! Height of the buffers in pixels
+    int interval;           //! LCD frames per presentation slot
+    int flags;              //! GGL_FRAME_XXX flags given to ggl_frameinit
+    volatile int shown;     //! Index of the buffer on screen
+    volatile int queued;    //! Index of the buffer waiting for the next slot, -1 if none
+    int drawing;            //! Index of the buffer returned by ggl_framebegin, -1 if none
+    int phase;              //! LCD frames since the last slot
+    int invblank;           //! Already flipped during this blanking period
+    int event;              //! Timed event handle of the flip handler
+    unsigned long long lastflip;    //! Time of the last flip in system timer ticks
+    volatile unsigned int vblanks;      //! LCD frames seen
+    volatile unsigned int presented;    //! Frames shown
+    volatile unsigned int dropped;      //! Slots where no new frame was ready (the previous one stayed on screen)
+    volatile unsigned int discarded;    //! Frames replaced before being shown (GGL_FRAME_DISCARD)
+    volatile int lastus;    //! Time between the last two flips, in microseconds
+    volatile int minus,maxus;   //! Shortest and longest time between flips, in microseconds
+    volatile unsigned long long totalus;    //! Sum of all times between flips (average = totalus/(presented-1))
+    unsigned int lcdstate[STATEBUFSIZE/4];  //! LCD state to restore on exit
+} gglframes;
+
+/*!
+ * \brief Allocates a chain of screen buffers and starts frame pacing.
+ *
+ * Allocates \c nbuffers cleared screen buffers, saves the LCD state,
+ * switches the LCD to 16-gray mode showing the first buffer and installs
+ * the flip handler. Only one chain can be active at a time. Do not use
+ * together with HPG, which manages the LCD itself.
+ *
+ * \param fr       The chain to initialize.
+ * \param nbuffers 2 for double buffering, 3 for triple buffering.
+ * \param interval Show a new frame every \c interval LCD frames (1 or more).
+ * \param flags    ::GGL_FRAME_DISCARD or 0.
+ * \return 1 if successful, 0 if out of memory, out of timed events or
+ *         another chain is active.
+ *
+ * \sa ggl_frameexit
+ */
+int ggl_frameinit(gglframes *fr,int nbuffers,int interval,int flags);
+
+/*!
+ * \brief Stops frame pacing, restores the LCD and frees the buffers.
+ *
+ * \param fr The chain, initialized with ggl_frameinit.
+ */
+void ggl_frameexit(gglframes *fr);
+
+/*!
+ * \brief Returns the surface to draw the next frame on.
+ *
+ * Returns a buffer that is neither on screen nor queued, waiting (with
+ * the CPU idle) only when double buffering with a frame still queued.
+ * The contents of the buffer are those of an older frame, not necessarily
+ * the previous one. Calling it again before ggl_frameend returns the same
+ * surface.
+ *
+ * \param fr The chain.
+ * \return The surface to draw on.
+ *
+ * \sa ggl_frameend
+ */
+gglsurface *ggl_framebegin(gglframes *fr);
+
+/*!
+ * \brief Queues the frame drawn since ggl_framebegin.
+ *
+ * The frame is shown at the next presentation slot. If another frame is
+ * still queued, this waits for it to be shown, or discards it when the
+ * chain was created with ::GGL_FRAME_DISCARD.
+ *
+ * \param fr The chain.
+ *
+ * \sa ggl_framebegin
+ */
+void ggl_frameend(gglframes *fr);
+
+/*!
+ * \brief Waits until all queued frames are on screen.
+ *
+ * \param fr The chain.
+ */
+void ggl_frameflush(gglframes *fr);
+
+/*!
+ * \brief Clears the frame statistics of a chain.
+ *
+ * \param fr The chain.
+ */
+void ggl_frameresetstats(gglframes *fr);
+
+// tile maps
+
+/*!
+ * \brief A tile map drawn into a viewport of a surface.
+ *
+ * The atlas holds the tiles one after the other, each tile being
+ * tilesize rows of tilesize gray16 pixels (tilesize*tilesize/8 words), which
+ * is the same as a surface of width tilesize with the tiles stacked
+ * vertically. The map holds one atlas index per cell, row by row.
+ * The viewport is drawn with its top-left corner at the x and y fields of
+ * the destination ::gglsurface, showing the map from pixel (scrollx,scrolly).
+ * Fields can be changed directly, then redraw with ggl_tmdraw.
+ *
+ * \sa ggl_tminit
+ */
+typedef struct {
+    int *tiles;             //! Tile atlas
+    int tilesize;           //! Tile size in pixels, 8 or 16
+    unsigned short *map;    //! Map of atlas indices, mapwidth*mapheight entries
+    int mapwidth,mapheight; //! Map size in tiles
+    int scrollx,scrolly;    //! Map pixel shown at the top-left corner of the viewport
+    int viewwidth,viewheight;   //! Viewport size in pixels
+    int bgcolor;            //! Color pattern for the area outside the map, aligned to map x
+} ggltilemap;
+
+/*!
+ * \brief Initializes a tile map.
+ *
+ * Fills in all the fields of a ::ggltilemap, with the scroll position at
+ * the top-left corner of the map and a white background. No memory is
+ * allocated, the atlas and map arrays are owned by the caller.
+ *
+ * \param tm         The tile map to initialize.
+ * \param tiles      The tile atlas.
+ * \param tilesize   Tile size in pixels, 8 or 16.
+ * \param map        The map of atlas indices.
+ * \param mapwidth   Map width in tiles.
+ * \param mapheight  Map height in tiles.
+ * \param viewwidth  Viewport width in pixels.
+ * \param viewheight Viewport height in pixels.
+ */
+void ggl_tminit(ggltilemap *tm,int *tiles,int tilesize,unsigned short *map,int mapwidth,int mapheight,int viewwidth,int viewheight);
+
+/*!
+ * \brief Draws the whole viewport of a tile map.
+ *
+ * Only the tiles that intersect the viewport are drawn. Whole tile rows
+ * that start on a word boundary of a surface with a width multiple of 8
+ * are copied as words, other tiles are drawn with ggl_fastblt.
+ *
+ * \param tm   The tile map.
+ * \param dest The surface to draw onto. The viewport starts at the
+ *             coordinates x and y given in the proper fields of the
+ *             ::gglsurface structure.
+ *
+ * \sa ggl_tmdrawrect
+ * \sa ggl_tmscroll
+ */
+void ggl_tmdraw(ggltilemap *tm,gglsurface *dest);
+
+/*!
+ * \brief Draws part of the viewport of a tile map.
+ *
+ * Same as ggl_tmdraw, restricted to a rectangle given in viewport
+ * coordinates. The rectangle is clipped to the viewport.
+ *
+ * \param tm   The tile map.
+ * \param dest The surface to draw onto, with the viewport at its x,y.
+ * \param x    Left coordinate of the area within the viewport.
+ * \param y    Top coordinate of the area within the viewport.
+ * \param w    Width in pixels of the area.
+ * \param h    Height in pixels of the area.
+ *
+ * \sa ggl_tmdraw
+ */
+void ggl_tmdrawrect(ggltilemap *tm,gglsurface *dest,int x,int y,int w,int h);
+
+/*!
+ * \brief Scrolls a tile map.
+ *
+ * Moves the scroll position by (dx,dy) pixels: positive dx shows more of the
+ * map to the right, positive dy shows more of the map below. The part of
+ * the viewport that stays visible is moved with ggl_fastovlblt, and only
+ * the exposed rows and columns are drawn. The viewport must have been
+ * drawn before at the previous scroll position.
+ *
+ * \param tm   The tile map.
+ * \param dest The surface to draw onto, with the viewport at its x,y.
+ * \param dx   Horizontal scroll in pixels.
+ * \param dy   Vertical scroll in pixels.
+ *
+ * \sa ggl_tmdraw
+ */
+void ggl_tmscroll(ggltilemap *tm,gglsurface *dest,int dx,int dy);
+
+/*!
+ * \brief Changes one cell of a tile map.
+ *
+ * Stores the new atlas index in the map and, if dest is not NULL, redraws
+ * the visible part of that cell.
+ *
+ * \param tm   The tile map.
+ * \param dest The surface with the viewport at its x,y, or NULL.
+ * \param col  Column of the cell.
+ * \param row  Row of the cell.
+ * \param tile New atlas index.
+ */
+void ggl_tmsettile(ggltilemap *tm,gglsurface *dest,int col,int row,int tile);
+
 // custom filters and operators
 
 // bitmap filtering routine
@@ -621,6 +1220,200 @@ void ggl_filter(gglsurface *dest,int width, int height, int param, gglfilter fil
  */
 void ggl_bitbltoper(gglsurface *dest,gglsurface *src,int width, int height,int param,ggloperator filterfunc);
 
+/*!
+ * \brief Applies a filter to a surface, with inlined predefined filters.
+ *
+ * Same as ggl_filter. When filterfunc is ggl_fltlighten or ggl_fltdarken
+ * the filter is expanded inline and applied to 8 pixels at a time, without
+ * calling the filter function. Any other filter is called once per word.
+ *
+ * \param dest    The surface to filter. The area to filter starts at
+ *                coordinates x and y given in the proper fields of the 
+ *                ::gglsurface structure.
+ * \param width   The width in pixels of the rectangular region to filter.
+ * \param height  The height in pixels of the rectangular region to filter.
+ * \param param   A parameter to be passed to the filter.
+ * \param filterfunc The filter function to apply.
+ *
+ * \sa ggl_filter
+ * \sa ggl_fastbltoper
+ */
+void ggl_fastfilter(gglsurface *dest,int width, int height, int param, gglfilter filterfunc);
+
+/*!
+ * \brief Applies a binary operator to a surface, with inlined predefined operators.
+ *
+ * Same as ggl_bitbltoper. When filterfunc is ggl_opmask or ggl_optransp
+ * the operator is fused into the shift-specialized row loops of
+ * ggl_fastblt, without calling the operator function. Any other operator
+ * is called once per word. ggl_optransp blends with truncation, and
+ * weights of 0 and 16 reduce to a plain copy and a no-op.
+ *
+ * \param dest    The surface to operate on. The area starts at
+ *                coordinates x and y given in the proper fields of the 
+ *                ::gglsurface structure.
+ * \param src     The source surface. The area starts at coordinates x
+ *                and y given in the proper fields of the ::gglsurface
+ *                structure.
+ * \param width   The width in pixels of the rectangular region.
+ * \param height  The height in pixels of the rectangular region.
+ * \param param   A parameter to be passed to the operator.
+ * \param filterfunc The operator function to apply.
+ *
+ * \sa ggl_bitbltoper
+ * \sa ggl_fastfilter
+ * \sa ggl_bitbltmask
+ */
+void ggl_fastbltoper(gglsurface *dest,gglsurface *src,int width, int height,int param,ggloperator filterfunc);
+
+// precompiled transparent sprites
+
+/*!
+ * \brief Width in pixels of a precompiled sprite.
+ * \sa ggl_mksprite
+ */
+#define ggl_spritewidth(sprite) ((int)((sprite)[0]&0xffff))
+
+/*!
+ * \brief Height in pixels of a precompiled sprite.
+ * \sa ggl_mksprite
+ */
+#define ggl_spriteheight(sprite) ((int)((sprite)[0]>>16))
+
+/*!
+ * \brief Compiles a transparent sprite from a surface.
+ *
+ * Converts a region of a surface into the precompiled sprite format used
+ * by ggl_spriteblt. Pixels of color tcol are transparent. The sprite
+ * stores runs of opaque words and per-word masks for partially transparent
+ * words; fully transparent words are not stored at all.
+ * Call first with sprite=NULL to obtain the size, then allocate and call
+ * again. Sprites can also be compiled at build time with the gglsprc tool.
+ *
+ * \param sprite Buffer to receive the sprite, or NULL to compute its size.
+ * \param src    The source surface. The region starts at the coordinates
+ *               x and y given in the proper fields of the ::gglsurface
+ *               structure.
+ * \param width  The width in pixels of the region (1 to 65535).
+ * \param height The height in pixels of the region (1 to 65535).
+ * \param tcol   Transparent color (between 0 and 15).
+ * \return Size of the sprite in words, or 0 if the size is invalid.
+ *
+ * \sa ggl_mkspritemask
+ * \sa ggl_spriteblt
+ */
+int ggl_mksprite(unsigned int *sprite,gglsurface *src,int width,int height,int tcol);
+
+/*!
+ * \brief Compiles a transparent sprite from a surface and a mask.
+ *
+ * Same as ggl_mksprite, but the transparent pixels are given by a
+ * separate mask surface: pixels that are 0 in the mask are transparent,
+ * any other value is opaque. This allows all 16 colors in the sprite.
+ *
+ * \param sprite Buffer to receive the sprite, or NULL to compute its size.
+ * \param src    The source surface, starting at its x and y coordinates.
+ * \param mask   The mask surface, starting at its x and y coordinates.
+ * \param width  The width in pixels of the region (1 to 65535).
+ * \param height The height in pixels of the region (1 to 65535).
+ * \return Size of the sprite in words, or 0 if the size is invalid.
+ *
+ * \sa ggl_mksprite
+ * \sa ggl_spriteblt
+ */
+int ggl_mkspritemask(unsigned int *sprite,gglsurface *src,gglsurface *mask,int width,int height);
+
+/*!
+ * \brief Draws a precompiled sprite.
+ *
+ * Draws a sprite created by ggl_mksprite, ggl_mkspritemask or gglsprc.
+ * Fully transparent words are skipped, opaque words are copied directly
+ * and only partially transparent words are masked, so the cost depends
+ * on the number of opaque pixels rather than on the sprite area.
+ * As with ggl_bitblt, there's no clipping: the sprite must fit entirely
+ * within the destination surface.
+ *
+ * \param dest   The surface to draw onto. The sprite is drawn at the
+ *               coordinates x and y given in the proper fields of the
+ *               ::gglsurface structure.
+ * \param sprite The precompiled sprite.
+ *
+ * \sa ggl_mksprite
+ * \sa ggl_bitbltmask
+ */
+void ggl_spriteblt(gglsurface *dest,const unsigned int *sprite);
+
+// depth conversion
+
+/*!
+ * \brief Conversion mode: replace the destination pixels.
+ */
+#define GGL_CONV_COPY 0
+
+/*!
+ * \brief Conversion mode: source pixels of value 0 (white) are transparent.
+ */
+#define GGL_CONV_TRANSP 1
+
+/*!
+ * \brief Conversion mode: exclusive-or the source pixels onto the destination.
+ */
+#define GGL_CONV_XOR 2
+
+/*!
+ * \brief Flag for ggl_reduceblt: ordered 4x4 dither instead of rounding.
+ */
+#define GGL_CONV_DITHER 4
+
+/*!
+ * \brief Draws a packed mono or 4-gray bitmap on a gray16 surface.
+ *
+ * The source is a bitmap of 1 or 2 bits per pixel, pixel (x,y) at offset
+ * y*srcwidth+x starting at the least significant bits of each word, as the
+ * bits of an ::hpg_static_t. Mono pixel 1 becomes black (15) and 4-gray
+ * levels 0 to 3 become 0, 5, 10 and 15. Each source byte is expanded with a
+ * lookup table and 8 pixels are written at a time. As with ggl_bitblt,
+ * there's no clipping.
+ *
+ * \param dest     The surface to draw onto. The area starts at the
+ *                 coordinates x and y given in the proper fields of the
+ *                 ::gglsurface structure.
+ * \param src      The packed bitmap.
+ * \param srcbpp   Bits per pixel of the bitmap, 1 or 2.
+ * \param srcwidth Width in pixels of the bitmap.
+ * \param sx       Left coordinate of the area within the bitmap.
+ * \param sy       Top coordinate of the area within the bitmap.
+ * \param width    The width in pixels of the rectangular region.
+ * \param height   The height in pixels of the rectangular region.
+ * \param mode     GGL_CONV_COPY, GGL_CONV_TRANSP or GGL_CONV_XOR.
+ *
+ * \sa ggl_reduceblt
+ */
+void ggl_expandblt(gglsurface *dest,const unsigned int *src,int srcbpp,int srcwidth,int sx,int sy,int width,int height,int mode);
+
+/*!
+ * \brief Converts an area of a gray16 surface to a packed mono or 4-gray bitmap.
+ *
+ * The reverse of ggl_expandblt: grays are rounded to the nearest level,
+ * or dithered with a 4x4 ordered matrix aligned to the destination
+ * coordinates when GGL_CONV_DITHER is given. Each pair of source pixels is
+ * reduced with a lookup table. There's no clipping.
+ *
+ * \param dest      The packed bitmap.
+ * \param destbpp   Bits per pixel of the bitmap, 1 or 2.
+ * \param destwidth Width in pixels of the bitmap.
+ * \param dx        Left coordinate of the area within the bitmap.
+ * \param dy        Top coordinate of the area within the bitmap.
+ * \param src       The source surface, starting at its x and y coordinates.
+ * \param width     The width in pixels of the rectangular region.
+ * \param height    The height in pixels of the rectangular region.
+ * \param mode      GGL_CONV_COPY, GGL_CONV_TRANSP or GGL_CONV_XOR, optionally
+ *                  combined with GGL_CONV_DITHER.
+ *
+ * \sa ggl_expandblt
+ */
+void ggl_reduceblt(unsigned int *dest,int destbpp,int destwidth,int dx,int dy,gglsurface *src,int width,int height,int mode);
+
 // predefined filters and operators
 
 // filters (unary operators)
@@ -776,6 +1569,25 @@ void ggl_aline(gglsurface *srf,int x1,int y1,int x2,int y2);    // ANTIALIASED L
  */
 void ggl_endaline();
 
+/*!
+ * \brief Draw an antialiased polyline.
+ *
+ * Draws a 1-pixel wide antialiased line through all the given vertices,
+ * using Wu's algorithm with 16 levels of coverage, blending the given
+ * color over the existing pixels. The blending table is computed once per
+ * call and shared by all segments, and shared vertices are drawn only
+ * once. Unlike ggl_aline, no initialization is needed and the function is
+ * reentrant. There's no clipping: all vertices must lie within the surface.
+ *
+ * \param srf     Surface to draw onto.
+ * \param pts     Array of vertex coordinates x0,y0,x1,y1,...
+ * \param npoints Number of vertices (2*npoints integers in pts).
+ * \param color   Color of the line, between 0 and 15. 15=black.
+ *
+ * \sa ggl_aline
+ */
+void ggl_apolyline(gglsurface *srf,int *pts,int npoints,int color);
+
 #endif
 
 #ifdef __cplusplus
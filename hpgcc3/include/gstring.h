@@ -45,4 +45,101 @@ public:
 	virtual ~gString();
 };
 
+
+// LINE INDEX
+// THE OFFSETS WHERE LINES START (AFTER A \n, OR A \r NOT FOLLOWED BY \n),
+// SORTED IN CHUNKS OF UP TO LINEINDEX_CHUNK ENTRIES RELATIVE TO A Base OFFSET
+// PER CHUNK. AN EDIT FIXES THE ENTRIES OF ITS OWN CHUNK, THE SHIFT OF ALL THE
+// CHUNKS AFTER IT IS KEPT PENDING (PendChunk, PendDelta) AND ONLY APPLIED TO
+// THE CHUNKS BETWEEN IT AND THE NEXT EDIT. LINE NUMBERS OF THE CHUNKS (First)
+// ARE RECOMPUTED ON DEMAND FROM THE FIRST CHUNK THAT CHANGED. FINDING THE
+// LINE OF AN OFFSET IS A BINARY SEARCH, COUNTING LINES IS O(1).
+
+#define LINEINDEX_CHUNK 64		// ENTRIES PER CHUNK, SPLIT IN HALVES WHEN FULL
+#define LINEINDEX_GROUP 16		// ALLOCATE GROUPS OF 16 CHUNKS
+
+// CHARACTER AT Offset, OR -1 OUTSIDE THE TEXT
+typedef int (*gLineSource)(void *Context,int Offset);
+
+struct gLineChunk {
+	int Base;		// ABSOLUTE OFFSET = Base + Start[k] (+ PendDelta)
+	int First;		// LINE STARTING AT Start[0]
+	int Count;
+	int Start[LINEINDEX_CHUNK];
+};
+
+class gLineIndex {
+public:
+	gLineChunk *Chunks;
+	int NumChunks,MaxChunks;
+	int NumStarts;			// NUMBER OF LINES - 1
+	int Length;				// OF THE TEXT
+	int PendChunk,PendDelta;	// CHUNKS FROM PendChunk ON STILL LACK PendDelta
+	int FirstValid;			// First IS VALID UP TO THIS CHUNK
+	BOOL Valid;				// FALSE = NOT BUILT OR OUT OF MEMORY
+	gLineSource Source;
+	void *Context;
+
+	BOOL Build(int length);				// INDEX THE WHOLE TEXT
+	void Clear();
+	void Inserted(int offset,int bytes);	// CALL AFTER EVERY CHANGE TO THE TEXT
+	void Deleted(int offset,int bytes);
+	void Changed(int offset,int bytes);	// OVERWRITTEN, SAME LENGTH
+
+	int NumLines() { return NumStarts+1; }
+	int LineOf(int offset);			// LINE NUMBER OF offset, FROM 0
+	int LineStart(int line);		// OFFSET OF THE START OF line, -1 IF NONE
+	int StartOf(int offset);		// START OF THE LINE OF offset
+	int NextStart(int offset);		// START OF THE NEXT LINE, -1 IF NONE
+	int PrevStart(int offset);		// START OF THE PREVIOUS LINE, -1 IF NONE
+
+	// INTERNAL
+	int Abs(int chunk,int k) { return Chunks[chunk].Base+Chunks[chunk].Start[k]+((chunk>=PendChunk)? PendDelta:0); }
+	int Find(int offset,int *k);	// LAST ENTRY <= offset, -1 IF NONE
+	void MovePending(int chunk);
+	void FixFirst(int chunk);
+	BOOL Add(int offset);
+	void Remove(int chunk,int k);
+	void Shift(int offset,int delta);
+	BOOL IsStart(int offset);
+	void Recheck(int offset);
+
+	gLineIndex(gLineSource src,void *ctx);
+	~gLineIndex();
+};
+
+// gString WITH A LINE INDEX, KEPT UP TO DATE BY ITS OWN EDITING MEMBERS.
+// THE LINE MEMBERS FALL BACK TO THE gString ONES WHEN THE INDEX COULDN'T BE
+// ALLOCATED. CHANGING THE TEXT THROUGH A gString& BYPASSES THE INDEX, CALL
+// Reindex() AFTER THAT.
+
+class gIndexedString : public gString
+{
+	virtual void vTable();
+public:
+	gLineIndex Lines;
+
+	using MemBlock::MemMove;
+	BOOL Append(int bytes,char *Data=NULL);
+	void Shrink(int bytes);
+	BOOL Insert(int offset,int bytes,char *Data=NULL);
+	void Delete(int offset,int bytes);
+	void Delete(int offset);
+	void InsertChar(int offset,char a);
+	void MemMove(int destoffset,int srcoffset,int bytes);
+	void MemMove(int destoffset,MemBlock &src,int srcoffset,int bytes);
+	void MemMove(int destoffset,char *src,int bytes);
+
+	int PrevLine(int Offset);
+	int NextLine(int Offset);
+	int StartOfLine(int Offset);
+	int NumLines();
+	int LineOf(int Offset);
+	int LineStart(int Line);
+	BOOL Reindex();
+
+	gIndexedString();
+	virtual ~gIndexedString();
+};
+
 #endif /*GSTRING_H_*/
@@ -342,6 +342,31 @@ struct gUpdate {
 };
 
 
+// DAMAGE REGIONS
+// A SHORT LIST OF DISJOINT RECTANGLES (INCLUSIVE COORDINATES, AS gUpdate).
+// A NEW RECTANGLE IS MERGED WITH THE ONES IT CONTAINS OR LIES CLOSE TO, AND
+// CUT AROUND THE OTHERS IT OVERLAPS. WHEN THE LIST IS FULL, THE TWO
+// RECTANGLES WITH THE SMALLEST BOUNDING BOX ARE MERGED.
+
+#define GREGION_MAXRECTS 8
+
+class gRegion {
+public:
+	gUpdate Rects[GREGION_MAXRECTS];
+	int NumRects;
+
+	void Clear() { NumRects=0; }
+	BOOL IsEmpty() { return !NumRects; }
+	void Add(int x1,int y1,int x2,int y2);
+	void Add(gUpdate *u) { Add(u->clipx,u->clipy,u->clipx2,u->clipy2); }
+	void Discard(gUpdate *u);			// DROP THE RECTANGLES INSIDE u
+	BOOL Bounds(gUpdate *u);			// BOUNDING BOX, FALSE IF EMPTY
+	BOOL Intersects(gUpdate *u);
+
+	gRegion() { NumRects=0; }
+};
+
+
 struct gEvent {
 	unsigned int Type;	// MESSAGE
 	unsigned int Arg;	// OPTIONAL ARGUMENT
@@ -458,6 +483,51 @@ public:
 };
 
 
+// GLYPH CACHE
+// EACH GLYPH OF A FONT IS EXPANDED ONCE, ON FIRST USE, INTO A GRAY16 MASK
+// (ONE NIBBLE PER PIXEL, 0xF=INK) WITH EVERY ROW PADDED TO WHOLE WORDS.
+// TEXT IS THEN DRAWN WITH MASKED WORD STORES, SHIFTED TO THE DESTINATION
+// NIBBLE. THE COLOR IS APPLIED AT DRAW TIME, SO ONE CACHE SERVES ALL COLORS.
+// CACHES ARE SHARED BY ALL gFont OBJECTS THAT USE THE SAME gFontData.
+
+#define GLYPHCACHE_GROUP 64	// GROW THE SCRATCH STRIP IN GROUPS OF 64 WORDS
+
+class gGlyphCache {
+public:
+	gFontData *FontData;
+	gFont Font;					// PRIVATE COPY, THE CACHE MAY OUTLIVE THE CALLER'S gFont
+	int Height;
+	int MaxWidth;
+	unsigned char Width[256];
+	unsigned int *Glyph[256];	// EXPANDED MASKS, NULL UNTIL FIRST USE (OR EMPTY)
+	unsigned int Loaded[8];		// ONE BIT PER CHARACTER
+	unsigned int *Strip;		// SCRATCH BUFFER TO COMPOSE OPAQUE TEXT FOR gControl
+	int StripSize;				// IN WORDS
+	gGlyphCache *Next;
+
+	BOOL Load(int c);
+	void Flush();
+	int TextWidth(const char *Text);
+	int CharWidth(char c) { return Width[(unsigned char)c]; }
+	int TextHeight() { return Height; }
+
+	// SURFACE COORDINATES, CLIPPED TO clip (INCLUSIVE). NULL = WHOLE SURFACE WIDTH
+	void DrawText(gglsurface *surf,gUpdate *clip,int x,int y,const char *Text,int color);
+	void DrawTextBk(gglsurface *surf,gUpdate *clip,int x,int y,const char *Text,int color,int BkColor);
+
+	// CLIENT COORDINATES OF A CONTROL, CLIPPED TO ITS CLIPPING AREA. OPAQUE
+	// TEXT IS COMPOSED IN Strip AND DRAWN AS AN ICON
+	void DrawText(gControl *ctl,int x,int y,const char *Text,int color);
+	void DrawTextBk(gControl *ctl,int x,int y,const char *Text,int color,int BkColor);
+
+	static gGlyphCache *Get(gFont *f);	// SHARED CACHE FOR A FONT, CREATED ON FIRST USE
+	static void FlushAll();				// RELEASE ALL GLYPHS OF ALL SHARED CACHES
+
+	gGlyphCache(gFont *f);
+	~gGlyphCache();
+};
+
+
 
 // GENERIC GUI CONTROL
 class gControl {
@@ -559,6 +629,59 @@ public:
 };
 
 
+// BACKING STORE
+// A CONTROL THAT OPTS IN IS RENDERED ONCE INTO A PRIVATE SURFACE OF ITS OWN
+// SIZE, AND EVERY Update AFTER THAT IS A CLIPPED BLIT FROM IT. TO RENDER,
+// THE drawsurf OF THE CONTROL IS POINTED AT THE STORE AND ITS OWN Update IS
+// CALLED FOR THE WHOLE AREA, OVER A COPY OF WHAT IS UNDER THE CONTROL, SO
+// CONTROLS THAT DON'T PAINT THEIR BACKGROUND STILL WORK. THAT COPY IS TAKEN
+// FROM AN UPDATE OF THE WHOLE CONTROL AND CHECKED AGAINST THE SCREEN ON
+// EVERY UPDATE. THE STORE IS RENDERED AGAIN AFTER THE CONTROL INVALIDATES
+// ITSELF (ITS CONTENT CHANGED), CHANGES SIZE, OR THE PARENT DREW SOMETHING
+// DIFFERENT UNDER IT. CHILDREN DRAW ON THEIR OWN SURFACES, SO A CONTROL
+// WITH CHILDREN IS ALWAYS DRAWN DIRECTLY.
+
+class gBackingStore {
+public:
+	gglsurface Surface;		// addr=NULL UNTIL THE FIRST RENDER
+	gglsurface Back;		// BACKGROUND UNDER THE CONTROL, SAME SIZE
+	int Width,Height;		// SIZE OF THE CONTROL WHEN RENDERED
+	BOOL Valid;
+	BOOL BackValid;			// Back HOLDS THE WHOLE CONTROL AREA
+	BOOL Rendering;
+
+	void Invalidate() { Valid=FALSE; }
+	void Free();
+	// CALL FROM THE Update OF THE CONTROL, FALSE = DRAW DIRECTLY
+	BOOL Update(gControl *ctl,gUpdate *u);
+
+	gBackingStore();
+	~gBackingStore();
+};
+
+// CACHED VERSION OF ANY CONTROL CLASS, FOR EXAMPLE gCached<gStaticText>,
+// CONSTRUCTED WITH THE SAME ARGUMENTS
+template <class T> class gCached : public T {
+public:
+	gBackingStore Store;
+
+	virtual void Update(gUpdate *u) { if(!Store.Update(this,u)) T::Update(u); }
+	virtual void Invalidate(gUpdate *u,gControl *Sender=NULL) { Store.Invalidate(); T::Invalidate(u,Sender); }
+	virtual void Invalidate(gControl *Sender=NULL) { Store.Invalidate(); T::Invalidate(Sender); }
+	virtual BOOL Resize(int width,int height) { Store.Invalidate(); return T::Resize(width,height); }
+
+	gCached(gControl& Parent) : T(Parent) {}
+	template <class A> gCached(gControl& Parent,A a) : T(Parent,a) {}
+	template <class A,class B> gCached(gControl& Parent,A a,B b) : T(Parent,a,b) {}
+	template <class A,class B,class C> gCached(gControl& Parent,A a,B b,C c) : T(Parent,a,b,c) {}
+	template <class A,class B,class C,class D> gCached(gControl& Parent,A a,B b,C c,D d) : T(Parent,a,b,c,d) {}
+	template <class A,class B,class C,class D,class E> gCached(gControl& Parent,A a,B b,C c,D d,E e) : T(Parent,a,b,c,d,e) {}
+	template <class A,class B,class C,class D,class E,class F> gCached(gControl& Parent,A a,B b,C c,D d,E e,F f) : T(Parent,a,b,c,d,e,f) {}
+	template <class A,class B,class C,class D,class E,class F,class G> gCached(gControl& Parent,A a,B b,C c,D d,E e,F f,G g) : T(Parent,a,b,c,d,e,f,g) {}
+	template <class A,class B,class C,class D,class E,class F,class G,class H> gCached(gControl& Parent,A a,B b,C c,D d,E e,F f,G g,H h) : T(Parent,a,b,c,d,e,f,g,h) {}
+};
+
+
 // INTERNAL DATA STRUCTURE FOR OPEN LOOPS
 struct gLoopData {
 	int BackupFlags;
@@ -602,6 +725,26 @@ public:
 };
 
 
+// APPLICATION WITH A MULTI-RECTANGLE INVALID AREA
+// INVALIDATED RECTANGLES ARE ALSO RECORDED IN Damage. WHEN THE EVENT LOOP
+// UPDATES THE BOUNDING BOX OF THE INVALID AREA, ONLY THE RECTANGLES OF
+// Damage ARE REDRAWN, ONE Update EACH, SO CONTROLS OUTSIDE ALL OF THEM ARE
+// NOT DRAWN AT ALL. ANY OTHER Update IS DONE IN FULL.
+
+class gRegionApplication : public gApplication {
+	virtual void vTable();
+public:
+	gRegion Damage;
+
+	using gApplication::Invalidate;
+	virtual void Invalidate(gUpdate *u,gControl *Sender=NULL);
+	virtual void Update(gUpdate *u);
+	void Update() { gApplication::Update(); }
+
+	gRegionApplication() {}
+};
+
+
 enum gFormStyles {
 	
 	S_TOPCAPTION = 1,
@@ -674,6 +817,7 @@ public:
 	virtual void DrawMenuLabel(gControl *P,int x,int y,int item);
 	virtual void Update(gUpdate *u);
 	virtual BOOL DefaultEvent(gEvent *);
+	using gControl::Invalidate;
 	virtual void Invalidate(gControl *Sender=NULL);
 	
 	void ClearItems();
@@ -876,6 +1020,132 @@ public:
 	virtual ~gEditBox();
 };
 
+
+// TEXT STORAGE BACKENDS
+// A gTextBuffer HOLDS THE TEXT OF A gTextEdit, WITH ITS LINE INDEX AND AN
+// UNDO LOG. gGapText KEEPS THE TEXT IN ONE BLOCK WITH A GAP AT THE LAST
+// EDIT, SO TYPING AT THE CURSOR IS A BYTE STORE AND THE GAP ONLY MOVES WHEN
+// THE CURSOR DOES. gStringText KEEPS IT IN A gIndexedString (MemBlock
+// FRAGMENTS), WHICH NEEDS NO LARGE BLOCK OF FREE MEMORY.
+// UNDO RECORDS ARE AN OFFSET AND A LENGTH, PLUS THE BYTES FOR DELETIONS.
+// CONSECUTIVE TYPING OR DELETING IN THE SAME PLACE EXTENDS THE LAST RECORD.
+// THE OLDEST RECORDS ARE DROPPED TO MAKE ROOM.
+
+enum gTextBackends {
+	GTEXT_GAP=0,
+	GTEXT_STRING
+};
+
+#define GAPTEXT_GROUP 256		// GROW THE GAP BUFFER BY 1/4 OF ITS SIZE, NO LESS THAN 256 BYTES
+#define GTEXT_UNDOSTEPS 32		// UNDO RECORDS KEPT
+#define GTEXT_UNDOBYTES 1024	// DELETED TEXT KEPT FOR UNDO
+
+struct gUndoRecord {
+	int Offset;
+	int Length;			// >0 INSERTED, <0 DELETED
+	int TextPos;		// DELETED TEXT IN UndoText
+};
+
+class gTextBuffer {
+public:
+	gUndoRecord UndoLog[GTEXT_UNDOSTEPS];
+	int NumUndo;
+	char UndoText[GTEXT_UNDOBYTES];
+	int UndoUsed;
+
+	virtual int Length()=0;
+	virtual int CharAt(int Offset)=0;					// -1 OUTSIDE THE TEXT
+	virtual const char *GetRange(int Start,int *Bytes)=0;	// POINTER TO THE TEXT, *Bytes CONTIGUOUS BYTES FROM Start
+	virtual gLineIndex *GetLines()=0;
+	virtual BOOL DoInsert(int Offset,const char *Data,int Bytes)=0;	// NO UNDO RECORD
+	virtual void DoDelete(int Offset,int Bytes)=0;
+
+	BOOL Insert(int Offset,const char *Data,int Bytes);
+	void Delete(int Offset,int Bytes);
+	int GetText(char *Dest,int Start,int End);	// COPY, RETURN BYTES
+	int Undo();				// RETURN THE OFFSET OF THE CHANGE UNDONE, -1 IF NONE
+	void ClearUndo();
+
+	gTextBuffer();
+	virtual ~gTextBuffer();
+};
+
+class gGapText : public gTextBuffer {
+public:
+	char *Buffer;
+	int Size;
+	int GapStart,GapEnd;	// THE TEXT IS [0,GapStart) AND [GapEnd,Size)
+	gLineIndex Lines;
+
+	virtual int Length() { return Size-GapEnd+GapStart; }
+	virtual int CharAt(int Offset);
+	virtual const char *GetRange(int Start,int *Bytes);
+	virtual gLineIndex *GetLines() { return &Lines; }
+	virtual BOOL DoInsert(int Offset,const char *Data,int Bytes);
+	virtual void DoDelete(int Offset,int Bytes);
+
+	void MoveGap(int Offset);
+	using gTextBuffer::GetText;
+	const char *GetText(int Start,int End);	// CONTIGUOUS, THE GAP IS MOVED OUT OF THE RANGE
+
+	gGapText();
+	virtual ~gGapText();
+};
+
+class gStringText : public gTextBuffer {
+public:
+	gIndexedString Str;
+
+	virtual int Length() { return Str.TotalUsed; }
+	virtual int CharAt(int Offset);
+	virtual const char *GetRange(int Start,int *Bytes);
+	virtual gLineIndex *GetLines() { return &Str.Lines; }
+	virtual BOOL DoInsert(int Offset,const char *Data,int Bytes);
+	virtual void DoDelete(int Offset,int Bytes);
+};
+
+// MULTILINE EDITOR OVER A gTextBuffer, THE BACKEND IS CHOSEN PER BOX.
+// KEYS: ARROWS, BACKSPACE, ENTER, DIGITS, + - * / . SPACE, ALPHA LETTERS
+// (LEFT SHIFT FOR LOWERCASE), LEFT SHIFT+BACKSPACE UNDOES.
+
+#define TEXTEDIT_LINEMAX 64		// CHARACTERS DRAWN PER LINE
+
+class gTextEdit : public gControl {
+	virtual void vTable();
+
+public:
+	gTextBuffer *Text;
+	int CursorPos;
+	int ViewLine;
+	int Targetx;			// CURSOR x KEPT WHILE MOVING UP/DOWN, -1 = NONE
+	gFont Font;
+	int Color,BkColor;
+	BOOL ReadOnly;
+
+	virtual BOOL AcceptFocus() { return TRUE; }
+	virtual void Update(gUpdate *u);
+	virtual BOOL DefaultEvent(gEvent *e);
+
+	void SetText(const char *text);
+	int GetText(char *data,int maxbytes);
+	int CursorLine();
+	int DispLines();
+	void MoveCursor(int Offset);
+	void CursorUp();
+	void CursorDown();
+	void CursorLeft();
+	void CursorRight();
+	void InsertChar(int c);
+	void InsertText(const char *text,int bytes);
+	void BackSpace();
+	void Delete();
+	void Undo();
+	void EnsureVisible();
+
+	gTextEdit(gControl& Parent,int x,int y,int width,int height,gFont *f,int Backend=GTEXT_GAP);
+	virtual ~gTextEdit();
+};
+
 // LIST BOXES / TREES
 
 #define ITEM_GROUP 16	// ALLOCATE GROUPS OF 16 ITEMS, NO LESS TO AVOID HEAP TRASHING
@@ -968,6 +1238,118 @@ public:
 	~gListBox();
 };
 
+
+// VIRTUAL LIST BOXES / TREES
+// THE ROWS OF A gVirtualListBox ARE NOT STORED IN THE CONTROL. THEY ARE
+// FETCHED FROM A gListProvider WHEN DRAWN, AND THE LAST GVLIST_CACHESIZE ROWS
+// FETCHED ARE KEPT IN A SMALL LRU CACHE, SO MEMORY DOESN'T DEPEND ON THE
+// NUMBER OF ROWS. THE PROVIDER NUMBERS ONLY THE VISIBLE ROWS, 0 TO Count()-1:
+// EXPANDING OR COLLAPSING A NODE IS DONE BY THE PROVIDER, WHICH INSERTS OR
+// REMOVES THE ROWS OF ITS CHILDREN AFTER IT, AND LS_HIDDEN IS NOT USED.
+// THE ITEM LIST OF THE BASE gListBox STAYS EMPTY, USE THE MEMBERS DECLARED
+// HERE TO WORK WITH THE ROWS.
+
+#define GVLIST_CACHESIZE 24		// ROWS KEPT, AT LEAST ONE SCREEN
+#define GVLIST_TEXTSIZE 48		// LONGER TEXTS ARE TRUNCATED
+#define GVLIST_SCAN (-2)		// ParentItem NOT KNOWN, SCAN BACK FOR IT
+
+class gListProvider {
+public:
+	virtual int Count()=0;
+	// FILL item AND COPY THE TEXT (size BYTES WITH THE TERMINATOR), item->Text IS IGNORED
+	virtual BOOL GetItem(int Index,gListItem *item,char *text,int size)=0;
+	// TREE OPERATIONS, RETURN TRUE IF THE ROW CHANGED OR ROWS WERE ADDED/REMOVED
+	virtual BOOL Expand(int Index) { return FALSE; }
+	virtual BOOL Collapse(int Index) { return FALSE; }
+	virtual BOOL SetCheck(int Index,BOOL value) { return FALSE; }
+	virtual int ParentItem(int Index) { return GVLIST_SCAN; }
+	virtual ~gListProvider() {}
+};
+
+struct gVListRow {
+	int Index;				// -1 = FREE
+	unsigned int Stamp;		// LAST USE
+	gListItem Item;			// Item.Text POINTS TO Text
+	char Text[GVLIST_TEXTSIZE];
+};
+
+class gVirtualListBox : public gListBox {
+	virtual void vTable();
+
+public:
+	gListProvider *Provider;
+	int NumRows;			// Provider->Count() AT THE LAST CHANGE
+	int VStyle;				// S_VSCROLLBAR, DRAWN INSIDE THE CLIENT AREA
+	gVListRow Cache[GVLIST_CACHESIZE];
+	unsigned int CacheStamp;
+
+	void SetProvider(gListProvider *p);
+	void ListChanged();						// ROWS REPLACED, FLUSH THE CACHE
+	void RowsChanged(int Index,int delta);	// ROW Index CHANGED, delta ROWS ADDED(>0)/REMOVED(<0) AFTER IT
+	gListItem *GetItem(int Index);			// VALID UNTIL GVLIST_CACHESIZE OTHER ROWS ARE FETCHED
+
+	void SetSelection(int Index);
+	int NextVisibleItem(int Index) { return (Index>=-1 && Index+1<NumRows)? Index+1:-1; }
+	int PrevVisibleItem(int Index) { return (Index>0 && Index<=NumRows)? Index-1:-1; }
+	int ParentItem(int Index);
+	void Expand(int Index);
+	void Collapse(int Index);
+	void SetCheck(int Index,BOOL value);
+	BOOL MoveSelectionUp(int nlines);
+	BOOL MoveSelectionDown(int nlines);
+	void EnsureVisible(int Index);
+
+	virtual int CalcItemWidth(int Index);
+	virtual BOOL DrawItem(int Index,int y);
+	virtual void Update(gUpdate *u);
+	virtual BOOL DefaultEvent(gEvent *e);
+
+	gVirtualListBox(gControl& Parent,int x,int y,int w,int h,int Style,gFont *Font,gListProvider *p=NULL);
+};
+
+
+// DISPLAY LISTS
+
+// RECORD DRAWING COMMANDS (gGraphicCommands) INTO A COMPACT BUFFER AND
+// REPLAY THEM LATER ON A SURFACE. COORDINATES ARE IN SURFACE PIXELS, AND
+// PRIMITIVES ARE CLIPPED TO THE CURRENT CLIP REGION WHEN RECORDED.
+// ON EXECUTE, PRIMITIVES ARE CLIPPED ONCE TO THE DAMAGED AREA, THOSE
+// COMPLETELY COVERED BY ONE OF THE LARGEST LATER ONES ARE DROPPED,
+// CONSECUTIVE HLINES/RECTS OF THE SAME COLOR ARE MERGED, AND THE RESULT IS
+// BUCKETED BY SCANLINE BAND AND DRAWN ONE BAND AT A TIME.
+// THE LIST IS STANDALONE: gControl DRAWS DIRECTLY, A CONTROL THAT WANTS
+// TO BATCH ITS DRAWING RECORDS IT AND CALLS Execute FROM ITS Update.
+
+#define DLIST_GROUP 64		// GROW THE BUFFER IN GROUPS OF 64 WORDS
+#define DLIST_BANDHEIGHT 16	// HEIGHT OF A SCANLINE BAND DURING EXECUTE
+#define DLIST_COVERS 8		// LATER PRIMITIVES TESTED FOR OCCLUSION
+
+class gDisplayList {
+public:
+	unsigned int *Buffer;	// COMMAND STREAM, TERMINATED WITH GCMD_END
+	int Used,Size;			// IN WORDS
+	int NumCmds;
+	int clipx,clipy,clipx2,clipy2;	// CURRENT CLIPPING AREA
+
+	void SetClip(int x1,int y1,int x2,int y2);
+	void ClearClip();
+	BOOL HLine(int y,int x1,int x2,int pattern);
+	BOOL VLine(int x,int y1,int y2,int pattern);
+	BOOL Rect(int x1,int y1,int x2,int y2,int pattern);
+	BOOL DrawIcon(int x,int y,unsigned int *IconData,int width,int height);
+	BOOL DrawIconPartial(int x,int y,unsigned int *IconData,int iconwidth,int iconx,int icony,int width,int height);
+
+	void Clear();						// REMOVE ALL COMMANDS
+	// DRAW ALL COMMANDS, ONLY INSIDE clip IF GIVEN, KEEP THE LIST
+	void Execute(gglsurface *surf,gUpdate *clip=NULL);
+
+	BOOL Grow(int nwords);
+
+	gDisplayList();
+	gDisplayList(int initialwords);
+	~gDisplayList();
+};
+
 // MESSAGE BOXES
 
 enum gMsgBoxStyle {
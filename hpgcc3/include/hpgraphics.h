@@ -772,6 +772,54 @@ void hpg_draw_line_on(hpg_t *g, int x1, int y1, int x2, int y2);
  */
 void hpg_draw_line(int x1, int y1, int x2, int y2);
 
+/*!
+ * \brief Line flag: the points form one connected polyline.
+ *
+ * Without it, every two points form an independent segment.
+ */
+#define HPG_LINES_STRIP 1
+
+/*!
+ * \brief Line flag: the points form a closed polyline.
+ *
+ * Like ::HPG_LINES_STRIP, with one more segment from the last point back to
+ * the first.
+ */
+#define HPG_LINES_CLOSED 2
+
+/*!
+ * \brief Draws many lines onto a buffer.
+ *
+ * Draws independent segments or a polyline in one call.  Segments are
+ * clipped to the buffer before they are drawn, so segments far outside cost
+ * almost nothing, and the horizontal and vertical runs of pixels that make
+ * up the lines are merged and filled together.  A function plot with
+ * thousands of samples is drawn with far fewer operations than with
+ * ::hpg_draw_line_on.
+ *
+ * The points shared by the segments of a polyline are drawn only once, so
+ * polylines drawn in ::HPG_MODE_XOR are complete and erased by drawing them
+ * again.
+ *
+ * \param g     The graphics context to which this function applies
+ * \param pts   The coordinates of the points, as n pairs x, y
+ * \param n     The number of points
+ * \param flags 0 for independent segments (n/2 of them), or
+ *              ::HPG_LINES_STRIP or ::HPG_LINES_CLOSED for a polyline
+ */
+void hpg_draw_lines_on(hpg_t *g, int *pts, int n, int flags);
+
+/*!
+ * \brief Draws many lines onto the screen.
+ *
+ * \param pts   The coordinates of the points, as n pairs x, y
+ * \param n     The number of points
+ * \param flags 0 for independent segments, or ::HPG_LINES_STRIP or
+ *              ::HPG_LINES_CLOSED for a polyline
+ * \sa hpg_draw_lines_on
+ */
+void hpg_draw_lines(int *pts, int n, int flags);
+
 /*!
  * \brief Draws a rectangle onto a buffer.
  *
@@ -922,6 +970,33 @@ void hpg_fill_polygon_on(hpg_t *g, int vx[], int vy[], int len);
  */
 void hpg_fill_polygon(int vx[], int vy[], int len);
 
+/*!
+ * \brief Fills many polygons on a buffer in one pass.
+ *
+ * Fills the polygons with a single scanline pass over a shared edge table,
+ * which is much faster than filling them one by one when there are many
+ * polygons. The vertices of all polygons are stored one polygon after the
+ * other in \c vx and \c vy, and \c lens gives the number of vertices of
+ * each polygon. Each polygon is filled with the even-odd rule.
+ *
+ * Pixels on the right and bottom borders of a polygon are not filled, so
+ * polygons that share an edge never overlap, which makes this function
+ * suitable for maps of adjacent regions, also in ::HPG_MODE_XOR.
+ * Rows of identical spans are filled as a single rectangle, so relative
+ * patterns are aligned to the top-left corner of each of these rectangles
+ * rather than to the polygon; use fixed patterns for a seamless fill.
+ *
+ * For a single polygon, pass the address of its vertex count and a
+ * \c count of 1.
+ *
+ * \param g The graphics context to which this function applies
+ * \param vx The x coordinates of the vertices of all polygons
+ * \param vy The y coordinates of the vertices of all polygons
+ * \param lens The number of vertices of each polygon
+ * \param count The number of polygons
+ */
+void hpg_fill_polygons_on(hpg_t *g, int vx[], int vy[], int lens[], int count);
+
 /*!
  * \brief Retrieves the minifont.
  *
@@ -1029,6 +1104,66 @@ void hpg_draw_text_on(hpg_t *g, char *s, int x, int y);
  */
 void hpg_draw_text(char *s, int x, int y);
 
+/*!
+ * \brief Draws a text string onto a buffer, 8 pixels at a time.
+ *
+ * Same as ::hpg_draw_text_on.  The glyphs of each font are rendered once by
+ * the library and cached, then every line of text is composed into strips
+ * 8 pixels wide and each strip is drawn with a single ::hpg_fill_rect_on, so
+ * the cost no longer grows with the number of pixels of each glyph.  Lines
+ * and strips that fall outside the buffer are skipped as a whole.  The
+ * current color, mode and clipping region apply as usual, and the current
+ * fill pattern is preserved.
+ *
+ * A font that is freed while cached must be removed from the cache with
+ * ::hpg_flush_text_cache.
+ *
+ * \param g The graphics context to which this function applies
+ * \param s A null-terminated string, containing the text to draw
+ * \param x The x coordinate of the left side of the text block
+ * \param y The y coordinate of the top edge of the text block
+ */
+void hpg_draw_text_fast_on(hpg_t *g, char *s, int x, int y);
+
+/*!
+ * \brief Measures a text string.
+ *
+ * Returns the size of the block drawn by ::hpg_draw_text_on for the string,
+ * including its newline characters, without drawing it.
+ *
+ * \param font   The font used to draw the text
+ * \param s      A null-terminated string
+ * \param width  Receives the width in pixels of the longest line, or NULL
+ * \param height Receives the height in pixels of all the lines, or NULL
+ */
+void hpg_text_extent(hpg_font_t *font, char *s, int *width, int *height);
+
+/*!
+ * \brief Releases the glyphs cached by ::hpg_draw_text_fast_on.
+ *
+ * Must be called before a font allocated with ::hpg_alloc_font is freed,
+ * or when the font data is modified.
+ *
+ * \param font The font to release, or NULL for all fonts
+ */
+void hpg_flush_text_cache(hpg_font_t *font);
+
+/*!
+ * \brief Retrieves the bitmap of one glyph of a font.
+ *
+ * The glyph is taken from the cache of ::hpg_draw_text_fast_on, rendering
+ * it first if needed.  It is one byte per row, from top to bottom, and
+ * the least significant bit of each byte is the left-most pixel.  Fonts
+ * wider than 8 pixels are cut to 8.  The bitmap is valid until the cache of
+ * the font is flushed.
+ *
+ * \param font The font
+ * \param c    The character
+ * \return The rows of the glyph, ::hpg_font_get_height bytes, or NULL if
+ *         out of memory
+ */
+const unsigned char *hpg_font_get_glyph(hpg_font_t *font, int c);
+
 /*!
  * \brief Retrieves the current color.
  *
@@ -1308,6 +1443,523 @@ hpg_t *hpg_load_xpm_gray4(char *xpm[]);
  */
 hpg_t *hpg_load_xpm_gray16(char *xpm[]);
 
+/*!
+ * \brief An image compiled into the program at build time.
+ *
+ * The \c hpgimgc tool converts an XPM or PGM file into a C source file that
+ * defines a constant ::hpg_static_t.  The pixels are already packed, so
+ * nothing is parsed at run time and the bits stay in the program image.
+ *
+ * Pixels are stored row after row without padding, pixel (x,y) at offset
+ * y*width+x, using \c bpp bits per pixel starting at the least significant
+ * bits of each word.  Pixel value 0 is white and the largest value is black,
+ * as in the off-screen images of the same depth.  A 4 bpp image has the
+ * layout of a GGL surface, so its bits can be drawn with the GGL routines
+ * directly, without any copy.
+ */
+typedef struct {
+    //! Width of the image in pixels
+    int width;
+    //! Height of the image in pixels
+    int height;
+    //! Bits per pixel: 1 (mono), 2 (4-color gray) or 4 (16-color gray)
+    int bpp;
+    //! Packed pixels, ((width*height*bpp+31)/32) words
+    const unsigned int *bits;
+} hpg_static_t;
+
+/*!
+ * \brief Creates an off-screen image from an image compiled with hpgimgc.
+ *
+ * A new image is allocated with the depth of the static image (mono for
+ * 1 bpp, 4-color gray for 2 bpp and 16-color gray for 4 bpp) and the static
+ * pixels are painted into it, so the result is a copy, not a wrapper around
+ * \c bits.  Nothing is parsed, but each horizontal run of one non-white
+ * value costs one ::hpg_set_color and one ::hpg_fill_rect_on call, which is
+ * close to one call per pixel for dithered art.
+ *
+ * A 4 bpp image can be drawn without any copy by using \c bits as the
+ * \c addr of a ::gglsurface of the same width, with x and y set to 0.
+ *
+ * ::hpg_free_image should be called when the application is no longer
+ * using the image.
+ *
+ * \param img The static image
+ * \return Pointer to an ::hpg_t representing the image, or NULL if out of
+ *         memory or the depth is not supported.
+ */
+hpg_t *hpg_image_from_static(const hpg_static_t *img);
+
+/*!
+ * \brief Flag for the converting blits: white source pixels are transparent.
+ */
+#define HPG_BLIT_TRANSPARENT 1
+
+/*!
+ * \brief Flag for the converting blits: ordered dither to black and white.
+ *
+ * Use when drawing a gray image onto a monochrome destination, instead of
+ * letting every gray round to black or white.
+ */
+#define HPG_BLIT_DITHER_MONO 2
+
+/*!
+ * \brief Flag for the converting blits: ordered dither to 4 grays.
+ *
+ * Use when drawing a 16-gray image onto a 4-gray destination.
+ */
+#define HPG_BLIT_DITHER_GRAY4 4
+
+/*!
+ * \brief Copies a region of a static image to a buffer of any depth.
+ *
+ * Behaves like ::hpg_blit with an ::hpg_static_t as the source.  Each
+ * source row is split into runs of equal pixels and every run is drawn as a
+ * rectangle of the current mode and pattern of the destination, and rows
+ * identical to the previous one only extend those rectangles.  This makes
+ * mono and 4-gray icons cheap to draw on a 16-gray screen.  The clipping
+ * region of the destination is effective, and its color is preserved.
+ *
+ * \param src   The static image to copy from
+ * \param sx    The left x coordinate of the area to copy on the source
+ * \param sy    The top y coordinate of the area to copy on the source
+ * \param w     The width of the area to copy
+ * \param h     The height of the area to copy
+ * \param dst   The graphics context to copy to
+ * \param dx    The left x coordinate of the area on the destination
+ * \param dy    The top y coordinate of the area on the destination
+ * \param flags Any combination of ::HPG_BLIT_TRANSPARENT and one of
+ *              ::HPG_BLIT_DITHER_MONO or ::HPG_BLIT_DITHER_GRAY4
+ */
+void hpg_blit_static(const hpg_static_t *src, int sx, int sy, int w, int h,
+                     hpg_t *dst, int dx, int dy, int flags);
+
+/*!
+ * \brief Copies a region of one buffer to another of a different depth.
+ *
+ * Same as ::hpg_blit, drawing the destination with runs of one color as
+ * ::hpg_blit_static does, with optional transparency and ordered dithering.
+ * The buffer of an ::hpg_t is not reachable, so the source is read one
+ * pixel at a time with ::hpg_get_pixel.  Use it only for blits between
+ * buffers of different depths, and ::hpg_blit otherwise.  The source and
+ * destination areas must not overlap.
+ *
+ * \param src   The graphics context to copy from
+ * \param sx    The left x coordinate of the area to copy on the source
+ * \param sy    The top y coordinate of the area to copy on the source
+ * \param w     The width of the area to copy
+ * \param h     The height of the area to copy
+ * \param dst   The graphics context to copy to
+ * \param dx    The left x coordinate of the area on the destination
+ * \param dy    The top y coordinate of the area on the destination
+ * \param flags Any combination of ::HPG_BLIT_TRANSPARENT and one of
+ *              ::HPG_BLIT_DITHER_MONO or ::HPG_BLIT_DITHER_GRAY4
+ */
+void hpg_blit_convert(hpg_t *src, int sx, int sy, int w, int h,
+                      hpg_t *dst, int dx, int dy, int flags);
+
+/*!
+ * \brief A set of retained layers composited onto a graphics context.
+ *
+ * Each layer is an off-screen image with a position, a visibility flag and
+ * a place in the stacking order.  Changes to the layers only record the
+ * screen areas they affect, as a short list of dirty rectangles, and
+ * ::hpg_layers_compose redraws just those areas from the layer images.
+ * A screen where few things change per frame is then redrawn in time
+ * proportional to the changed area rather than to the screen size.
+ *
+ * Layer sets are created with ::hpg_alloc_layers and released with
+ * ::hpg_free_layers.
+ */
+typedef struct hpg_layers hpg_layers_t;
+
+/*!
+ * \brief Maximum number of dirty rectangles kept by a layer set.
+ *
+ * When more areas change, the closest rectangles are merged.
+ */
+#define HPG_LAYERS_MAXDIRTY 8
+
+/*!
+ * \brief Layer flag: the layer is shown.
+ */
+#define HPG_LAYER_VISIBLE 1
+
+/*!
+ * \brief Layer flag: white pixels of the layer are transparent.
+ *
+ * Transparent layers are drawn with ::hpg_blit_convert, which is slower than
+ * the ::hpg_blit used for opaque layers.  Opaque layers also hide the
+ * layers below them without drawing them.
+ */
+#define HPG_LAYER_TRANSPARENT 2
+
+/*!
+ * \brief Creates a layer set.
+ *
+ * The whole target is dirty after creation, so the first composition
+ * draws the background and all the layers.
+ *
+ * \param target    The graphics context the layers are composited onto,
+ *                  usually ::hpg_stdscreen
+ * \param maxlayers Maximum number of layers
+ * \param dbuf      Non-zero if the target is double buffered and
+ *                  ::hpg_flip is called after every composition
+ * \return The new layer set, or NULL if out of memory
+ */
+hpg_layers_t *hpg_alloc_layers(hpg_t *target, int maxlayers, int dbuf);
+
+/*!
+ * \brief Releases a layer set.
+ *
+ * The layer images are owned by the caller and are not freed.
+ *
+ * \param l The layer set
+ */
+void hpg_free_layers(hpg_layers_t *l);
+
+/*!
+ * \brief Adds a layer on top of all the others.
+ *
+ * The image, usually allocated with ::hpg_alloc_gray16_image, stays owned by
+ * the caller and must not be freed while it belongs to the set.  After
+ * drawing on it, call ::hpg_layer_invalidate for the changed area.
+ *
+ * \param l     The layer set
+ * \param img   The image of the layer
+ * \param x     The x coordinate of the layer on the target
+ * \param y     The y coordinate of the layer on the target
+ * \param flags Any combination of ::HPG_LAYER_VISIBLE and
+ *              ::HPG_LAYER_TRANSPARENT
+ * \return The identifier of the new layer, or -1 if the set is full
+ */
+int hpg_layer_add(hpg_layers_t *l, hpg_t *img, int x, int y, int flags);
+
+/*!
+ * \brief Removes a layer from a set.
+ *
+ * \param l  The layer set
+ * \param id The layer identifier
+ */
+void hpg_layer_remove(hpg_layers_t *l, int id);
+
+/*!
+ * \brief Moves a layer.
+ *
+ * \param l  The layer set
+ * \param id The layer identifier
+ * \param x  The new x coordinate of the layer on the target
+ * \param y  The new y coordinate of the layer on the target
+ */
+void hpg_layer_move(hpg_layers_t *l, int id, int x, int y);
+
+/*!
+ * \brief Shows or hides a layer.
+ *
+ * \param l       The layer set
+ * \param id      The layer identifier
+ * \param visible Non-zero to show the layer, zero to hide it
+ */
+void hpg_layer_show(hpg_layers_t *l, int id, int visible);
+
+/*!
+ * \brief Changes the stacking order of a layer.
+ *
+ * \param l  The layer set
+ * \param id The layer identifier
+ * \param z  The new position, 0 for the bottom layer, larger values are
+ *           drawn on top of smaller ones
+ */
+void hpg_layer_set_z(hpg_layers_t *l, int id, int z);
+
+/*!
+ * \brief Marks part of a layer as changed.
+ *
+ * Must be called after drawing on the image of a layer.
+ *
+ * \param l  The layer set
+ * \param id The layer identifier
+ * \param x1 The left-most x coordinate of the changed area, in the layer
+ * \param y1 The top-most y coordinate of the changed area, in the layer
+ * \param x2 The right-most x coordinate of the changed area, in the layer
+ * \param y2 The bottom-most y coordinate of the changed area, in the layer
+ */
+void hpg_layer_invalidate(hpg_layers_t *l, int id, int x1, int y1, int x2, int y2);
+
+/*!
+ * \brief Sets the color shown where no layer covers the target.
+ *
+ * \param l     The layer set
+ * \param color The background color, white by default
+ */
+void hpg_layers_set_background(hpg_layers_t *l, unsigned char color);
+
+/*!
+ * \brief Redraws the dirty areas of the target.
+ *
+ * Only the areas changed since the previous call are drawn, plus the ones
+ * changed before that when the set is double buffered.  The color, mode and
+ * pattern of the target are preserved and its clipping region applies.
+ *
+ * \param l The layer set
+ * \return The number of pixels redrawn
+ */
+int hpg_layers_compose(hpg_layers_t *l);
+
+/*!
+ * \brief Maximum number of images tracked by the HPG memory pool.
+ *
+ * Images requested while the table is full of images in use are allocated
+ * normally and freed by ::hpg_pool_free_image without being pooled.
+ */
+#define HPG_POOL_MAXIMAGES 16
+
+/*!
+ * \brief Usage statistics of the HPG memory pool.
+ *
+ * The hit rate of the pool is hits/requests.
+ *
+ * \sa hpg_pool_get_stats
+ */
+typedef struct {
+    //! Image and block requests since the statistics were last cleared
+    int requests;
+    //! Requests served with pooled memory, without calling malloc
+    int hits;
+    //! Released images kept for reuse
+    int idleimages;
+    //! Released blocks kept for reuse
+    int idleblocks;
+    //! Approximate memory held by the idle images and blocks
+    int idlebytes;
+} hpg_pool_stats_t;
+
+/*!
+ * \brief Allocates a monochrome image from the HPG memory pool.
+ *
+ * Images released with ::hpg_pool_free_image are not freed but kept, and
+ * handed out again for the next request with the same depth and size.
+ * Off-screen buffers created and destroyed repeatedly (once per frame, per
+ * dialog, per redraw) then reuse the same memory instead of fragmenting the
+ * heap.  Like a new image, the contents of a pooled image are undefined.
+ *
+ * \param width  The width of the image
+ * \param height The height of the image
+ * \return The new image, or NULL if out of memory
+ * \sa hpg_pool_free_image
+ */
+hpg_t *hpg_pool_alloc_mono_image(int width, int height);
+
+/*!
+ * \brief Allocates a 4-color grayscale image from the HPG memory pool.
+ *
+ * \param width  The width of the image
+ * \param height The height of the image
+ * \return The new image, or NULL if out of memory
+ * \sa hpg_pool_alloc_mono_image
+ */
+hpg_t *hpg_pool_alloc_gray4_image(int width, int height);
+
+/*!
+ * \brief Allocates a 16-color grayscale image from the HPG memory pool.
+ *
+ * \param width  The width of the image
+ * \param height The height of the image
+ * \return The new image, or NULL if out of memory
+ * \sa hpg_pool_alloc_mono_image
+ */
+hpg_t *hpg_pool_alloc_gray16_image(int width, int height);
+
+/*!
+ * \brief Returns an image to the HPG memory pool.
+ *
+ * The image is kept for reuse.  When the table of the pool is full the
+ * oldest idle image is freed.  Images not allocated from the pool are
+ * freed with ::hpg_free_image.
+ *
+ * \param img The image to release, or NULL
+ */
+void hpg_pool_free_image(hpg_t *img);
+
+/*!
+ * \brief Allocates a memory block from the HPG memory pool.
+ *
+ * Blocks are grouped in size classes matched to HPG buffers: patterns,
+ * scanlines, edge tables, a 131x80 screen at 2 bits per pixel (or half of
+ * one at 4) and a full one at 4 bits per pixel.  A released block is kept
+ * on the free list of its class.  Larger blocks are allocated with malloc.
+ * The polygon and blit routines take their temporary buffers from here.
+ *
+ * \param size The size of the block in bytes
+ * \return The block, or NULL if out of memory
+ * \sa hpg_pool_free
+ */
+void *hpg_pool_malloc(int size);
+
+/*!
+ * \brief Returns a block to the HPG memory pool.
+ *
+ * \param ptr A block allocated with ::hpg_pool_malloc, or NULL
+ */
+void hpg_pool_free(void *ptr);
+
+/*!
+ * \brief Frees the idle images and blocks of the HPG memory pool.
+ *
+ * The pool also does this by itself when an allocation fails.
+ */
+void hpg_pool_trim(void);
+
+/*!
+ * \brief Frees all the memory owned by the HPG memory pool.
+ *
+ * Intended for mode changes: the idle images and blocks and the glyph cache
+ * of ::hpg_draw_text_fast_on are released.  Nothing is done while any image
+ * allocated from the pool is still in use, release those first with
+ * ::hpg_pool_free_image.  Blocks in use are not affected.
+ *
+ * \return 0 if the pool was reset, otherwise the number of pool images
+ *         still in use
+ */
+int hpg_pool_reset(void);
+
+/*!
+ * \brief Retrieves the usage statistics of the HPG memory pool.
+ *
+ * \param stats Receives the statistics
+ */
+void hpg_pool_get_stats(hpg_pool_stats_t *stats);
+
+/*!
+ * \brief Clears the request and hit counters of the HPG memory pool.
+ */
+void hpg_pool_reset_stats(void);
+
+/*!
+ * \brief An incrementally rendered function plot.
+ *
+ * A plot samples a function once per pixel column and draws the curve on
+ * its own off-screen image.  The samples are cached: panning sideways
+ * shifts the picture and evaluates only the columns it exposes, so its
+ * cost is proportional to the pan distance.  After a change of scale the
+ * columns are evaluated coarse first, every 8th column, then every 4th,
+ * 2nd and all, and the curve is refined as the samples arrive.
+ *
+ * Evaluation is done by ::hpg_plot_update, in small batches, so the plot
+ * can be refined while the application keeps responding to the user.
+ */
+typedef struct hpg_plot hpg_plot_t;
+
+/*!
+ * \brief A function to plot.
+ *
+ * \param x   The x coordinate to evaluate
+ * \param y   Receives the value of the function at x
+ * \param arg The argument given to ::hpg_alloc_plot
+ * \return Non-zero if the function is defined at x
+ */
+typedef int (*hpg_plot_func_t)(double x, double *y, void *arg);
+
+/*!
+ * \brief Plot flag: draw the x and y axes.
+ */
+#define HPG_PLOT_AXES 1
+
+/*!
+ * \brief Creates a plot.
+ *
+ * The plot image is black on white with gray axes, centered on the origin
+ * with one unit per pixel.  No column is evaluated yet.
+ *
+ * \param width  The width of the plot image
+ * \param height The height of the plot image
+ * \param bpp    The depth of the plot image: 1, 2 or 4 bits per pixel
+ * \param func   The function to plot
+ * \param arg    An argument passed to the function
+ * \return The new plot, or NULL if out of memory
+ */
+hpg_plot_t *hpg_alloc_plot(int width, int height, int bpp,
+                           hpg_plot_func_t func, void *arg);
+
+/*!
+ * \brief Releases a plot and its image.
+ *
+ * \param p The plot
+ */
+void hpg_free_plot(hpg_plot_t *p);
+
+/*!
+ * \brief Retrieves the image a plot is drawn on.
+ *
+ * The image can be blitted to the screen or added to a layer set.  It
+ * should not be drawn upon.
+ *
+ * \param p The plot
+ * \return The plot image
+ */
+hpg_t *hpg_plot_get_image(hpg_plot_t *p);
+
+/*!
+ * \brief Sets the colors of a plot.
+ *
+ * \param p     The plot
+ * \param fg    The color of the curve
+ * \param bg    The background color
+ * \param axes  The color of the axes
+ * \param flags 0 or ::HPG_PLOT_AXES
+ */
+void hpg_plot_set_style(hpg_plot_t *p, unsigned char fg, unsigned char bg,
+                        unsigned char axes, int flags);
+
+/*!
+ * \brief Sets the area shown by a plot.
+ *
+ * All columns are evaluated again.  The left edge is rounded to a multiple
+ * of xstep, so columns are sampled at the same x coordinates after a pan.
+ *
+ * \param p     The plot
+ * \param xmin  The x coordinate of the left column
+ * \param ymax  The y coordinate of the top row
+ * \param xstep The x units per pixel
+ * \param ystep The y units per pixel
+ */
+void hpg_plot_set_view(hpg_plot_t *p, double xmin, double ymax,
+                       double xstep, double ystep);
+
+/*!
+ * \brief Moves the area shown by a plot.
+ *
+ * The cached columns are shifted with ::hpg_blit and only the exposed ones
+ * are evaluated.  A vertical pan evaluates nothing but redraws the curve
+ * from the cache.
+ *
+ * \param p  The plot
+ * \param dx The number of pixels to move right, negative to move left
+ * \param dy The number of pixels to move down, negative to move up
+ */
+void hpg_plot_pan(hpg_plot_t *p, int dx, int dy);
+
+/*!
+ * \brief Discards the cached samples of a plot.
+ *
+ * Use when the function changes.
+ *
+ * \param p The plot
+ */
+void hpg_plot_invalidate(hpg_plot_t *p);
+
+/*!
+ * \brief Evaluates pending columns of a plot and redraws them.
+ *
+ * Coarse columns are evaluated first.  Only the part of the image changed
+ * by the new samples is redrawn.
+ *
+ * \param p        The plot
+ * \param maxevals The maximum number of function evaluations
+ * \return The number of columns still pending, 0 when the plot is complete
+ */
+int hpg_plot_update(hpg_plot_t *p, int maxevals);
+
 /*!
  * \example example_set_pattern.c
  *
@@ -0,0 +1,819 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+// HOST-SIDE GOLDEN IMAGE AND THROUGHPUT BENCHMARK FOR THE GGL BLITTERS
+// THE REFERENCE IS A NIBBLE-BY-NIBBLE MODEL OF ggl_bitblt/ggl_revblt
+// AND OF THE PREDEFINED OPERATORS AND FILTERS
+// BUILD AND RUN WITH 'make bench'
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ggl.h>
+
+#define BUFWORDS 4096
+
+static int refgetnib(int *buf,int off)
+{
+	return (((unsigned *)buf)[off>>3]>>((off&7)<<2))&0xf;
+}
+
+static void refputnib(int *buf,int off,int color)
+{
+	unsigned *p=((unsigned *)buf)+(off>>3);
+	int sh=(off&7)<<2;
+	*p=(*p&~(0xfU<<sh))|((unsigned)color<<sh);
+}
+
+static void refblt(gglsurface *dest,gglsurface *src,int width,int height,int reverse)
+{
+	int i,j,r,c;
+	for(j=0;j<height;++j) {
+		r=(reverse)? height-1-j:j;
+		for(i=0;i<width;++i) {
+			c=(reverse)? width-1-i:i;
+			refputnib(dest->addr,(dest->y+r)*dest->width+dest->x+c,
+					refgetnib(src->addr,(src->y+r)*src->width+src->x+c));
+		}
+	}
+}
+
+// WRAPPERS, FORCE THE GENERIC PER-WORD PATH
+static unsigned genmask(unsigned d,unsigned s,int p) { return ggl_opmask(d,s,p); }
+static unsigned gentransp(unsigned d,unsigned s,int p) { return ggl_optransp(d,s,p); }
+static unsigned genlighten(unsigned w,int p) { return ggl_fltlighten(w,p); }
+static unsigned gendarken(unsigned w,int p) { return ggl_fltdarken(w,p); }
+
+static void refoper(gglsurface *dest,gglsurface *src,int width,int height,int param,ggloperator op)
+{
+	int i,j,doff,soff;
+	for(j=0;j<height;++j) {
+		for(i=0;i<width;++i) {
+			doff=(dest->y+j)*dest->width+dest->x+i;
+			soff=(src->y+j)*src->width+src->x+i;
+			refputnib(dest->addr,doff,(op)(refgetnib(dest->addr,doff),refgetnib(src->addr,soff),param)&0xf);
+		}
+	}
+}
+
+static void reffilter(gglsurface *dest,int width,int height,int param,gglfilter flt)
+{
+	int i,j,doff;
+	for(j=0;j<height;++j) {
+		for(i=0;i<width;++i) {
+			doff=(dest->y+j)*dest->width+dest->x+i;
+			refputnib(dest->addr,doff,(flt)(refgetnib(dest->addr,doff),param)&0xf);
+		}
+	}
+}
+
+static void fillrandom(int *buf,int nwords)
+{
+	while(nwords--) *buf++=(int)(((unsigned)rand()<<16)^(unsigned)rand());
+}
+
+static double now()
+{
+	return (double)clock()/CLOCKS_PER_SEC;
+}
+
+
+static int checkcopy(int reverse,int overlap)
+{
+	static int srcbuf[BUFWORDS],dst1[BUFWORDS],dst2[BUFWORDS];
+	gglsurface s,d1,d2;
+	int k,fail=0;
+
+	for(k=0;k<4000;++k) {
+		int w=1+rand()%100,h=1+rand()%12;
+		s.width=(rand()&1)? 160:w+rand()%40;
+		s.x=rand()%16; s.y=rand()%4;
+		d1.width=(overlap)? s.width:((rand()&1)? 160:w+rand()%40);
+		d1.x=rand()%16; d1.y=rand()%4;
+		d2=d1;
+
+		fillrandom(srcbuf,BUFWORDS);
+		fillrandom(dst1,BUFWORDS);
+		memcpy(dst2,dst1,sizeof(dst1));
+
+		if(overlap) {
+			// SCROLL WITHIN THE SAME BUFFER
+			memcpy(dst1,srcbuf,sizeof(srcbuf));
+			memcpy(dst2,srcbuf,sizeof(srcbuf));
+			d1.addr=dst1; d2.addr=dst2;
+			s.addr=dst1;
+			// REFERENCE: COPY FROM A SNAPSHOT, IN ANY ORDER
+			s.addr=srcbuf;
+			refblt(&d2,&s,w,h,0);
+			s.addr=dst1;
+			ggl_fastovlblt(&d1,&s,w,h);
+		}
+		else {
+			s.addr=srcbuf;
+			d1.addr=dst1; d2.addr=dst2;
+			refblt(&d2,&s,w,h,reverse);
+			if(reverse) ggl_fastrevblt(&d1,&s,w,h);
+			else ggl_fastblt(&d1,&s,w,h);
+		}
+
+		if(memcmp(dst1,dst2,sizeof(dst1))) {
+			printf("  MISMATCH w=%d h=%d src(%d,%d,w=%d) dst(%d,%d,w=%d)\n",
+					w,h,s.x,s.y,s.width,d1.x,d1.y,d1.width);
+			if(++fail>5) break;
+		}
+	}
+	return fail;
+}
+
+static int checkoper(const char *name,ggloperator op,int maxparam)
+{
+	static int srcbuf[BUFWORDS],dst1[BUFWORDS],dst2[BUFWORDS];
+	gglsurface s,d1,d2;
+	int k,fail=0;
+
+	printf("golden image, ggl_fastbltoper %s\n",name);
+	for(k=0;k<4000;++k) {
+		int w=1+rand()%100,h=1+rand()%12,p=rand()%(maxparam+1);
+		s.width=(rand()&1)? 160:w+rand()%40;
+		s.x=rand()%16; s.y=rand()%4;
+		d1.width=(rand()&1)? 160:w+rand()%40;
+		d1.x=rand()%16; d1.y=rand()%4;
+		d2=d1;
+
+		fillrandom(srcbuf,BUFWORDS);
+		fillrandom(dst1,BUFWORDS);
+		memcpy(dst2,dst1,sizeof(dst1));
+		s.addr=srcbuf;
+		d1.addr=dst1; d2.addr=dst2;
+
+		refoper(&d2,&s,w,h,p,op);
+		ggl_fastbltoper(&d1,&s,w,h,p,op);
+
+		if(memcmp(dst1,dst2,sizeof(dst1))) {
+			printf("  MISMATCH w=%d h=%d param=%d src(%d,%d,w=%d) dst(%d,%d,w=%d)\n",
+					w,h,p,s.x,s.y,s.width,d1.x,d1.y,d1.width);
+			if(++fail>5) break;
+		}
+	}
+	return fail;
+}
+
+static int checkfilter(const char *name,gglfilter flt)
+{
+	static int dst1[BUFWORDS],dst2[BUFWORDS];
+	gglsurface d1,d2;
+	int k,fail=0;
+
+	printf("golden image, ggl_fastfilter %s\n",name);
+	for(k=0;k<4000;++k) {
+		int w=1+rand()%100,h=1+rand()%12,p=rand()%17;
+		d1.width=(rand()&1)? 160:w+rand()%40;
+		d1.x=rand()%16; d1.y=rand()%4;
+		d2=d1;
+
+		fillrandom(dst1,BUFWORDS);
+		memcpy(dst2,dst1,sizeof(dst1));
+		d1.addr=dst1; d2.addr=dst2;
+
+		reffilter(&d2,w,h,p,flt);
+		ggl_fastfilter(&d1,w,h,p,flt);
+
+		if(memcmp(dst1,dst2,sizeof(dst1))) {
+			printf("  MISMATCH w=%d h=%d param=%d dst(%d,%d,w=%d)\n",
+					w,h,p,d1.x,d1.y,d1.width);
+			if(++fail>5) break;
+		}
+	}
+	return fail;
+}
+
+// RANDOM SPRITE IMAGE WITH TRANSPARENT, OPAQUE AND MIXED AREAS
+static void fillsprite(int *buf,int nwords,int tcol)
+{
+	int k,i;
+	unsigned w;
+	for(k=0;k<nwords;++k) {
+		w=((unsigned)rand()<<16)^(unsigned)rand();
+		switch(rand()%4) {
+		case 0: w=(unsigned)tcol*0x11111111; break;
+		case 1: break;
+		default:
+			for(i=0;i<32;i+=4) if(rand()&1) w=(w&~(0xfU<<i))|((unsigned)tcol<<i);
+		}
+		buf[k]=(int)w;
+	}
+}
+
+static int checksprite()
+{
+	static int srcbuf[BUFWORDS],dst1[BUFWORDS],dst2[BUFWORDS];
+	static unsigned int sprite[BUFWORDS*3];
+	gglsurface s,d1,d2;
+	int k,fail=0,size;
+
+	printf("golden image, ggl_spriteblt\n");
+	for(k=0;k<4000;++k) {
+		int w=1+rand()%100,h=1+rand()%12,tcol=rand()&15;
+		s.width=(rand()&1)? 160:w+rand()%40;
+		s.x=rand()%16; s.y=rand()%4;
+		d1.width=(rand()&1)? 160:w+rand()%40;
+		d1.x=rand()%16; d1.y=rand()%4;
+		d2=d1;
+
+		fillsprite(srcbuf,BUFWORDS,tcol);
+		fillrandom(dst1,BUFWORDS);
+		memcpy(dst2,dst1,sizeof(dst1));
+		s.addr=srcbuf;
+		d1.addr=dst1; d2.addr=dst2;
+
+		size=ggl_mksprite(NULL,&s,w,h,tcol);
+		if(size>(int)(sizeof(sprite)/sizeof(sprite[0])) || ggl_mksprite(sprite,&s,w,h,tcol)!=size
+				|| ggl_spritewidth(sprite)!=w || ggl_spriteheight(sprite)!=h) {
+			printf("  BAD SPRITE w=%d h=%d size=%d\n",w,h,size);
+			if(++fail>5) break;
+			continue;
+		}
+
+		refoper(&d2,&s,w,h,tcol,&ggl_opmask);
+		ggl_spriteblt(&d1,sprite);
+
+		if(memcmp(dst1,dst2,sizeof(dst1))) {
+			printf("  MISMATCH w=%d h=%d tcol=%d src(%d,%d,w=%d) dst(%d,%d,w=%d)\n",
+					w,h,tcol,s.x,s.y,s.width,d1.x,d1.y,d1.width);
+			if(++fail>5) break;
+		}
+	}
+	return fail;
+}
+
+// SPRITE SHEET WITH A GIVEN PERCENTAGE OF TRANSPARENT 8x1 BLOCKS
+static void spritethroughput(int transparent)
+{
+	static int srcbuf[SCREENBUFSIZE/4+8],dstbuf[SCREENBUFSIZE/4+8];
+	static unsigned int sprite[SCREENBUFSIZE/2];
+	gglsurface s,d;
+	double t0,tmask,tspr;
+	int k,n=2000;
+
+	fillrandom(srcbuf,SCREENBUFSIZE/4+8);
+	for(k=0;k<SCREENBUFSIZE/4;++k) {
+		srcbuf[k]&=0xeeeeeeee;	// NO PIXEL IS COLOR 15
+		if(rand()%100<transparent) srcbuf[k]=-1;
+		else if(!(rand()%8)) srcbuf[k]|=0xf000f;
+	}
+	s.addr=srcbuf; s.width=LCD_W; s.x=0; s.y=0;
+	d.addr=dstbuf; d.width=LCD_W; d.x=3; d.y=0;
+	ggl_mksprite(sprite,&s,LCD_W-8,LCD_H,15);
+
+	t0=now();
+	for(k=0;k<n;++k) ggl_fastbltoper(&d,&s,LCD_W-8,LCD_H,15,&ggl_opmask);
+	tmask=now()-t0;
+
+	t0=now();
+	for(k=0;k<n;++k) ggl_spriteblt(&d,sprite);
+	tspr=now()-t0;
+
+	printf("  %3d%% transparent: fused opmask %8.2f Mpix/s, ggl_spriteblt %8.2f Mpix/s (%5.1fx)\n",transparent,
+			(double)n*(LCD_W-8)*LCD_H/tmask/1e6,(double)n*(LCD_W-8)*LCD_H/tspr/1e6,tmask/tspr);
+}
+
+// DOUBLE PRECISION WU LINE, SAME COVERAGE RULES AS ggl_apolyline
+static void refaline(gglsurface *srf,int x1,int y1,int x2,int y2,int color)
+{
+	int dx=x2-x1,dy=y2-y1,k,n,major,f,c,p;
+	double pos;
+	major=(abs(dx)>=abs(dy));
+	n=(major)? abs(dx):abs(dy);
+	for(k=0;k<=n;++k) {
+		int a=(major)? x1+((dx>0)? k:-k):y1+((dy>0)? k:-k);
+		pos=(major)? y1+(double)(a-x1)*dy/dx:x1+(double)(a-y1)*dx/dy;
+		f=(int)((pos-(int)pos)*16+0.5);
+		int base=(int)pos;
+		if(f==16) { ++base; f=0; }
+		for(c=0;c<2;++c) {
+			int cov=(c)? f:16-f,off;
+			if(!cov) continue;
+			off=(major)? (base+c)*srf->width+a:a*srf->width+base+c;
+			p=refgetnib(srf->addr,off);
+			refputnib(srf->addr,off,p+(((color-p)*cov)>>4));
+		}
+	}
+}
+
+static int checkapoly()
+{
+	static int buf1[BUFWORDS],buf2[BUFWORDS];
+	gglsurface s1,s2;
+	int k,i,fail=0,pts[6];
+
+	printf("golden image, ggl_apolyline\n");
+	s1.addr=buf1; s2.addr=buf2;
+	s1.width=s2.width=128;
+	s1.x=s1.y=s2.x=s2.y=0;
+
+	for(k=0;k<4000 && fail<=5;++k) {
+		int color=rand()&15,bad=0;
+		memset(buf1,0,sizeof(buf1));
+		memset(buf2,0,sizeof(buf2));
+		for(i=0;i<4;i+=2) { pts[i]=rand()%128; pts[i+1]=rand()%60; }
+
+		if(k&1) {
+			// SINGLE SEGMENT, WITHIN 1 LEVEL OF THE REFERENCE
+			ggl_apolyline(&s1,pts,2,color);
+			refaline(&s2,pts[0],pts[1],pts[2],pts[3],color);
+			for(i=0;i<128*60;++i) if(abs(refgetnib(buf1,i)-refgetnib(buf2,i))>1) bad=1;
+		}
+		else {
+			// SPLITTING A SEGMENT WITH AN EXACT SLOPE AT A VERTEX CHANGES NOTHING
+			int dx=(rand()%31)-15,dy=(rand()%15)-7,m=1+rand()%3;
+			pts[0]=64; pts[1]=30;
+			pts[2]=pts[0]+dx; pts[3]=pts[1]+dy;
+			pts[4]=pts[0]+dx*(m+1); pts[5]=pts[1]+dy*(m+1);
+			ggl_apolyline(&s1,pts,3,color);
+			pts[2]=pts[4]; pts[3]=pts[5];
+			ggl_apolyline(&s2,pts,2,color);
+			if(memcmp(buf1,buf2,sizeof(buf1))) bad=1;
+		}
+		if(bad) {
+			printf("  MISMATCH (%d,%d)-(%d,%d)-(%d,%d) color=%d\n",pts[0],pts[1],pts[2],pts[3],pts[4],pts[5],color);
+			++fail;
+		}
+	}
+	return fail;
+}
+
+// ONE LONG CURVE AGAINST THE SAME CURVE DRAWN ONE SEGMENT PER CALL
+static void apolythroughput()
+{
+	static int buf[SCREENBUFSIZE/4];
+	static int pts[2*1000];
+	gglsurface s;
+	double t0,tseg,tpoly;
+	int k,i,n=200;
+
+	s.addr=buf; s.width=LCD_W; s.x=s.y=0;
+	for(i=0;i<1000;++i) {
+		pts[2*i]=(i*(LCD_W-1))/999;
+		pts[2*i+1]=(LCD_H/2)+(int)((LCD_H/2-1)*((i*37)%200-100)/100.0);
+	}
+
+	t0=now();
+	for(k=0;k<n;++k) for(i=0;i<999;++i) ggl_apolyline(&s,pts+2*i,2,k&15);
+	tseg=now()-t0;
+
+	t0=now();
+	for(k=0;k<n;++k) ggl_apolyline(&s,pts,1000,k&15);
+	tpoly=now()-t0;
+
+	printf("  1000 vertices: per-segment calls %8.0f curves/s, one call %8.0f curves/s (%5.1fx)\n",
+			n/tseg,n/tpoly,tseg/tpoly);
+}
+
+// TILE MAP REFERENCE, ONE PIXEL AT A TIME
+static void reftmap(ggltilemap *tm,gglsurface *dest)
+{
+	int x,y,mx,my,tx,ty,c;
+	for(y=0;y<tm->viewheight;++y) {
+		for(x=0;x<tm->viewwidth;++x) {
+			mx=tm->scrollx+x;
+			my=tm->scrolly+y;
+			tx=(mx<0)? -1:mx/tm->tilesize;
+			ty=(my<0)? -1:my/tm->tilesize;
+			if(tx<0 || ty<0 || tx>=tm->mapwidth || ty>=tm->mapheight) c=(tm->bgcolor>>((mx&7)<<2))&0xf;
+			else c=refgetnib(tm->tiles,(tm->map[ty*tm->mapwidth+tx]*tm->tilesize+my%tm->tilesize)*tm->tilesize+mx%tm->tilesize);
+			refputnib(dest->addr,(dest->y+y)*dest->width+dest->x+x,c);
+		}
+	}
+}
+
+static int checktmap()
+{
+	static int atlas[16*32],buf1[BUFWORDS],buf2[BUFWORDS];
+	static unsigned short map[20*12];
+	ggltilemap tm;
+	gglsurface s1,s2;
+	int k,i,fail=0;
+
+	printf("golden image, ggl_tmdraw/ggl_tmscroll\n");
+	fillrandom(atlas,16*32);
+	for(i=0;i<20*12;++i) map[i]=rand()%16;
+
+	for(k=0;k<2000 && fail<=5;++k) {
+		int ts=(k&1)? 16:8,steps=rand()%4;
+		ggl_tminit(&tm,atlas,ts,map,(ts==8)? 20:10,(ts==8)? 12:6,8+rand()%120,4+rand()%50);
+		tm.bgcolor=(int)(((unsigned)rand()<<16)^(unsigned)rand());
+		tm.scrollx=(rand()&1)? (rand()%24)*8-16:rand()%180-20;
+		tm.scrolly=rand()%100-20;
+		s1.width=(rand()&1)? 160:tm.viewwidth+rand()%40;
+		s1.x=(rand()&1)? (rand()%3)*8:rand()%16;
+		s1.y=rand()%8;
+		s1.addr=buf1;
+		s2=s1;
+		s2.addr=buf2;
+
+		fillrandom(buf1,BUFWORDS);
+		memcpy(buf2,buf1,sizeof(buf1));
+
+		ggl_tmdraw(&tm,&s1);
+		for(i=0;i<steps;++i) {
+			int dx=rand()%40-20,dy=rand()%20-10;
+			if(rand()&1) dx&=~7;
+			ggl_tmscroll(&tm,&s1,dx,dy);
+		}
+		reftmap(&tm,&s2);
+
+		if(memcmp(buf1,buf2,sizeof(buf1))) {
+			printf("  MISMATCH ts=%d view %dx%d scroll (%d,%d) dst(%d,%d,w=%d)\n",ts,tm.viewwidth,tm.viewheight,
+					tm.scrollx,tm.scrolly,s1.x,s1.y,s1.width);
+			++fail;
+		}
+	}
+	return fail;
+}
+
+// FULL REDRAW PER FRAME AGAINST SCROLL + EXPOSED STRIP
+static void tmapthroughput(int ts,int step)
+{
+	static int atlas[16*32],buf[SCREENBUFSIZE/4];
+	static unsigned short map[64*64];
+	ggltilemap tm;
+	gglsurface s;
+	double t0,tfull,tscroll;
+	int k,n=2000;
+
+	fillrandom(atlas,16*32);
+	for(k=0;k<64*64;++k) map[k]=rand()%16;
+	s.addr=buf; s.width=LCD_W; s.x=s.y=0;
+	ggl_tminit(&tm,atlas,ts,map,64,64,LCD_W,LCD_H);
+
+	t0=now();
+	for(k=0;k<n;++k) { tm.scrollx=(k*step)&255; ggl_tmdraw(&tm,&s); }
+	tfull=now()-t0;
+
+	tm.scrollx=0;
+	ggl_tmdraw(&tm,&s);
+	t0=now();
+	for(k=0;k<n;++k) ggl_tmscroll(&tm,&s,((k&127)<64)? step:-step,0);
+	tscroll=now()-t0;
+
+	printf("  %dx%d tiles, %d pixel steps: full redraw %8.0f frames/s, ggl_tmscroll %8.0f frames/s (%5.1fx)\n",
+			ts,ts,step,n/tfull,n/tscroll,tfull/tscroll);
+}
+
+// FILLED SHAPE REFERENCES, ONE PIXEL AT A TIME
+static void refpset(gglsurface *srf,int x,int y,int *pattern)
+{
+	refputnib(srf->addr,y*srf->width+x,(pattern[y&7]>>((x&7)<<2))&0xf);
+}
+
+static void refellipse(gglsurface *srf,int xc,int yc,int rx,int ry,int *pattern)
+{
+	long long a2=(long long)(2*rx+1)*(2*rx+1),b2=(long long)(2*ry+1)*(2*ry+1);
+	int x,y;
+	for(y=-ry;y<=ry;++y)
+		for(x=-rx;x<=rx;++x)
+			if(4*(long long)x*x*b2+4*(long long)y*y*a2<=a2*b2) refpset(srf,xc+x,yc+y,pattern);
+}
+
+static void refpoly(gglsurface *srf,int *pts,int n,int *pattern)
+{
+	int x,y,k,cnt;
+	for(y=0;y<64;++y) {
+		for(x=0;x<128;++x) {
+			// COUNT EDGES CROSSING SCANLINE y AT OR LEFT OF x (CEIL RULE)
+			cnt=0;
+			for(k=0;k<n;++k) {
+				int x0=pts[2*k],y0=pts[2*k+1],x1=pts[2*((k+1)%n)],y1=pts[2*((k+1)%n)+1],t;
+				long long num;
+				if(y0==y1) continue;
+				if(y0>y1) { t=x0; x0=x1; x1=t; t=y0; y0=y1; y1=t; }
+				if(y<y0 || y>=y1) continue;
+				// x >= ceil(x0+(y-y0)*(x1-x0)/(y1-y0))  <=>  x*(y1-y0) >= x0*(y1-y0)+(y-y0)*(x1-x0)
+				num=(long long)x0*(y1-y0)+(long long)(y-y0)*(x1-x0);
+				if((long long)x*(y1-y0)>=num) ++cnt;
+			}
+			if(cnt&1) refpset(srf,x,y,pattern);
+		}
+	}
+}
+
+static int checkfill()
+{
+	static int buf1[BUFWORDS],buf2[BUFWORDS];
+	gglsurface s1,s2;
+	int k,i,fail=0,pat[8],pts[16];
+
+	printf("golden image, ggl_fillcircle/ggl_fillellipse/ggl_fillpoly\n");
+	s1.addr=buf1; s2.addr=buf2;
+	s1.width=s2.width=128;
+	s1.x=s1.y=s2.x=s2.y=0;
+
+	for(k=0;k<3000 && fail<=5;++k) {
+		int shape=k%3,usepat=rand()&1,n=0;
+		fillrandom(pat,8);
+		if(!usepat) for(i=1;i<8;++i) pat[i]=pat[0];
+		fillrandom(buf1,BUFWORDS);
+		memcpy(buf2,buf1,sizeof(buf1));
+
+		if(shape==0) {
+			int r=rand()%30,xc=32+rand()%64,yc=30+rand()%4;
+			if(usepat) ggl_fillcirclep(&s1,xc,yc,r,pat); else ggl_fillcircle(&s1,xc,yc,r,pat[0]);
+			// x^2+y^2 <= r^2+r IS THE SAME AS THE ELLIPSE TEST WITH rx=ry=r
+			refellipse(&s2,xc,yc,r,r,pat);
+		}
+		else if(shape==1) {
+			int rx=rand()%30,ry=rand()%30,xc=32+rand()%64,yc=30+rand()%4;
+			if(usepat) ggl_fillellipsep(&s1,xc,yc,rx,ry,pat); else ggl_fillellipse(&s1,xc,yc,rx,ry,pat[0]);
+			refellipse(&s2,xc,yc,rx,ry,pat);
+		}
+		else {
+			n=3+rand()%6;
+			for(i=0;i<n;++i) { pts[2*i]=rand()%128; pts[2*i+1]=rand()%64; }
+			if(usepat) ggl_fillpolyp(&s1,pts,n,pat); else ggl_fillpoly(&s1,pts,n,pat[0]);
+			refpoly(&s2,pts,n,pat);
+		}
+
+		if(memcmp(buf1,buf2,sizeof(buf1))) {
+			printf("  MISMATCH shape=%d pattern=%d n=%d\n",shape,usepat,n);
+			++fail;
+		}
+	}
+	return fail;
+}
+
+// SPANS THROUGH ggl_hline AGAINST THE PER-PIXEL REFERENCE
+static void fillthroughput()
+{
+	static int buf[SCREENBUFSIZE/4];
+	static int pts[]={ 10,5, 150,20, 120,75, 60,50, 20,70 };
+	gglsurface s;
+	double t0,tref,tfast;
+	int k,n=200,pat[8];
+
+	s.addr=buf; s.width=LCD_W; s.x=s.y=0;
+	fillrandom(pat,8);
+
+	t0=now();
+	for(k=0;k<n;++k) refellipse(&s,80,40,39,39,pat);
+	tref=now()-t0;
+	t0=now();
+	for(k=0;k<n*20;++k) ggl_fillcirclep(&s,80,40,39,pat);
+	tfast=(now()-t0)/20;
+	printf("  circle r=39:  reference %8.0f/s, ggl_fillcirclep %8.0f/s (%5.1fx)\n",n/tref,n/tfast,tref/tfast);
+
+	t0=now();
+	for(k=0;k<n*20;++k) ggl_fillellipsep(&s,80,40,75,39,pat);
+	tfast=(now()-t0)/20;
+	printf("  ellipse 151x79: ggl_fillellipsep %8.0f/s\n",n/tfast);
+
+	t0=now();
+	for(k=0;k<n*20;++k) ggl_fillpolyp(&s,pts,5,pat);
+	tfast=(now()-t0)/20;
+	printf("  5-vertex polygon: ggl_fillpolyp %8.0f/s\n",n/tfast);
+}
+
+// PER-PIXEL MODELS OF ggl_expandblt AND ggl_reduceblt
+static int refgetbits(const unsigned *buf,int off,int bpp)
+{
+	off*=bpp;
+	return (buf[off>>5]>>(off&31))&((1<<bpp)-1);
+}
+
+static void refputbits(unsigned *buf,int off,int bpp,int v)
+{
+	off*=bpp;
+	buf[off>>5]=(buf[off>>5]&~(((1U<<bpp)-1)<<(off&31)))|((unsigned)v<<(off&31));
+}
+
+static void refexpand(gglsurface *dest,const unsigned *src,int bpp,int sw,int sx,int sy,int width,int height,int mode)
+{
+	int i,j,v,doff;
+	for(j=0;j<height;++j) {
+		for(i=0;i<width;++i) {
+			v=refgetbits(src,(sy+j)*sw+sx+i,bpp)*((bpp==1)? 15:5);
+			doff=(dest->y+j)*dest->width+dest->x+i;
+			if(mode==GGL_CONV_XOR) refputnib(dest->addr,doff,refgetnib(dest->addr,doff)^v);
+			else if(v || mode==GGL_CONV_COPY) refputnib(dest->addr,doff,v);
+		}
+	}
+}
+
+static void refreduce(unsigned *dest,int bpp,int dw,int dx,int dy,gglsurface *src,int width,int height,int mode)
+{
+	static const int bayer[4][4]={ { 0,8,2,10 },{ 12,4,14,6 },{ 3,11,1,9 },{ 15,7,13,5 } };
+	int i,j,v,q,t,n=(1<<bpp)-1,off;
+	for(j=0;j<height;++j) {
+		for(i=0;i<width;++i) {
+			v=refgetnib(src->addr,(src->y+j)*src->width+src->x+i);
+			t=(mode&GGL_CONV_DITHER)? 2*bayer[(dy+j)&3][(dx+i)&3]+1:16;
+			q=(v*n*32+t*15)/480;
+			off=(dy+j)*dw+dx+i;
+			if((mode&~GGL_CONV_DITHER)==GGL_CONV_XOR) refputbits(dest,off,bpp,refgetbits(dest,off,bpp)^q);
+			else if(v || (mode&~GGL_CONV_DITHER)==GGL_CONV_COPY) refputbits(dest,off,bpp,q);
+		}
+	}
+}
+
+static int checkconv()
+{
+	static int src[BUFWORDS],buf1[BUFWORDS],buf2[BUFWORDS];
+	gglsurface s1,s2,s;
+	int k,fail=0,bpp,mode,w,h,sw,sx,sy;
+
+	printf("golden image, ggl_expandblt/ggl_reduceblt\n");
+	for(k=0;k<4000 && fail<=5;++k) {
+		bpp=1+(rand()&1);
+		mode=rand()%3;
+		sw=1+rand()%100;
+		w=1+rand()%40;
+		h=1+rand()%20;
+		fillrandom(src,BUFWORDS);
+		fillrandom(buf1,BUFWORDS);
+		memcpy(buf2,buf1,sizeof(buf1));
+		if(k&1) {
+			s1.addr=buf1; s2.addr=buf2;
+			s1.width=s2.width=w+rand()%90;
+			s1.x=s2.x=rand()%(s1.width-w+1);
+			s1.y=s2.y=rand()%8;
+			sx=rand()%8;
+			sy=rand()%8;
+			ggl_expandblt(&s1,(unsigned *)src,bpp,sw,sx,sy,w,h,mode);
+			refexpand(&s2,(unsigned *)src,bpp,sw,sx,sy,w,h,mode);
+		}
+		else {
+			int dw=w+rand()%90,dx=rand()%(dw-w+1),dy=rand()%8;
+			if(rand()&1) mode|=GGL_CONV_DITHER;
+			s.addr=src; s.width=100; s.x=rand()%50; s.y=rand()%8;
+			ggl_reduceblt((unsigned *)buf1,bpp,dw,dx,dy,&s,w,h,mode);
+			refreduce((unsigned *)buf2,bpp,dw,dx,dy,&s,w,h,mode);
+		}
+		if(memcmp(buf1,buf2,sizeof(buf1))) {
+			printf("  MISMATCH %s bpp=%d mode=%d w=%d h=%d\n",(k&1)? "expand":"reduce",bpp,mode,w,h);
+			++fail;
+		}
+	}
+	return fail;
+}
+
+// TABLE-DRIVEN CONVERSION AGAINST THE PER-PIXEL MODEL
+static void convthroughput(int bpp)
+{
+	static int src[SCREENBUFSIZE/4+8],dst[SCREENBUFSIZE/4+8];
+	gglsurface d;
+	double t0,tref,tfast;
+	int k,n=200;
+
+	fillrandom(src,SCREENBUFSIZE/4+8);
+	d.addr=dst; d.width=LCD_W; d.x=3; d.y=0;
+
+	t0=now();
+	for(k=0;k<n;++k) refexpand(&d,(unsigned *)src,bpp,LCD_W,0,0,LCD_W-8,LCD_H,GGL_CONV_TRANSP);
+	tref=now()-t0;
+	t0=now();
+	for(k=0;k<n*20;++k) ggl_expandblt(&d,(unsigned *)src,bpp,LCD_W,0,0,LCD_W-8,LCD_H,GGL_CONV_TRANSP);
+	tfast=(now()-t0)/20;
+	printf("  expand %d bpp: reference %8.2f Mpix/s, ggl_expandblt %8.2f Mpix/s (%5.1fx)\n",bpp,
+			(double)n*(LCD_W-8)*LCD_H/tref/1e6,(double)n*(LCD_W-8)*LCD_H/tfast/1e6,tref/tfast);
+
+	d.x=0;
+	t0=now();
+	for(k=0;k<n;++k) refreduce((unsigned *)src,bpp,LCD_W,3,0,&d,LCD_W-8,LCD_H,GGL_CONV_DITHER);
+	tref=now()-t0;
+	t0=now();
+	for(k=0;k<n*20;++k) ggl_reduceblt((unsigned *)src,bpp,LCD_W,3,0,&d,LCD_W-8,LCD_H,GGL_CONV_DITHER);
+	tfast=(now()-t0)/20;
+	printf("  reduce %d bpp: reference %8.2f Mpix/s, ggl_reduceblt %8.2f Mpix/s (%5.1fx)\n",bpp,
+			(double)n*(LCD_W-8)*LCD_H/tref/1e6,(double)n*(LCD_W-8)*LCD_H/tfast/1e6,tref/tfast);
+}
+
+// FUSED OPERATOR AGAINST THE SAME OPERATOR CALLED PER WORD
+static void operthroughput(const char *name,ggloperator fused,ggloperator generic,int param)
+{
+	static int srcbuf[SCREENBUFSIZE/4+8],dstbuf[SCREENBUFSIZE/4+8];
+	gglsurface s,d;
+	double t0,tgen,tfused;
+	int k,n=2000;
+
+	fillrandom(srcbuf,SCREENBUFSIZE/4+8);
+	fillrandom(dstbuf,SCREENBUFSIZE/4+8);
+	s.addr=srcbuf; s.width=LCD_W; s.x=3; s.y=0;
+	d.addr=dstbuf; d.width=LCD_W; d.x=0; d.y=0;
+
+	t0=now();
+	for(k=0;k<n;++k) ggl_fastbltoper(&d,&s,LCD_W-8,LCD_H,param,generic);
+	tgen=now()-t0;
+
+	t0=now();
+	for(k=0;k<n;++k) ggl_fastbltoper(&d,&s,LCD_W-8,LCD_H,param,fused);
+	tfused=now()-t0;
+
+	printf("  %-10s per-word call %8.2f Mpix/s, fused %8.2f Mpix/s (%5.1fx)\n",name,
+			(double)n*(LCD_W-8)*LCD_H/tgen/1e6,(double)n*(LCD_W-8)*LCD_H/tfused/1e6,tgen/tfused);
+}
+
+static void filterthroughput(const char *name,gglfilter fused,gglfilter generic,int param)
+{
+	static int dstbuf[SCREENBUFSIZE/4+8];
+	gglsurface d;
+	double t0,tgen,tfused;
+	int k,n=2000;
+
+	fillrandom(dstbuf,SCREENBUFSIZE/4+8);
+	d.addr=dstbuf; d.width=LCD_W; d.x=0; d.y=0;
+
+	t0=now();
+	for(k=0;k<n;++k) ggl_fastfilter(&d,LCD_W,LCD_H,param,generic);
+	tgen=now()-t0;
+
+	t0=now();
+	for(k=0;k<n;++k) ggl_fastfilter(&d,LCD_W,LCD_H,param,fused);
+	tfused=now()-t0;
+
+	printf("  %-10s per-word call %8.2f Mpix/s, fused %8.2f Mpix/s (%5.1fx)\n",name,
+			(double)n*LCD_W*LCD_H/tgen/1e6,(double)n*LCD_W*LCD_H/tfused/1e6,tgen/tfused);
+}
+
+static void throughput(int shift)
+{
+	static int srcbuf[SCREENBUFSIZE/4+8],dstbuf[SCREENBUFSIZE/4+8];
+	gglsurface s,d;
+	double t0,tref,tfast;
+	int k,n=200;
+
+	fillrandom(srcbuf,SCREENBUFSIZE/4+8);
+	s.addr=srcbuf; s.width=LCD_W; s.x=shift; s.y=0;
+	d.addr=dstbuf; d.width=LCD_W; d.x=0; d.y=0;
+
+	t0=now();
+	for(k=0;k<n;++k) refblt(&d,&s,LCD_W-8,LCD_H,0);
+	tref=now()-t0;
+
+	t0=now();
+	for(k=0;k<n*50;++k) ggl_fastblt(&d,&s,LCD_W-8,LCD_H);
+	tfast=(now()-t0)/50;
+
+	printf("  shift %d: reference %8.2f Mpix/s, ggl_fastblt %8.2f Mpix/s (%5.1fx)\n",shift,
+			(double)n*(LCD_W-8)*LCD_H/tref/1e6,(double)n*(LCD_W-8)*LCD_H/tfast/1e6,tref/tfast);
+}
+
+int main()
+{
+	int fail=0,k;
+
+	srand(1234);
+
+	printf("golden image, ggl_fastblt\n");
+	fail+=checkcopy(0,0);
+	printf("golden image, ggl_fastrevblt\n");
+	fail+=checkcopy(1,0);
+	printf("golden image, ggl_fastovlblt\n");
+	fail+=checkcopy(0,1);
+
+	fail+=checkoper("opmask",&ggl_opmask,15);
+	fail+=checkoper("optransp",&ggl_optransp,16);
+	fail+=checkoper("generic",&gentransp,16);
+	fail+=checkfilter("fltlighten",&ggl_fltlighten);
+	fail+=checkfilter("fltdarken",&ggl_fltdarken);
+	fail+=checkfilter("generic",&genlighten);
+	fail+=checksprite();
+	fail+=checkapoly();
+	fail+=checktmap();
+	fail+=checkfill();
+	fail+=checkconv();
+
+	printf("throughput, %dx%d gray16 blit\n",LCD_W-8,LCD_H);
+	for(k=0;k<8;++k) throughput(k);
+
+	printf("throughput, operators and filters\n");
+	operthroughput("opmask",&ggl_opmask,&genmask,5);
+	operthroughput("optransp",&ggl_optransp,&gentransp,7);
+	filterthroughput("fltlighten",&ggl_fltlighten,&genlighten,3);
+	filterthroughput("fltdarken",&ggl_fltdarken,&gendarken,3);
+
+	printf("throughput, %dx%d sprite\n",LCD_W-8,LCD_H);
+	for(k=0;k<=90;k+=30) spritethroughput(k);
+
+	printf("throughput, antialiased polyline\n");
+	apolythroughput();
+
+	printf("throughput, tile map\n");
+	tmapthroughput(8,8);
+	tmapthroughput(8,3);
+	tmapthroughput(16,8);
+
+	printf("throughput, filled shapes\n");
+	fillthroughput();
+
+	printf("throughput, depth conversion\n");
+	convthroughput(1);
+	convthroughput(2);
+
+	printf((fail)? "FAILED\n":"PASSED\n");
+	return (fail)? 1:0;
+}
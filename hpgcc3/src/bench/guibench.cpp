@@ -0,0 +1,548 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+// HOST-SIDE TESTS AND THROUGHPUT BENCHMARK FOR THE TEXT STORAGE AND THE
+// DAMAGE REGIONS OF THE GUI
+// THE GAP BUFFER AND THE LINE INDEX ARE COMPARED WITH A PLAIN COPY OF THE
+// TEXT AFTER EVERY EDIT, THE REGIONS WITH A BITMAP OF THE DAMAGED PIXELS
+// BUILD AND RUN WITH 'make bench'
+
+#include <hpgcc3.h>
+#include <gui.h>
+#include <time.h>
+
+#define REF_MAX 4096
+
+static double now()
+{
+	return (double)clock()/CLOCKS_PER_SEC;
+}
+
+static unsigned seed=1234;
+
+static int rnd(int n)
+{
+	seed=seed*1103515245U+12345U;
+	return (int)((seed>>16)%(unsigned)n);
+}
+
+// REFERENCE TEXT, EDITED ALONGSIDE THE BUFFER
+static char ref[REF_MAX];
+static int reflen;
+
+static void refinsert(int offset,const char *data,int bytes)
+{
+	memmove(ref+offset+bytes,ref+offset,reflen-offset);
+	memcpy(ref+offset,data,bytes);
+	reflen+=bytes;
+}
+
+static void refdelete(int offset,int bytes)
+{
+	memmove(ref+offset,ref+offset+bytes,reflen-offset-bytes);
+	reflen-=bytes;
+}
+
+// A LINE STARTS AFTER A \n, OR A \r NOT FOLLOWED BY \n
+static int refstart(int k)
+{
+	if(k<=0 || k>reflen) return 0;
+	return ref[k-1]=='\n' || (ref[k-1]=='\r' && (k==reflen || ref[k]!='\n'));
+}
+
+static int reflines()
+{
+	int k,n=1;
+
+	for(k=1;k<=reflen;++k) if(refstart(k)) ++n;
+	return n;
+}
+
+// THE TEXT, ITS PIECES AROUND THE GAP AND ITS LINE COUNT MATCH ref
+static int gapcheck(gGapText *g,const char *what)
+{
+	static char buf[REF_MAX];
+	const char *p;
+	int k,n;
+
+	if(g->Length()!=reflen || g->GapStart>g->GapEnd || g->GapEnd>g->Size) {
+		printf("  %s: LENGTH %d, EXPECTED %d (GAP %d-%d OF %d)\n",what,g->Length(),reflen,g->GapStart,g->GapEnd,g->Size);
+		return 1;
+	}
+	for(k=0;k<reflen;++k) if(g->CharAt(k)!=(unsigned char)ref[k]) {
+		printf("  %s: CharAt(%d) IS %d, EXPECTED %d\n",what,k,g->CharAt(k),ref[k]);
+		return 1;
+	}
+	if(g->CharAt(-1)!=-1 || g->CharAt(reflen)!=-1) {
+		printf("  %s: CharAt OUTSIDE THE TEXT\n",what);
+		return 1;
+	}
+	for(k=0;k<reflen;k+=n) {
+		p=g->GetRange(k,&n);
+		if(n<=0 || k+n>reflen || memcmp(p,ref+k,n)) {
+			printf("  %s: GetRange(%d) WRONG\n",what,k);
+			return 1;
+		}
+	}
+	if(g->GetText(buf,0,reflen)!=reflen || memcmp(buf,ref,reflen)) {
+		printf("  %s: GetText WRONG\n",what);
+		return 1;
+	}
+	if(!g->Lines.Valid || g->Lines.NumLines()!=reflines()) {
+		printf("  %s: %d LINES, EXPECTED %d\n",what,g->Lines.NumLines(),reflines());
+		return 1;
+	}
+	return 0;
+}
+
+static int gapinsert(gGapText *g,int offset,const char *data,int bytes,const char *what)
+{
+	if(!g->DoInsert(offset,data,bytes)) {
+		printf("  %s: INSERT FAILED\n",what);
+		return 1;
+	}
+	refinsert(offset,data,bytes);
+	return gapcheck(g,what);
+}
+
+static int gapdelete(gGapText *g,int offset,int bytes,const char *what)
+{
+	g->DoDelete(offset,bytes);
+	refdelete(offset,bytes);
+	return gapcheck(g,what);
+}
+
+// THE CONTIGUOUS RANGE OF GetText(Start,End) AND WHERE IT LEAVES THE GAP
+static int gaprange(gGapText *g,int start,int end,const char *what)
+{
+	const char *p=g->GetText(start,end);
+
+	if(memcmp(p,ref+start,end-start) || (g->GapStart>start && g->GapStart<end)) {
+		printf("  %s: GetText(%d,%d) WRONG, GAP AT %d\n",what,start,end,g->GapStart);
+		return 1;
+	}
+	return gapcheck(g,what);
+}
+
+static int gaptest()
+{
+	static char big[3*GAPTEXT_GROUP];
+	gGapText g;
+	int k,i,n,o,fail=0;
+
+	printf("gap buffer\n");
+	reflen=0;
+	fail+=gapcheck(&g,"empty");
+	if(g.DoInsert(1,"x",1) || g.DoInsert(-1,"x",1)) {
+		printf("  insert outside the text: ACCEPTED\n");
+		++fail;
+	}
+	g.DoDelete(0,1);
+	g.DoDelete(-1,1);
+	fail+=gapcheck(&g,"edit outside the text");
+
+	fail+=gapinsert(&g,0,"world",5,"insert into empty");
+	fail+=gapinsert(&g,0,"hello ",6,"insert at start");
+	fail+=gapinsert(&g,11,"\n",1,"insert at end");
+	fail+=gapinsert(&g,5,",",1,"insert in the middle");
+
+	// FILL THE GAP EXACTLY, THEN ONE MORE BYTE MUST GROW IT
+	n=g.GapEnd-g.GapStart;
+	for(k=0;k<n;++k) big[k]='a'+k%26;
+	o=g.GapStart;
+	fail+=gapinsert(&g,o,big,n,"insert filling the gap");
+	if(g.GapStart!=g.GapEnd) {
+		printf("  insert filling the gap: GAP LEFT\n");
+		++fail;
+	}
+	n=g.Size;
+	fail+=gapinsert(&g,3,"\r\n",2,"insert into a full buffer");
+	if(g.Size<=n) {
+		printf("  insert into a full buffer: NOT GROWN\n");
+		++fail;
+	}
+	// LARGER THAN THE GROWTH STEP, AWAY FROM THE GAP
+	for(k=0;k<(int)sizeof(big);++k) big[k]=(k%40==39)? '\n':'0'+k%10;
+	fail+=gapinsert(&g,reflen,big,sizeof(big),"insert larger than the gap");
+
+	// MOVE THE GAP TO BOTH ENDS AND BACK, THE TEXT DOESN'T CHANGE
+	g.MoveGap(0);
+	fail+=gapcheck(&g,"gap at start");
+	g.MoveGap(reflen);
+	fail+=gapcheck(&g,"gap at end");
+	g.MoveGap(reflen);
+	fail+=gapcheck(&g,"gap moved to itself");
+	g.MoveGap(reflen/2);
+	fail+=gapcheck(&g,"gap in the middle");
+
+	// CONTIGUOUS RANGES ACROSS, BEFORE, AFTER AND AT THE EDGES OF THE GAP
+	o=g.GapStart;
+	fail+=gaprange(&g,o-10,o+30,"range across the gap, near start");
+	o=g.GapStart;
+	fail+=gaprange(&g,o-30,o+10,"range across the gap, near end");
+	o=g.GapStart;
+	fail+=gaprange(&g,o,o+20,"range starting at the gap");
+	o=g.GapStart;
+	fail+=gaprange(&g,o-20,o,"range ending at the gap");
+	fail+=gaprange(&g,0,reflen,"whole text");
+
+	// DELETE AROUND AND ACROSS THE GAP
+	g.MoveGap(100);
+	fail+=gapdelete(&g,90,20,"delete across the gap");
+	fail+=gapdelete(&g,g.GapStart,5,"delete after the gap");
+	fail+=gapdelete(&g,g.GapStart-5,5,"delete before the gap");
+	fail+=gapdelete(&g,0,3,"delete at start");
+	fail+=gapdelete(&g,reflen-3,3,"delete at end");
+	g.DoDelete(reflen-2,3);
+	g.DoDelete(0,0);
+	fail+=gapcheck(&g,"delete past the end");
+
+	// RANDOM EDITS, SMALL ONES AT THE CURSOR AS WHEN TYPING
+	o=0;
+	for(k=0;k<4000 && !fail;++k) {
+		if(rnd(8)) o=rnd(reflen+1);
+		if(rnd(2) && reflen+40<REF_MAX) {
+			n=1+rnd(8)*rnd(5);
+			for(i=0;i<n;++i) big[i]="ab\r\n"[rnd(4)];
+			fail+=gapinsert(&g,o,big,n,"random insert");
+			o+=n;
+		}
+		else if(reflen) {
+			if(o>=reflen) o=reflen-1;
+			n=1+rnd(4)*rnd(6);
+			if(n>reflen-o) n=reflen-o;
+			fail+=gapdelete(&g,o,n,"random delete");
+		}
+	}
+	fail+=gapdelete(&g,0,reflen,"delete everything");
+	fail+=gapinsert(&g,0,"again",5,"insert after clearing");
+	return fail;
+}
+
+static int lisource(void *Context,int Offset)
+{
+	return (Offset<0 || Offset>=reflen)? -1:(unsigned char)ref[Offset];
+}
+
+// EVERY LOOKUP AT EVERY OFFSET AND LINE MATCHES A SCAN OF ref, AND THE
+// CHUNKS ARE IN ORDER, NOT EMPTY AND NOT OVERFULL
+static int licheck(gLineIndex *li,const char *what)
+{
+	static int starts[REF_MAX+1];
+	int j,k,n,line,prev,next;
+
+	for(k=1,n=1,starts[0]=0;k<=reflen;++k) if(refstart(k)) starts[n++]=k;
+	if(!li->Valid || li->Length!=reflen || li->NumLines()!=n) {
+		printf("  %s: %d LINES, EXPECTED %d\n",what,li->NumLines(),n);
+		return 1;
+	}
+	for(j=0,prev=0;j<li->NumChunks;++j) {
+		if(li->Chunks[j].Count<1 || li->Chunks[j].Count>LINEINDEX_CHUNK) {
+			printf("  %s: CHUNK %d HOLDS %d\n",what,j,li->Chunks[j].Count);
+			return 1;
+		}
+		for(k=0;k<li->Chunks[j].Count;prev=li->Abs(j,k),++k) if(li->Abs(j,k)<=prev) {
+			printf("  %s: CHUNK %d OUT OF ORDER\n",what,j);
+			return 1;
+		}
+	}
+	for(k=0;k<n;++k) if(li->LineStart(k)!=starts[k]) {
+		printf("  %s: LineStart(%d) IS %d, EXPECTED %d\n",what,k,li->LineStart(k),starts[k]);
+		return 1;
+	}
+	if(li->LineStart(n)!=-1 || li->LineStart(-1)!=-1) {
+		printf("  %s: LineStart OUTSIDE THE TEXT\n",what);
+		return 1;
+	}
+	for(k=0,line=0;k<=reflen;++k) {
+		while(line+1<n && starts[line+1]<=k) ++line;
+		next=(line+1<n)? starts[line+1]:-1;
+		prev=(line)? starts[line-1]:-1;
+		if(li->LineOf(k)!=line || li->StartOf(k)!=starts[line] || li->NextStart(k)!=next || li->PrevStart(k)!=prev) {
+			printf("  %s: AT %d LINE %d START %d NEXT %d PREV %d, EXPECTED %d %d %d %d\n",what,k,
+					li->LineOf(k),li->StartOf(k),li->NextStart(k),li->PrevStart(k),line,starts[line],next,prev);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int libuild(gLineIndex *li,const char *text,const char *what)
+{
+	reflen=strlen(text);
+	memcpy(ref,text,reflen);
+	li->Build(reflen);
+	return licheck(li,what);
+}
+
+// n LINES OF "ab\n"
+static int libuildlines(gLineIndex *li,int n,const char *what)
+{
+	int k;
+
+	for(k=0;k<n;++k) memcpy(ref+3*k,"ab\n",3);
+	reflen=3*n;
+	li->Build(reflen);
+	return licheck(li,what);
+}
+
+static int liinsert(gLineIndex *li,int offset,const char *data,const char *what)
+{
+	int n=strlen(data);
+
+	refinsert(offset,data,n);
+	li->Inserted(offset,n);
+	return licheck(li,what);
+}
+
+static int lidelete(gLineIndex *li,int offset,int bytes,const char *what)
+{
+	refdelete(offset,bytes);
+	li->Deleted(offset,bytes);
+	return licheck(li,what);
+}
+
+// DELETE LINE line+1, WHICH DROPS THE START OF line+2 FROM THE INDEX, UNTIL
+// THE NUMBER OF CHUNKS CHANGES OR n TIMES
+static int lijoin(gLineIndex *li,int line,int n,const char *what)
+{
+	int k,c=li->NumChunks,fail=0;
+
+	for(k=0;k<n && li->NumChunks==c && !fail;++k) fail+=lidelete(li,li->LineStart(line+1),3,what);
+	return fail;
+}
+
+static int litest()
+{
+	static char text[64];
+	gLineIndex li(lisource,NULL);
+	int j,k,n,o,fail=0;
+
+	printf("line index\n");
+
+	// FIRST AND LAST LINE, WITH AND WITHOUT A BREAK AT THE END
+	fail+=libuild(&li,"","empty text");
+	fail+=libuild(&li,"abc","one line");
+	fail+=libuild(&li,"abc\n","break at the end");
+	fail+=libuild(&li,"\n","only a break");
+	fail+=libuild(&li,"\r","only a \\r");
+	fail+=libuild(&li,"\r\n","only a \\r\\n");
+	fail+=libuild(&li,"a\rb\r\nc\n\rd","mixed breaks");
+	fail+=liinsert(&li,reflen,"\n","break appended");
+	fail+=liinsert(&li,0,"\n","break at the start");
+	fail+=lidelete(&li,reflen-1,1,"last break deleted");
+	fail+=lidelete(&li,0,1,"first break deleted");
+	fail+=liinsert(&li,2,"\n","\\r\\n made of \\r and \\n");
+	fail+=lidelete(&li,3,1,"\\r\\n split");
+
+	// A BUILD LEAVES THE CHUNKS FULL
+	n=5*LINEINDEX_CHUNK-20;
+	fail+=libuildlines(&li,n,"build");
+	if(li.NumChunks!=(n+LINEINDEX_CHUNK-1)/LINEINDEX_CHUNK) {
+		printf("  build: %d CHUNKS FOR %d LINES\n",li.NumChunks,n);
+		++fail;
+	}
+
+	// A BREAK INTO A FULL CHUNK SPLITS IT
+	k=li.NumChunks;
+	o=li.Abs(1,LINEINDEX_CHUNK/2);
+	fail+=liinsert(&li,o+1,"\n","split");
+	if(li.NumChunks!=k+1) {
+		printf("  split: %d CHUNKS, EXPECTED %d\n",li.NumChunks,k+1);
+		++fail;
+	}
+	// AT THE END OF THE LAST CHUNK ONCE FULL, A NEW ONE IS STARTED
+	while(li.Chunks[li.NumChunks-1].Count<LINEINDEX_CHUNK && !fail) fail+=liinsert(&li,reflen,"ab\n","append");
+	k=li.NumChunks;
+	fail+=liinsert(&li,reflen,"ab\n","append to a full chunk");
+	if(li.NumChunks!=k+1 || li.Chunks[k-1].Count!=LINEINDEX_CHUNK) {
+		printf("  append to a full chunk: NOT KEPT FULL\n");
+		++fail;
+	}
+
+	// EMPTYING MOST OF TWO NEIGHBORS MERGES THEM
+	fail+=libuildlines(&li,5*LINEINDEX_CHUNK,"build for merge");
+	k=li.NumChunks;
+	j=li.LineOf(li.Abs(2,0));
+	fail+=lijoin(&li,j,LINEINDEX_CHUNK-8,"shrink");
+	j=li.LineOf(li.Abs(1,0));
+	fail+=lijoin(&li,j,LINEINDEX_CHUNK,"merge");
+	if(li.NumChunks!=k-1 || li.Chunks[1].Count>LINEINDEX_CHUNK/2) {
+		printf("  merge: %d CHUNKS, EXPECTED %d\n",li.NumChunks,k-1);
+		++fail;
+	}
+
+	// A CHUNK WITH FULL NEIGHBORS IS DROPPED ONCE EMPTY
+	k=li.NumChunks;
+	j=li.LineOf(li.Abs(li.NumChunks-2,0));
+	fail+=lijoin(&li,j-2,LINEINDEX_CHUNK+1,"empty a chunk");
+	if(li.NumChunks!=k-1) {
+		printf("  empty a chunk: %d CHUNKS, EXPECTED %d\n",li.NumChunks,k-1);
+		++fail;
+	}
+
+	// EDITS AT AND ACROSS THE FIRST START OF A CHUNK
+	fail+=libuildlines(&li,4*LINEINDEX_CHUNK,"build for boundaries");
+	o=li.Abs(2,0);
+	fail+=liinsert(&li,o,"x\n","insert at the first start of a chunk");
+	o=li.Abs(2,0);
+	fail+=liinsert(&li,o-1,"y","insert before the first start of a chunk");
+	o=li.Abs(2,0);
+	fail+=lidelete(&li,o-1,1,"delete the break before a chunk");
+	o=li.Abs(2,0);
+	fail+=lidelete(&li,o-5,10,"delete across two chunks");
+	o=li.Abs(1,li.Chunks[1].Count-1);
+	fail+=lidelete(&li,o-2,li.Abs(3,2)-o+4,"delete across three chunks");
+	o=li.Abs(li.NumChunks-1,0);
+	fail+=liinsert(&li,o,"\r","\\r before the first start of the last chunk");
+
+	// RANDOM EDITS NEAR CHUNK BOUNDARIES, WITH SHIFTS STILL PENDING
+	for(k=0;k<3000 && !fail;++k) {
+		if(li.NumChunks && rnd(2)) {
+			j=rnd(li.NumChunks);
+			o=li.Abs(j,0)+rnd(5)-2;
+			if(o<0) o=0;
+			if(o>reflen) o=reflen;
+		}
+		else o=rnd(reflen+1);
+		if(rnd(2) && reflen+32<REF_MAX) {
+			n=1+rnd(4)*rnd(8);
+			for(j=0;j<n;++j) text[j]="ab\r\n"[rnd(4)];
+			text[n]=0;
+			fail+=liinsert(&li,o,text,"random insert");
+		}
+		else if(reflen) {
+			if(o>=reflen) o=reflen-1;
+			n=1+rnd(4)*rnd(10);
+			if(n>reflen-o) n=reflen-o;
+			fail+=lidelete(&li,o,n,"random delete");
+		}
+	}
+	return fail;
+}
+
+#define RG_W 64
+#define RG_H 48
+
+// THE RECTANGLES ARE VALID, DISJOINT AND NO MORE THAN GREGION_MAXRECTS, AND
+// COVER EVERY PIXEL SET IN damaged
+static int rgcheck(gRegion *r,unsigned char damaged[RG_H][RG_W],const char *what)
+{
+	gUpdate *a,*b;
+	int j,k,x,y;
+
+	if(r->NumRects<0 || r->NumRects>GREGION_MAXRECTS) {
+		printf("  %s: %d RECTANGLES\n",what,r->NumRects);
+		return 1;
+	}
+	for(j=0;j<r->NumRects;++j) {
+		a=&r->Rects[j];
+		if(a->clipx>a->clipx2 || a->clipy>a->clipy2) {
+			printf("  %s: EMPTY RECTANGLE %d\n",what,j);
+			return 1;
+		}
+		for(k=0;k<j;++k) {
+			b=&r->Rects[k];
+			if(a->clipx<=b->clipx2 && b->clipx<=a->clipx2 && a->clipy<=b->clipy2 && b->clipy<=a->clipy2) {
+				printf("  %s: RECTANGLES %d AND %d OVERLAP\n",what,k,j);
+				return 1;
+			}
+		}
+	}
+	for(y=0;y<RG_H;++y) {
+		for(x=0;x<RG_W;++x) {
+			if(!damaged[y][x]) continue;
+			for(j=0;j<r->NumRects;++j) {
+				a=&r->Rects[j];
+				if(x>=a->clipx && x<=a->clipx2 && y>=a->clipy && y<=a->clipy2) break;
+			}
+			if(j==r->NumRects) {
+				printf("  %s: PIXEL %d,%d NOT COVERED\n",what,x,y);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+// RANDOM SEQUENCES OF RECTANGLES, MOSTLY SMALL ONES AS FROM TEXT AND
+// CURSORS, SOME LARGE ENOUGH TO CUT OR ABSORB THE OTHERS
+static int rgtest()
+{
+	static unsigned char damaged[RG_H][RG_W];
+	gRegion r;
+	int t,k,n,x,y,w,h,i,j,fail=0;
+
+	printf("damage region\n");
+	for(t=0;t<20000 && !fail;++t) {
+		r.Clear();
+		memset(damaged,0,sizeof(damaged));
+		n=1+rnd(16);
+		for(k=0;k<n && !fail;++k) {
+			w=(rnd(4))? 1+rnd(8):1+rnd(RG_W);
+			h=(rnd(4))? 1+rnd(8):1+rnd(RG_H);
+			x=rnd(RG_W-w+1);
+			y=rnd(RG_H-h+1);
+			r.Add(x,y,x+w-1,y+h-1);
+			for(j=y;j<y+h;++j) for(i=x;i<x+w;++i) damaged[j][i]=1;
+			fail+=rgcheck(&r,damaged,"add");
+		}
+	}
+	// AN EMPTY RECTANGLE ADDS NOTHING
+	r.Clear();
+	r.Add(5,5,4,9);
+	r.Add(5,5,9,4);
+	if(!r.IsEmpty()) {
+		printf("  empty rectangle: ADDED\n");
+		++fail;
+	}
+	return fail;
+}
+
+static void report(const char *name,int n,double t)
+{
+	printf("  %-36s %10.2f Mops/s\n",name,n/t/1e6);
+}
+
+static void textthroughput()
+{
+	gGapText g;
+	char *buf;
+	double t0;
+	int k,n=200000;
+
+	buf=(char *)malloc(n);
+	for(k=0;k<n;++k) buf[k]=(k%33==32)? '\n':'a'+k%26;
+	g.Insert(0,buf,n);
+
+	t0=now();
+	for(k=0;k<n;++k) g.Insert(n/2+k,buf+k,1);
+	report("type gGapText::Insert",n,now()-t0);
+
+	t0=now();
+	for(k=0;k<n;++k) g.Lines.LineOf((int)((unsigned)k*7919U%(unsigned)g.Length()));
+	report("lookup gLineIndex::LineOf",n,now()-t0);
+
+	free(buf);
+}
+
+
+int main()
+{
+	int fail=0;
+
+	fail+=gaptest();
+	fail+=litest();
+	fail+=rgtest();
+
+	printf("throughput, 200K characters\n");
+	textthroughput();
+
+	printf((fail)? "FAILED\n":"PASSED\n");
+	return (fail)? 1:0;
+}
@@ -0,0 +1,401 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+// HOST-SIDE GOLDEN IMAGE AND THROUGHPUT BENCHMARK FOR THE HPG MODULES AND
+// THE GGL/HPG BRIDGE, OVER THE IN-MEMORY FRAMEBUFFER OF hpg/hpghost.c
+// EACH SCENE IS COMPARED WITH bench/golden/<name>.pgm, A MISMATCHING SCENE
+// IS WRITTEN TO host/<name>.pgm FOR INSPECTION. 'make golden' (OPTION -u)
+// REWRITES THE GOLDEN IMAGES AFTER AN INTENDED CHANGE OF THE OUTPUT
+// THE THROUGHPUT LINES ONLY TIME ADD-ON CODE, NEVER THE HOST STAND-INS OF
+// THE PREBUILT LIBRARIES, WHICH SAY NOTHING ABOUT THE CALCULATOR
+// BUILD AND RUN WITH 'make bench'
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <ggl.h>
+#include <hpgraphics.h>
+
+#define GOLDEN_DIR "bench/golden/"
+#define FAILED_DIR "host/"
+
+static int update=0;
+
+static double now()
+{
+	return (double)clock()/CLOCKS_PER_SEC;
+}
+
+// THE SCENES MUST NOT DEPEND ON THE rand() OF THE HOST C LIBRARY
+static unsigned seed=1234;
+
+static int rnd(int n)
+{
+	seed=seed*1103515245U+12345U;
+	return (int)((seed>>16)%(unsigned)n);
+}
+
+static int getnib(int *buf,int off)
+{
+	return (((unsigned *)buf)[off>>3]>>((off&7)<<2))&0xf;
+}
+
+static void putnib(int *buf,int off,int color)
+{
+	unsigned *p=((unsigned *)buf)+(off>>3);
+	int sh=(off&7)<<2;
+	*p=(*p&~(0xfU<<sh))|((unsigned)color<<sh);
+}
+
+
+// GOLDEN IMAGES, BINARY PGM, 0=BLACK
+static int pgmwrite(const char *path,int w,int h,const unsigned char *pix)
+{
+	FILE *f=fopen(path,"wb");
+	if(!f) return 0;
+	fprintf(f,"P5\n%d %d\n255\n",w,h);
+	fwrite(pix,1,w*h,f);
+	fclose(f);
+	return 1;
+}
+
+static unsigned char *pgmread(const char *path,int *w,int *h)
+{
+	FILE *f=fopen(path,"rb");
+	unsigned char *pix;
+	int max;
+
+	if(!f) return NULL;
+	if(fscanf(f,"P5 %d %d %d",w,h,&max)!=3 || max!=255 || fgetc(f)==EOF) {
+		fclose(f);
+		return NULL;
+	}
+	pix=(unsigned char *)malloc((*w)*(*h));
+	if(pix && (int)fread(pix,1,(*w)*(*h),f)!=(*w)*(*h)) {
+		free(pix);
+		pix=NULL;
+	}
+	fclose(f);
+	return pix;
+}
+
+static int golden(const char *name,int w,int h,const unsigned char *pix)
+{
+	char path[256];
+	unsigned char *ref;
+	int gw,gh,k,diff;
+
+	printf("golden image, %s\n",name);
+	sprintf(path,GOLDEN_DIR "%s.pgm",name);
+	ref=(update)? NULL:pgmread(path,&gw,&gh);
+	if(!ref) {
+		if(!pgmwrite(path,w,h,pix)) {
+			printf("  CAN'T WRITE %s\n",path);
+			return 1;
+		}
+		printf("  written %s\n",path);
+		return 0;
+	}
+	if(gw!=w || gh!=h) diff=w*h;
+	else for(k=diff=0;k<w*h;++k) if(ref[k]!=pix[k]) ++diff;
+	free(ref);
+	if(!diff) return 0;
+	sprintf(path,FAILED_DIR "%s.pgm",name);
+	pgmwrite(path,w,h,pix);
+	printf("  MISMATCH %d pixels, see %s\n",diff,path);
+	return 1;
+}
+
+static int goldensurface(const char *name,gglsurface *srf,int w,int h)
+{
+	static unsigned char pix[LCD_W*LCD_H];
+	int x,y;
+
+	for(y=0;y<h;++y) for(x=0;x<w;++x) pix[y*w+x]=255-17*getnib(srf->addr,(srf->y+y)*srf->width+srf->x+x);
+	return golden(name,w,h,pix);
+}
+
+static int goldenimage(const char *name,hpg_t *img)
+{
+	static unsigned char pix[LCD_W*LCD_H];
+	int x,y,w=hpg_get_width(img),h=hpg_get_height(img);
+
+	for(y=0;y<h;++y) for(x=0;x<w;++x) pix[y*w+x]=255-hpg_get_pixel(img,x,y);
+	return golden(name,w,h,pix);
+}
+
+
+// SCENES
+
+static int plotfunc(double x,double *y,void *arg)
+{
+	if(fabs(x)<0.05) return 0;		// POLE AT 0
+	*y=sin(x*3)/x;
+	return 1;
+}
+
+static void gradient(gglsurface *s,int w,int h)
+{
+	int x,y;
+	for(y=0;y<h;++y) for(x=0;x<w;++x) putnib(s->addr,(s->y+y)*s->width+s->x+x,((x+y)>>3)&15);
+}
+
+static int gglscene()
+{
+	static int buf[SCREENBUFSIZE/4];
+	static int star[]={ 40,2, 50,30, 78,30, 55,46, 64,76, 40,58, 16,76, 25,46, 2,30, 30,30 };
+	static int zigzag[2*20];
+	gglsurface s,d;
+	int k;
+
+	s.addr=buf; s.width=LCD_W; s.x=s.y=0;
+	memset(buf,0,sizeof(buf));
+	for(k=0;k<16;++k) ggl_rect(&s,k*10,0,k*10+9,11,ggl_mkcolor(k));
+	ggl_fillpoly(&s,star,10,ggl_mkcolor(12));
+	ggl_fillellipse(&s,120,46,30,18,ggl_mkcolor(6));
+	for(k=0;k<8;++k) ggl_hline(&s,58+k,84+k,156-k,ggl_mkcolor(15-k));
+	for(k=0;k<20;++k) {
+		zigzag[2*k]=82+k*4;
+		zigzag[2*k+1]=(k&1)? 20:34;
+	}
+	ggl_apolyline(&s,zigzag,20,15);
+	ggl_hpgtext(&s,hpg_get_minifont(),"HPGCC3 golden\nGGL+HPG",84,68,ggl_mkcolor(15));
+
+	// COPY AND SCROLL, PARTLY OVERLAPPING
+	d=s;
+	d.x=3; d.y=14;
+	s.x=0; s.y=0;
+	ggl_fastblt(&d,&s,40,12);
+	d.x=100; d.y=0;
+	s.x=103; s.y=0;
+	ggl_fastovlblt(&d,&s,57,12);
+	s.x=s.y=0;
+	return goldensurface("gglscene",&s,LCD_W,LCD_H);
+}
+
+static int hpgscene()
+{
+	static int vx[]={ 10,40,40,10, 40,64,56,40 },vy[]={ 10,4,50,44, 4,20,60,50 },lens[]={ 4,4 };
+	static char checker[]={ 0x55,0xaa };
+	static int gbuf[(48*24)/8];
+	static int sine[2*64];
+	hpg_t *img,*plot;
+	hpg_pattern_t *pat;
+	hpg_plot_t *p;
+	gglsurface s;
+	int k,fail;
+
+	img=hpg_alloc_gray16_image(131,80);
+	hpg_clear_on(img);
+
+	// ADJACENT POLYGONS IN XOR MODE, THE SHARED EDGE IS DRAWN ONCE
+	hpg_set_mode(img,HPG_MODE_XOR);
+	hpg_set_color(img,HPG_COLOR_GRAY_8);
+	hpg_fill_polygons_on(img,vx,vy,lens,2);
+	hpg_set_mode(img,HPG_MODE_PAINT);
+
+	pat=hpg_alloc_pattern(checker,2,0);
+	hpg_set_pattern(img,pat);
+	hpg_set_color(img,HPG_COLOR_BLACK);
+	hpg_fill_rect_on(img,66,4,96,20);
+	hpg_set_pattern(img,NULL);
+
+	hpg_set_font(img,hpg_get_bigfont());
+	hpg_draw_text_fast_on(img,"HPG golden",66,24);
+	hpg_set_font(img,hpg_get_minifont());
+	hpg_draw_text_fast_on(img,"fast text\nsecond line",66,34);
+
+	s.addr=gbuf; s.width=48; s.x=s.y=0;
+	gradient(&s,48,24);
+	ggl_blthpg(img,80,48,&s,48,24,0);
+
+	p=hpg_alloc_plot(60,30,4,&plotfunc,NULL);
+	hpg_plot_set_view(p,-4.0,3.0,8.0/60,6.0/30);
+	while(hpg_plot_update(p,7)) ;
+	hpg_plot_pan(p,5,0);
+	while(hpg_plot_update(p,7)) ;
+	plot=hpg_plot_get_image(p);
+	hpg_blit(plot,0,0,60,30,img,4,48);
+
+	// XOR POLYLINE OVER THE PLOT AND THE GRADIENT
+	for(k=0;k<64;++k) {
+		sine[2*k]=k*2;
+		sine[2*k+1]=62+(int)(12*sin(k*0.3));
+	}
+	hpg_set_mode(img,HPG_MODE_XOR);
+	hpg_draw_lines_on(img,sine,64,HPG_LINES_STRIP);
+	hpg_set_mode(img,HPG_MODE_PAINT);
+
+	fail=goldenimage("hpgscene",img);
+	hpg_free_plot(p);
+	hpg_free_pattern(pat);
+	hpg_free_image(img);
+	return fail;
+}
+
+static int convscene()
+{
+	static int gbuf[(131*80+7)/8];
+	hpg_t *gray,*mono,*gray4;
+	gglsurface s;
+	int fail;
+
+	s.addr=gbuf; s.width=131; s.x=s.y=0;
+	gradient(&s,131,80);
+	gray=hpg_alloc_gray16_image(131,80);
+	mono=hpg_alloc_mono_image(131,80);
+	gray4=hpg_alloc_gray4_image(131,80);
+	ggl_blthpg(gray,0,0,&s,131,80,0);
+	hpg_blit_convert(gray,0,0,131,80,mono,0,0,HPG_BLIT_DITHER_MONO);
+	hpg_blit_convert(gray,0,0,131,80,gray4,0,0,HPG_BLIT_DITHER_GRAY4);
+
+	fail=goldenimage("convmono",mono);
+	fail+=goldenimage("convgray4",gray4);
+	hpg_free_image(gray4);
+	hpg_free_image(mono);
+	hpg_free_image(gray);
+	return fail;
+}
+
+
+// THROUGHPUT, PIXELS WRITTEN PER SECOND
+// ggl_hline, ggl_rect AND hpg_fill_rect_on ARE PART OF THE PREBUILT
+// LIBRARIES, ON THE HOST THEY MEASURE THE STAND-INS
+
+static void report(const char *name,double pixels,int n,double t)
+{
+	printf("  %-36s %10.2f Mpix/s\n",name,pixels*n/t/1e6);
+}
+
+static void gglthroughput()
+{
+	static int buf[SCREENBUFSIZE/4],src[SCREENBUFSIZE/4];
+	static int star[]={ 80,2, 100,30, 156,30, 110,46, 128,78, 80,58, 32,78, 50,46, 4,30, 60,30 };
+	gglsurface s,d;
+	double t0;
+	int k,n=2000,area;
+
+	s.addr=src; s.width=LCD_W; s.x=s.y=0;
+	d.addr=buf; d.width=LCD_W; d.x=d.y=0;
+	for(k=0;k<SCREENBUFSIZE/4;++k) src[k]=(int)((unsigned)rnd(65536)<<16|(unsigned)rnd(65536));
+
+	d.x=3;
+	t0=now();
+	for(k=0;k<n;++k) ggl_fastblt(&d,&s,LCD_W-8,LCD_H);
+	report("bitblt ggl_fastblt",(LCD_W-8)*LCD_H,n,now()-t0);
+	d.x=0;
+
+	// AREA OF THE STAR, COUNTED ON A CLEARED SURFACE
+	memset(buf,0,sizeof(buf));
+	ggl_fillpoly(&d,star,10,ggl_mkcolor(15));
+	for(k=area=0;k<LCD_W*LCD_H;++k) if(getnib(buf,k)) ++area;
+	t0=now();
+	for(k=0;k<n;++k) ggl_fillpoly(&d,star,10,k);
+	report("polygon fill ggl_fillpoly",area,n,now()-t0);
+
+	t0=now();
+	for(k=0;k<n;++k) ggl_hpgtext(&d,hpg_get_minifont(),"The quick brown fox jumps over",0,k%(LCD_H-6),ggl_mkcolor(15));
+	report("text ggl_hpgtext",30*4*6,n,now()-t0);
+
+	// ONE ROW UP, THE OVERLAPPING CASE OF A SCROLL
+	s=d;
+	s.y=1;
+	t0=now();
+	for(k=0;k<n;++k) ggl_fastovlblt(&d,&s,LCD_W,LCD_H-1);
+	report("scroll ggl_fastovlblt",LCD_W*(LCD_H-1),n,now()-t0);
+}
+
+static void hpgthroughput()
+{
+	static int vx[]={ 65,85,130,90,105,65,25,40,0,45 },vy[]={ 2,30,30,46,78,58,78,46,30,30 },lens[]={ 10 };
+	static int gbuf[SCREENBUFSIZE/4];
+	static int pts[2*131];
+	hpg_t *img,*mono;
+	hpg_plot_t *p;
+	gglsurface s;
+	double t0;
+	int k,x,y,n=500,area;
+
+	img=hpg_alloc_gray16_image(131,80);
+	s.addr=gbuf; s.width=131; s.x=s.y=0;
+	gradient(&s,131,80);
+
+	t0=now();
+	for(k=0;k<n;++k) ggl_blthpg(img,0,0,&s,131,80,0);
+	report("bitblt ggl_blthpg",131*80,n,now()-t0);
+
+	// FROM A MONO SOURCE
+	mono=hpg_alloc_mono_image(131,80);
+	hpg_blit_convert(img,0,0,131,80,mono,0,0,HPG_BLIT_DITHER_MONO);
+	t0=now();
+	for(k=0;k<n;++k) hpg_blit_convert(mono,0,0,131,80,img,0,0,0);
+	report("convert hpg_blit_convert",131*80,n,now()-t0);
+	hpg_free_image(mono);
+
+	hpg_clear_on(img);
+	hpg_set_color(img,HPG_COLOR_BLACK);
+	hpg_fill_polygons_on(img,vx,vy,lens,1);
+	for(y=area=0;y<80;++y) for(x=0;x<131;++x) if(hpg_get_pixel(img,x,y)) ++area;
+	t0=now();
+	for(k=0;k<n;++k) hpg_fill_polygons_on(img,vx,vy,lens,1);
+	report("polygon fill hpg_fill_polygons_on",area,n,now()-t0);
+
+	t0=now();
+	for(k=0;k<n;++k) hpg_draw_text_fast_on(img,"The quick brown fox jumps over",0,k%74);
+	report("text hpg_draw_text_fast_on",30*4*6,n,now()-t0);
+
+	for(k=0;k<131;++k) {
+		pts[2*k]=k;
+		pts[2*k+1]=40+(int)(39*sin(k*0.1));
+	}
+	hpg_clear_on(img);
+	hpg_draw_lines_on(img,pts,131,HPG_LINES_STRIP);
+	for(y=area=0;y<80;++y) for(x=0;x<131;++x) if(hpg_get_pixel(img,x,y)) ++area;
+	t0=now();
+	for(k=0;k<n;++k) hpg_draw_lines_on(img,pts,131,HPG_LINES_STRIP);
+	report("lines hpg_draw_lines_on",area,n,now()-t0);
+
+	// ONE COLUMN PER FRAME, PAN AND RESAMPLE
+	p=hpg_alloc_plot(131,80,4,&plotfunc,NULL);
+	while(hpg_plot_update(p,131)) ;
+	t0=now();
+	for(k=0;k<n;++k) {
+		hpg_plot_pan(p,1,0);
+		hpg_plot_update(p,131);
+	}
+	report("scroll hpg_plot_pan",131*80,n,now()-t0);
+
+	hpg_free_plot(p);
+	hpg_free_image(img);
+}
+
+
+int main(int argc,char *argv[])
+{
+	int fail=0;
+
+	if(argc>1 && !strcmp(argv[1],"-u")) update=1;
+
+	fail+=gglscene();
+	fail+=hpgscene();
+	fail+=convscene();
+
+	printf("throughput, GGL %dx%d gray16\n",LCD_W,LCD_H);
+	gglthroughput();
+	printf("throughput, HPG 131x80 gray16\n");
+	hpgthroughput();
+
+	if(hpg_pool_reset()) {
+		printf("  POOL IMAGES STILL IN USE\n");
+		++fail;
+	}
+	printf((fail)? "FAILED\n":"PASSED\n");
+	return (fail)? 1:0;
+}
@@ -0,0 +1,108 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <ggl.h>
+
+// ANTIALIASED POLYLINES, WU'S ALGORITHM
+// ALL STATE IS LOCAL TO THE CALL: THE BLENDING TABLE IS BUILT ONCE PER
+// POLYLINE AND EACH SEGMENT ONLY NEEDS ONE DIVISION FOR ITS 16.16 SLOPE
+// THE FIRST PIXEL OF EVERY SEGMENT AFTER THE FIRST IS THE LAST PIXEL OF THE
+// PREVIOUS ONE, SO IT'S SKIPPED TO AVOID BLENDING THE JOINT TWICE
+
+// STATE SHARED BY ALL SEGMENTS OF A POLYLINE: THE SURFACE AND THE BLENDING
+// TABLE. THE 16.16 STEPPING (pos, grad) IS SET UP AGAIN FOR EACH SEGMENT, AS
+// EVERY SEGMENT HAS ITS OWN SLOPE AND MAJOR AXIS
+typedef struct {
+	unsigned *addr;
+	int width;
+	unsigned char blend[17][16];	// blend[COVERAGE 0-16][OLD PIXEL]=NEW PIXEL
+} gglapoly;
+
+static inline void apoly_plot(gglapoly *st,int x,int y,int cov)
+{
+	int off=y*st->width+x;
+	unsigned *p=st->addr+(off>>3);
+	int sh=(off&7)<<2;
+	*p=(*p&~(0xfU<<sh))|((unsigned)st->blend[cov][(*p>>sh)&0xf]<<sh);
+}
+
+// DRAW (x1,y1)-(x2,y2), OMITTING THE (x1,y1) PIXEL IF skipfirst
+static void apoly_segment(gglapoly *st,int x1,int y1,int x2,int y2,int skipfirst)
+{
+	int dx=x2-x1,dy=y2-y1,t,n,f,pos,grad;
+	int skipstart=skipfirst,skipend=0;
+
+	if(!dx && !dy) {
+		if(!skipfirst) apoly_plot(st,x1,y1,16);
+		return;
+	}
+
+	if((dx<0? -dx:dx)>=(dy<0? -dy:dy)) {
+		// X-MAJOR, ALWAYS STEP LEFT TO RIGHT
+		if(dx<0) {
+			t=x1; x1=x2; x2=t;
+			t=y1; y1=y2; y2=t;
+			dx=-dx; dy=-dy;
+			skipstart=0; skipend=skipfirst;
+		}
+		grad=dy*65536/dx;
+		pos=y1*65536+0x800;		// ROUND THE COVERAGE TO THE NEAREST 1/16
+		n=dx+1;
+		if(skipstart) { ++x1; pos+=grad; --n; }
+		if(skipend) --n;
+		while(n--) {
+			f=(pos>>12)&0xf;
+			apoly_plot(st,x1,pos>>16,16-f);
+			if(f) apoly_plot(st,x1,(pos>>16)+1,f);
+			++x1;
+			pos+=grad;
+		}
+	}
+	else {
+		// Y-MAJOR, ALWAYS STEP TOP TO BOTTOM
+		if(dy<0) {
+			t=x1; x1=x2; x2=t;
+			t=y1; y1=y2; y2=t;
+			dx=-dx; dy=-dy;
+			skipstart=0; skipend=skipfirst;
+		}
+		grad=dx*65536/dy;
+		pos=x1*65536+0x800;
+		n=dy+1;
+		if(skipstart) { ++y1; pos+=grad; --n; }
+		if(skipend) --n;
+		while(n--) {
+			f=(pos>>12)&0xf;
+			apoly_plot(st,pos>>16,y1,16-f);
+			if(f) apoly_plot(st,(pos>>16)+1,y1,f);
+			++y1;
+			pos+=grad;
+		}
+	}
+}
+
+void ggl_apolyline(gglsurface *srf,int *pts,int npoints,int color)
+{
+	gglapoly st;
+	int c,p,k;
+
+	if(npoints<1) return;
+
+	st.addr=(unsigned *)srf->addr;
+	st.width=srf->width;
+	color&=0xf;
+	for(c=0;c<=16;++c)
+		for(p=0;p<16;++p) st.blend[c][p]=(unsigned char)(p+(((color-p)*c)>>4));
+
+	if(npoints==1) {
+		apoly_segment(&st,pts[0],pts[1],pts[0],pts[1],0);
+		return;
+	}
+
+	for(k=1;k<npoints;++k,pts+=2) apoly_segment(&st,pts[0],pts[1],pts[2],pts[3],k>1);
+}
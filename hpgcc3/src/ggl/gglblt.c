@@ -0,0 +1,223 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <ggl.h>
+#include "gglpriv.h"
+
+// SHIFT-SPECIALIZED BLITTERS
+// ONE ROW KERNEL IS GENERATED FOR EACH OF THE 8 POSSIBLE NIBBLE SHIFTS
+// BETWEEN SOURCE AND DESTINATION, SO ALL SHIFTS ARE IMMEDIATE OPERANDS
+// (FREE IN THE ARM BARREL SHIFTER) INSTEAD OF REGISTER SHIFTS.
+// EDGE WORDS ARE HANDLED ONCE PER ROW WITH PRECOMPUTED MASKS.
+
+
+// ALIGNED CASE: PLAIN WORD COPY
+static void ggl_fwd0(unsigned *d,const unsigned *s,int n)
+{
+	while(n>=4) {
+		d[0]=s[0];
+		d[1]=s[1];
+		d[2]=s[2];
+		d[3]=s[3];
+		d+=4; s+=4; n-=4;
+	}
+	while(n--) *d++=*s++;
+}
+
+static void ggl_rev0(unsigned *d,const unsigned *s,int n)
+{
+	d+=n; s+=n;
+	while(n>=4) {
+		d[-1]=s[-1];
+		d[-2]=s[-2];
+		d[-3]=s[-3];
+		d[-4]=s[-4];
+		d-=4; s-=4; n-=4;
+	}
+	while(n--) *--d=*--s;
+}
+
+// SHIFTED CASES: EACH DESTINATION WORD IS BUILT FROM TWO SOURCE WORDS
+// THE PREVIOUS SOURCE WORD IS CARRIED IN A REGISTER, SO EVERY SOURCE WORD
+// IS READ ONCE AND BEFORE ANY OVERLAPPING DESTINATION WORD IS WRITTEN
+
+#define GGL_FWDKERNEL(r) \
+static void ggl_fwd##r(unsigned *d,const unsigned *s,int n) \
+{ \
+	unsigned a=*s++,b; \
+	while(n>=4) { \
+		b=s[0]; d[0]=(a>>GGL_SHR(r))|(b<<GGL_SHL(r)); \
+		a=s[1]; d[1]=(b>>GGL_SHR(r))|(a<<GGL_SHL(r)); \
+		b=s[2]; d[2]=(a>>GGL_SHR(r))|(b<<GGL_SHL(r)); \
+		a=s[3]; d[3]=(b>>GGL_SHR(r))|(a<<GGL_SHL(r)); \
+		d+=4; s+=4; n-=4; \
+	} \
+	while(n--) { \
+		b=*s++; *d++=(a>>GGL_SHR(r))|(b<<GGL_SHL(r)); \
+		a=b; \
+	} \
+}
+
+#define GGL_REVKERNEL(r) \
+static void ggl_rev##r(unsigned *d,const unsigned *s,int n) \
+{ \
+	unsigned a,b=s[n]; \
+	d+=n; s+=n; \
+	while(n>=4) { \
+		a=s[-1]; d[-1]=(a>>GGL_SHR(r))|(b<<GGL_SHL(r)); \
+		b=s[-2]; d[-2]=(b>>GGL_SHR(r))|(a<<GGL_SHL(r)); \
+		a=s[-3]; d[-3]=(a>>GGL_SHR(r))|(b<<GGL_SHL(r)); \
+		b=s[-4]; d[-4]=(b>>GGL_SHR(r))|(a<<GGL_SHL(r)); \
+		d-=4; s-=4; n-=4; \
+	} \
+	while(n--) { \
+		a=*--s; *--d=(a>>GGL_SHR(r))|(b<<GGL_SHL(r)); \
+		b=a; \
+	} \
+}
+
+GGL_FWDKERNEL(1)
+GGL_FWDKERNEL(2)
+GGL_FWDKERNEL(3)
+GGL_FWDKERNEL(4)
+GGL_FWDKERNEL(5)
+GGL_FWDKERNEL(6)
+GGL_FWDKERNEL(7)
+
+GGL_REVKERNEL(1)
+GGL_REVKERNEL(2)
+GGL_REVKERNEL(3)
+GGL_REVKERNEL(4)
+GGL_REVKERNEL(5)
+GGL_REVKERNEL(6)
+GGL_REVKERNEL(7)
+
+const gglrowfn __ggl_fwdrow[8]={ &ggl_fwd0,&ggl_fwd1,&ggl_fwd2,&ggl_fwd3,&ggl_fwd4,&ggl_fwd5,&ggl_fwd6,&ggl_fwd7 };
+const gglrowfn __ggl_revrow[8]={ &ggl_rev0,&ggl_rev1,&ggl_rev2,&ggl_rev3,&ggl_rev4,&ggl_rev5,&ggl_rev6,&ggl_rev7 };
+
+
+void __ggl_mkplan(gglbltplan *p,int doff,int soff,int npixels)
+{
+	int dn=doff&7;
+
+	if(dn+npixels<=8) {
+		// EVERYTHING FITS IN A SINGLE DESTINATION WORD
+		p->lcnt=npixels;
+		p->lshift=dn;
+		p->lmask=__ggl_nibmask(dn,dn+npixels);
+		p->nmid=p->rcnt=0;
+		p->rmask=0;
+		p->kernel=0;
+		return;
+	}
+
+	p->lcnt=(dn)? 8-dn:0;
+	p->lshift=dn;
+	p->lmask=__ggl_nibmask(dn,8);
+	npixels-=p->lcnt;
+	p->nmid=npixels>>3;
+	p->rcnt=npixels&7;
+	p->rmask=(p->rcnt)? __ggl_nibmask(0,p->rcnt):0;
+	p->kernel=(soff+p->lcnt)&7;
+}
+
+void __ggl_planrow(gglbltplan *p,int *dest,int doff,int *src,int soff)
+{
+	unsigned *d=((unsigned *)dest)+(doff>>3);
+
+	if(p->lcnt) {
+		__ggl_putmasked(d,__ggl_getnibs(src,soff,p->lcnt)<<(p->lshift<<2),p->lmask);
+		++d;
+		soff+=p->lcnt;
+	}
+	if(p->nmid) {
+		(__ggl_fwdrow[p->kernel])(d,((unsigned *)src)+(soff>>3),p->nmid);
+		d+=p->nmid;
+		soff+=p->nmid<<3;
+	}
+	if(p->rcnt) __ggl_putmasked(d,__ggl_getnibs(src,soff,p->rcnt),p->rmask);
+}
+
+void __ggl_planrevrow(gglbltplan *p,int *dest,int doff,int *src,int soff)
+{
+	unsigned *d=((unsigned *)dest)+(doff>>3);
+	int moff=soff+p->lcnt;
+
+	if(p->lcnt) ++d;
+	if(p->rcnt) __ggl_putmasked(d+p->nmid,__ggl_getnibs(src,moff+(p->nmid<<3),p->rcnt),p->rmask);
+	if(p->nmid) (__ggl_revrow[p->kernel])(d,((unsigned *)src)+(moff>>3),p->nmid);
+	if(p->lcnt) __ggl_putmasked(d-1,__ggl_getnibs(src,soff,p->lcnt)<<(p->lshift<<2),p->lmask);
+}
+
+
+void ggl_fastblt(gglsurface *dest,gglsurface *src,int width, int height)
+{
+	gglbltplan plan;
+	int doff,soff;
+
+	if(width<=0 || height<=0) return;
+
+	doff=dest->y*dest->width+dest->x;
+	soff=src->y*src->width+src->x;
+
+	if(!((dest->width|src->width)&7)) {
+		// ALL ROWS SHARE THE SAME ALIGNMENT, PICK THE KERNEL ONCE
+		__ggl_mkplan(&plan,doff,soff,width);
+		while(height--) {
+			__ggl_planrow(&plan,dest->addr,doff,src->addr,soff);
+			doff+=dest->width;
+			soff+=src->width;
+		}
+		return;
+	}
+
+	while(height--) {
+		__ggl_mkplan(&plan,doff,soff,width);
+		__ggl_planrow(&plan,dest->addr,doff,src->addr,soff);
+		doff+=dest->width;
+		soff+=src->width;
+	}
+}
+
+void ggl_fastrevblt(gglsurface *dest,gglsurface *src,int width, int height)
+{
+	gglbltplan plan;
+	int doff,soff;
+
+	if(width<=0 || height<=0) return;
+
+	doff=(dest->y+height-1)*dest->width+dest->x;
+	soff=(src->y+height-1)*src->width+src->x;
+
+	if(!((dest->width|src->width)&7)) {
+		__ggl_mkplan(&plan,doff,soff,width);
+		while(height--) {
+			__ggl_planrevrow(&plan,dest->addr,doff,src->addr,soff);
+			doff-=dest->width;
+			soff-=src->width;
+		}
+		return;
+	}
+
+	while(height--) {
+		__ggl_mkplan(&plan,doff,soff,width);
+		__ggl_planrevrow(&plan,dest->addr,doff,src->addr,soff);
+		doff-=dest->width;
+		soff-=src->width;
+	}
+}
+
+void ggl_fastovlblt(gglsurface *dest,gglsurface *src,int width, int height)
+{
+	// COMPARE ABSOLUTE NIBBLE ADDRESSES OF THE FIRST PIXEL OF EACH REGION
+	int delta=(((char *)dest->addr)-((char *)src->addr))*2
+			+(dest->y*dest->width+dest->x)-(src->y*src->width+src->x);
+
+	if(delta>0) ggl_fastrevblt(dest,src,width,height);
+	else ggl_fastblt(dest,src,width,height);
+}
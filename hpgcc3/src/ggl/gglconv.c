@@ -0,0 +1,159 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <ggl.h>
+
+// DEPTH CONVERSION BETWEEN GRAY16 SURFACES AND PACKED 1 AND 2 BPP BITMAPS
+// PIXELS ARE CONVERTED 8 AT A TIME THROUGH LOOKUP TABLES: ONE SOURCE BYTE
+// (8 MONO OR 4 GRAY4 PIXELS) EXPANDS TO 8 OR 4 GRAY16 NIBBLES, AND ONE GRAY16
+// BYTE (2 PIXELS) REDUCES TO 2 OR 4 BITS. GROUPS OF 8 ARE READ AND WRITTEN
+// WITH ONE SHIFTED ACCESS TO AT MOST TWO WORDS ON EACH SIDE, SO NO ALIGNMENT
+// IS NEEDED ON EITHER SURFACE
+
+// ORDERED DITHER, 4x4 BAYER MATRIX
+static const unsigned char conv_bayer[4][4]={
+	{ 0, 8, 2,10 },
+	{12, 4,14, 6 },
+	{ 3,11, 1, 9 },
+	{15, 7,13, 5 }
+};
+
+static unsigned int conv_mono[256];			// 8 MONO PIXELS -> 8 GRAY16 PIXELS
+static unsigned short conv_gray4[256];		// 4 GRAY4 PIXELS -> 4 GRAY16 PIXELS
+// 2 GRAY16 PIXELS -> 2 MONO OR 2 GRAY4 PIXELS, BY DITHER ROW (4 = NO DITHER)
+// AND BY BAYER COLUMN PAIR
+static unsigned char conv_rmono[5][2][256];
+static unsigned char conv_rgray4[5][2][256];
+static int conv_ready=0;
+
+// GRAY16 v TO 0..n WITH BAYER VALUE b, b=-1 ROUNDS TO NEAREST
+static int conv_quant(int v,int n,int b)
+{
+	int t=(b<0)? 16:2*b+1;
+	return (v*n*32+t*15)/480;
+}
+
+static void conv_init()
+{
+	int b,k,r,p,lo,hi,blo,bhi;
+
+	for(b=0;b<256;++b) {
+		conv_mono[b]=0;
+		for(k=0;k<8;++k) if(b&(1<<k)) conv_mono[b]|=0xfU<<(k<<2);
+		conv_gray4[b]=0;
+		for(k=0;k<4;++k) conv_gray4[b]|=(((b>>(k<<1))&3)*5)<<(k<<2);
+	}
+	for(r=0;r<5;++r) {
+		for(p=0;p<2;++p) {
+			blo=(r<4)? conv_bayer[r][p<<1]:-1;
+			bhi=(r<4)? conv_bayer[r][(p<<1)+1]:-1;
+			for(b=0;b<256;++b) {
+				lo=b&0xf;
+				hi=b>>4;
+				conv_rmono[r][p][b]=conv_quant(lo,1,blo)|(conv_quant(hi,1,bhi)<<1);
+				conv_rgray4[r][p][b]=conv_quant(lo,3,blo)|(conv_quant(hi,3,bhi)<<2);
+			}
+		}
+	}
+	conv_ready=1;
+}
+
+// READ nbits (1 TO 32) STARTING AT BIT bitoff, BITS ABOVE nbits ARE UNDEFINED
+static inline unsigned int conv_get(const unsigned int *p,int bitoff,int nbits)
+{
+	int s=bitoff&31;
+	unsigned int v;
+	p+=bitoff>>5;
+	v=p[0]>>s;
+	if(s && s+nbits>32) v|=p[1]<<(32-s);
+	return v;
+}
+
+static inline unsigned int conv_apply(unsigned int d,unsigned int v,unsigned int m,int mode)
+{
+	if(mode==GGL_CONV_XOR) return d^(v&m);
+	return (d&~m)|(v&m);
+}
+
+// WRITE THE BITS OF v SELECTED BY m STARTING AT BIT bitoff
+static inline void conv_put(unsigned int *p,int bitoff,unsigned int v,unsigned int m,int mode)
+{
+	int s=bitoff&31;
+	p+=bitoff>>5;
+	if(m<<s) p[0]=conv_apply(p[0],v<<s,m<<s,mode);
+	if(s && (m>>(32-s))) p[1]=conv_apply(p[1],v>>(32-s),m>>(32-s),mode);
+}
+
+// ONE BIT PER NON-ZERO NIBBLE, AT THE LOWEST BIT OF THE NIBBLE
+static inline unsigned int conv_nonzero(unsigned int w)
+{
+	w|=w>>1;
+	w|=w>>2;
+	return w&0x11111111;
+}
+
+
+void ggl_expandblt(gglsurface *dest,const unsigned int *src,int srcbpp,int srcwidth,int sx,int sy,int width,int height,int mode)
+{
+	int i,j,n,soff,doff;
+	unsigned int v,w,m;
+
+	if(srcbpp!=1 && srcbpp!=2) return;
+	if(!conv_ready) conv_init();
+
+	for(j=0;j<height;++j) {
+		soff=((sy+j)*srcwidth+sx)*srcbpp;
+		doff=((dest->y+j)*dest->width+dest->x)<<2;
+		for(i=0;i<width;i+=8) {
+			n=width-i;
+			if(n>8) n=8;
+			v=conv_get(src,soff+i*srcbpp,n*srcbpp);
+			if(srcbpp==1) w=conv_mono[v&0xff];
+			else w=conv_gray4[v&0xff]|((unsigned int)conv_gray4[(v>>8)&0xff]<<16);
+			m=(n==8)? 0xffffffff:(1U<<(n<<2))-1;
+			if(mode==GGL_CONV_TRANSP) m&=conv_nonzero(w)*0xf;
+			conv_put((unsigned int *)dest->addr,doff+(i<<2),w,m,mode);
+		}
+	}
+}
+
+void ggl_reduceblt(unsigned int *dest,int destbpp,int destwidth,int dx,int dy,gglsurface *src,int width,int height,int mode)
+{
+	unsigned char (*table)[2][256];
+	int i,j,n,a,r,k,x,soff,doff,op;
+	unsigned int w,v,m,nz;
+
+	if(destbpp!=1 && destbpp!=2) return;
+	if(!conv_ready) conv_init();
+	table=(destbpp==1)? conv_rmono:conv_rgray4;
+	op=mode&~GGL_CONV_DITHER;
+
+	for(j=0;j<height;++j) {
+		r=(mode&GGL_CONV_DITHER)? (dy+j)&3:4;
+		soff=((src->y+j)*src->width+src->x)<<2;
+		doff=(dy+j)*destwidth;
+		// GROUPS ARE ALIGNED TO MULTIPLES OF 8 IN x, SO EACH SOURCE BYTE
+		// STARTS AT AN EVEN BAYER COLUMN
+		for(i=0;i<width;i+=n) {
+			x=dx+i;
+			a=x&7;
+			n=8-a;
+			if(n>width-i) n=width-i;
+			w=conv_get((const unsigned int *)src->addr,soff+(i<<2),n<<2)<<(a<<2);
+			if(a) w&=~((1U<<(a<<2))-1);
+			v=0;
+			for(k=0;k<4;++k) v|=(unsigned int)table[r][k&1][(w>>(k<<3))&0xff]<<(k*2*destbpp);
+			m=((1U<<(n*destbpp))-1)<<(a*destbpp);
+			if(op==GGL_CONV_TRANSP) {
+				nz=conv_nonzero(w);
+				for(k=0;k<8;++k) if(!(nz&(1U<<(k<<2)))) m&=~(((1U<<destbpp)-1)<<(k*destbpp));
+			}
+			conv_put(dest,(doff+x-a)*destbpp,v,m,op);
+		}
+	}
+}
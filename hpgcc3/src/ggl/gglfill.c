@@ -0,0 +1,188 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <stdlib.h>
+#include <ggl.h>
+
+// FILLED SHAPES
+// EVERY SHAPE IS REDUCED TO HORIZONTAL SPANS DRAWN WITH ggl_hline, WITH
+// EITHER A SOLID COLOR PATTERN OR ROW (y&7) OF AN 8x8 PATTERN, AS ggl_rectp
+
+
+static inline void fill_span(gglsurface *srf,int y,int xl,int xr,int color,int *pattern)
+{
+	ggl_hline(srf,y,xl,xr,(pattern)? pattern[y&7]:color);
+}
+
+
+// CIRCLES: PIXEL (x,y) IS INSIDE IF x^2+y^2 <= r^2+r, THE SAME SHAPE
+// AS A MIDPOINT CIRCLE OF RADIUS r. THE HALF-WIDTH ONLY DECREASES AS
+// y GROWS, SO ALL SPANS ARE FOUND IN O(r) STEPS
+static void fill_circle(gglsurface *srf,int xc,int yc,int r,int color,int *pattern)
+{
+	int x=r,y,lim=r*r+r;
+
+	if(r<0) return;
+	for(y=0;y<=r;++y) {
+		while(x*x+y*y>lim) --x;
+		fill_span(srf,yc-y,xc-x,xc+x,color,pattern);
+		if(y) fill_span(srf,yc+y,xc-x,xc+x,color,pattern);
+	}
+}
+
+// ELLIPSES: PIXEL (x,y) IS INSIDE IF (x/(rx+1/2))^2+(y/(ry+1/2))^2 <= 1
+// IN INTEGERS: 4*x^2*(2ry+1)^2 + 4*y^2*(2rx+1)^2 <= (2rx+1)^2*(2ry+1)^2
+static void fill_ellipse(gglsurface *srf,int xc,int yc,int rx,int ry,int color,int *pattern)
+{
+	long long a2,b2,lim,xterm,yterm;
+	int x=rx,y;
+
+	if(rx<0 || ry<0) return;
+	a2=(long long)(2*rx+1)*(2*rx+1);
+	b2=(long long)(2*ry+1)*(2*ry+1);
+	lim=a2*b2;
+	xterm=4*(long long)x*x*b2;
+	for(y=0;y<=ry;++y) {
+		yterm=4*(long long)y*y*a2;
+		while(xterm+yterm>lim) {
+			// 4*(x-1)^2*b2 = 4*x^2*b2 - 4*(2x-1)*b2
+			xterm-=4*(long long)(2*x-1)*b2;
+			--x;
+		}
+		fill_span(srf,yc-y,xc-x,xc+x,color,pattern);
+		if(y) fill_span(srf,yc+y,xc-x,xc+x,color,pattern);
+	}
+}
+
+
+// POLYGONS: EDGE TABLE + ACTIVE EDGE LIST, EVEN-ODD RULE
+// SCANLINE y CROSSES THE EDGES WITH ytop <= y < ybottom, AND THE SPANS COVER
+// [ceil(xa),ceil(xb)) BETWEEN PAIRS OF CROSSINGS (TOP-LEFT RULE: THE RIGHT
+// AND BOTTOM BORDERS ARE NOT FILLED, SO POLYGONS SHARING AN EDGE DON'T OVERLAP)
+
+typedef struct {
+	int ytop,ybot;		// SCANLINES [ytop,ybot)
+	int q,r;			// CROSSING = q + r/dy, 0 <= r < dy
+	int dq,dr,dy;		// STEP PER SCANLINE = dq + dr/dy
+} gglpedge;
+
+// FLOOR DIVISION, b>0
+static inline int fill_fdiv(int a,int b)
+{
+	return (a>=0)? a/b:-((b-1-a)/b);
+}
+
+static void fill_poly(gglsurface *srf,int *pts,int npoints,int color,int *pattern)
+{
+	gglpedge *edges,*e,**active,*t;
+	gglpedge tmp;
+	int nedges,nactive,nextedge,k,j,y,ymin,ymax,x0,y0,x1,y1,next,num,xl,xr;
+
+	if(npoints<3) return;
+
+	edges=(gglpedge *)malloc(npoints*(sizeof(gglpedge)+sizeof(gglpedge *)));
+	if(!edges) return;
+	active=(gglpedge **)(edges+npoints);
+
+	// BUILD THE EDGE TABLE, SKIPPING HORIZONTAL EDGES
+	nedges=0;
+	ymin=0x7fffffff;
+	ymax=-0x7fffffff;
+	for(k=0;k<npoints;++k) {
+		x0=pts[2*k]; y0=pts[2*k+1];
+		next=(k+1<npoints)? k+1:0;
+		x1=pts[2*next]; y1=pts[2*next+1];
+		if(y0==y1) continue;
+		if(y0>y1) {
+			j=x0; x0=x1; x1=j;
+			j=y0; y0=y1; y1=j;
+		}
+		e=edges+nedges++;
+		e->ytop=y0;
+		e->ybot=y1;
+		e->dy=y1-y0;
+		e->q=x0;
+		e->r=0;
+		num=x1-x0;
+		e->dq=fill_fdiv(num,e->dy);
+		e->dr=num-e->dq*e->dy;
+		if(y0<ymin) ymin=y0;
+		if(y1>ymax) ymax=y1;
+	}
+
+	// SORT THE EDGE TABLE BY TOP SCANLINE
+	for(k=1;k<nedges;++k) {
+		tmp=edges[k];
+		for(j=k-1;j>=0 && edges[j].ytop>tmp.ytop;--j) edges[j+1]=edges[j];
+		edges[j+1]=tmp;
+	}
+
+	nactive=0;
+	nextedge=0;
+	for(y=ymin;y<ymax;++y) {
+		// DROP FINISHED EDGES, ADD NEW ONES
+		for(k=j=0;k<nactive;++k) if(active[k]->ybot>y) active[j++]=active[k];
+		nactive=j;
+		while(nextedge<nedges && edges[nextedge].ytop==y) active[nactive++]=edges+nextedge++;
+
+		// SORT BY CROSSING, INSERTION SORT IS FAST ON NEARLY SORTED LISTS
+		for(k=1;k<nactive;++k) {
+			t=active[k];
+			for(j=k-1;j>=0 && (active[j]->q>t->q || (active[j]->q==t->q && active[j]->r*t->dy>t->r*active[j]->dy));--j)
+				active[j+1]=active[j];
+			active[j+1]=t;
+		}
+
+		for(k=0;k+1<nactive;k+=2) {
+			xl=active[k]->q+(active[k]->r>0);
+			xr=active[k+1]->q+(active[k+1]->r>0)-1;
+			if(xl<=xr) fill_span(srf,y,xl,xr,color,pattern);
+		}
+
+		// STEP TO THE NEXT SCANLINE
+		for(k=0;k<nactive;++k) {
+			e=active[k];
+			e->q+=e->dq;
+			e->r+=e->dr;
+			if(e->r>=e->dy) { e->r-=e->dy; ++e->q; }
+		}
+	}
+
+	free(edges);
+}
+
+
+void ggl_fillcircle(gglsurface *srf,int xc,int yc,int r,int color)
+{
+	fill_circle(srf,xc,yc,r,color,0);
+}
+
+void ggl_fillcirclep(gglsurface *srf,int xc,int yc,int r,int *pattern)
+{
+	fill_circle(srf,xc,yc,r,0,pattern);
+}
+
+void ggl_fillellipse(gglsurface *srf,int xc,int yc,int rx,int ry,int color)
+{
+	fill_ellipse(srf,xc,yc,rx,ry,color,0);
+}
+
+void ggl_fillellipsep(gglsurface *srf,int xc,int yc,int rx,int ry,int *pattern)
+{
+	fill_ellipse(srf,xc,yc,rx,ry,0,pattern);
+}
+
+void ggl_fillpoly(gglsurface *srf,int *pts,int npoints,int color)
+{
+	fill_poly(srf,pts,npoints,color,0);
+}
+
+void ggl_fillpolyp(gglsurface *srf,int *pts,int npoints,int *pattern)
+{
+	fill_poly(srf,pts,npoints,0,pattern);
+}
@@ -0,0 +1,236 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <ggl.h>
+
+// FRAME PACING
+// THE APPLICATION QUEUES FINISHED BUFFERS, AND AN INTERRUPT HANDLER THAT RUNS
+// ONCE PER LCD FRAME POINTS THE LCD AT THE QUEUED BUFFER EVERY 'interval'
+// FRAMES. THE HANDLER IS A 1 ms TIMED EVENT THAT WATCHES THE LCD LINE COUNTER
+// AND FLIPS NEAR THE END OF THE FRAME. THE FRAME SYNC INTERRUPT OF THE
+// S3C2410 ONLY WORKS WITH TFT PANELS, THE CALCULATOR HAS AN STN PANEL.
+// ONLY THE HANDLER CHANGES 'shown' AND CLEARS 'queued', ONLY THE APPLICATION
+// SETS 'queued', SO THE TWO SIDES ONLY NEED TO LOCK TO READ BOTH AT ONCE
+
+#define LCDREG(off) (*((volatile unsigned int *)(LCD_REGS+(off))))
+#define LCDCON1 0x00
+#define LCDSADDR1 0x14
+#define LCDSADDR2 0x18
+
+#define LCD_LINECNT() ((LCDREG(LCDCON1)>>18)&0x3ff)
+
+// THE HANDLERS TAKE NO ARGUMENTS, SO ONLY ONE CHAIN CAN BE ACTIVE
+static gglframes *frame_active=0;
+
+
+// POINT THE LCD AT BUFFER idx
+static void frame_program(gglframes *fr,int idx)
+{
+	unsigned start=(unsigned)fr->physaddr[idx];
+	unsigned end=start+((LCD_W*fr->height)>>1);
+
+	LCDREG(LCDSADDR1)=((start>>22)<<21)|((start>>1)&0x1fffff);
+	LCDREG(LCDSADDR2)=(end>>1)&0x1fffff;
+}
+
+// CALLED ONCE PER LCD FRAME, IN INTERRUPT CONTEXT
+static void frame_vblank(gglframes *fr)
+{
+	tmr_t now;
+	int us;
+
+	++fr->vblanks;
+	if(++fr->phase<fr->interval) return;
+	fr->phase=0;
+
+	if(fr->queued<0) {
+		// THE PREVIOUS FRAME STAYS ON SCREEN FOR ANOTHER SLOT
+		if(fr->presented) ++fr->dropped;
+		return;
+	}
+
+	frame_program(fr,fr->queued);
+	fr->shown=fr->queued;
+	fr->queued=-1;
+
+	now=tmr_ticks();
+	if(fr->presented) {
+		us=tmr_ticks2us(fr->lastflip,now);
+		fr->lastus=us;
+		if(us<fr->minus) fr->minus=us;
+		if(us>fr->maxus) fr->maxus=us;
+		fr->totalus+=us;
+	}
+	fr->lastflip=now;
+	++fr->presented;
+}
+
+// THE LINE COUNTER COUNTS DOWN TO 0 DURING EACH FRAME. THE LAST
+// GGL_FRAME_VMARGIN LINES TAKE LONGER THAN THE 1 ms POLLING PERIOD, SO EVERY
+// FRAME IS SEEN ONCE
+static void frame_timer()
+{
+	gglframes *fr=frame_active;
+
+	if(!fr) return;
+	if(LCD_LINECNT()<=GGL_FRAME_VMARGIN) {
+		if(!fr->invblank) {
+			fr->invblank=1;
+			frame_vblank(fr);
+		}
+	}
+	else fr->invblank=0;
+}
+
+// SLEEP UNTIL THE NEXT INTERRUPT (ARM920T WAIT FOR INTERRUPT)
+static inline void frame_idle()
+{
+	asm volatile ("mcr p15,0,%0,c7,c0,4" : : "r" (0));
+}
+
+// MASK IRQ AND FIQ, RETURNING THE PREVIOUS CPSR. UNLIKE cpu_intoff/cpu_inton
+// THE CALLER'S STATE IS RESTORED, SO INTERRUPTS THAT WERE OFF STAY OFF
+static inline unsigned frame_lock()
+{
+	unsigned cpsr,tmp;
+
+	asm volatile ("mrs %0,cpsr\n\torr %1,%0,#0xc0\n\tmsr cpsr_c,%1" : "=r" (cpsr),"=r" (tmp) : : "memory");
+	return cpsr;
+}
+
+static inline void frame_unlock(unsigned cpsr)
+{
+	asm volatile ("msr cpsr_c,%0" : : "r" (cpsr) : "memory");
+}
+
+
+int ggl_frameinit(gglframes *fr,int nbuffers,int interval,int flags)
+{
+	int k,size;
+
+	if(frame_active) return 0;
+
+	if(nbuffers<2) nbuffers=2;
+	if(nbuffers>GGL_FRAME_MAXBUFFERS) nbuffers=GGL_FRAME_MAXBUFFERS;
+	if(interval<1) interval=1;
+
+	fr->height=lcd_getheight();
+	size=(LCD_W*fr->height)>>1;
+	for(k=0;k<nbuffers;++k) {
+		fr->buffer[k].addr=(int *)sys_phys_malloc(size);
+		if(!fr->buffer[k].addr) {
+			while(k--) free(fr->buffer[k].addr);
+			return 0;
+		}
+		memset((char *)fr->buffer[k].addr,0,size);
+		fr->buffer[k].width=LCD_W;
+		fr->buffer[k].x=fr->buffer[k].y=0;
+		fr->physaddr[k]=(int *)sys_map_v2p((unsigned int)fr->buffer[k].addr);
+	}
+
+	fr->nbuffers=nbuffers;
+	fr->interval=interval;
+	fr->flags=flags;
+	fr->shown=0;
+	fr->queued=-1;
+	fr->drawing=-1;
+	fr->phase=0;
+	fr->invblank=0;
+	fr->event=-1;
+	fr->vblanks=0;
+	ggl_frameresetstats(fr);
+
+	frame_active=fr;
+	fr->event=tmr_eventcreate(&frame_timer,1,TRUE);
+	if(fr->event<0) {
+		frame_active=0;
+		for(k=0;k<nbuffers;++k) free(fr->buffer[k].addr);
+		return 0;
+	}
+
+	lcd_save(fr->lcdstate);
+	lcd_setmode(MODE_16GRAY,fr->physaddr[0]);
+	return 1;
+}
+
+void ggl_frameexit(gglframes *fr)
+{
+	int k;
+
+	if(fr->event>=0) tmr_eventkill(fr->event);
+	fr->event=-1;
+	if(frame_active==fr) frame_active=0;
+
+	lcd_restore(fr->lcdstate);
+	for(k=0;k<fr->nbuffers;++k) {
+		if(fr->buffer[k].addr) free(fr->buffer[k].addr);
+		fr->buffer[k].addr=0;
+	}
+	fr->nbuffers=0;
+}
+
+gglsurface *ggl_framebegin(gglframes *fr)
+{
+	unsigned cpsr;
+	int k;
+
+	if(fr->drawing>=0) return &fr->buffer[fr->drawing];
+
+	for(;;) {
+		cpsr=frame_lock();
+		for(k=0;k<fr->nbuffers;++k) if(k!=fr->shown && k!=fr->queued) break;
+		frame_unlock(cpsr);
+		if(k<fr->nbuffers) break;
+		// DOUBLE BUFFERING WITH A FRAME QUEUED, WAIT FOR THE FLIP
+		frame_idle();
+	}
+	fr->drawing=k;
+	return &fr->buffer[k];
+}
+
+void ggl_frameend(gglframes *fr)
+{
+	unsigned cpsr;
+
+	if(fr->drawing<0) return;
+
+	// THE LCD READS THE BUFFER FROM MEMORY
+	cpu_flush_cache(fr->buffer[fr->drawing].addr,(LCD_W*fr->height)>>1);
+
+	if(fr->flags&GGL_FRAME_DISCARD) {
+		cpsr=frame_lock();
+		if(fr->queued>=0) ++fr->discarded;
+		fr->queued=fr->drawing;
+		frame_unlock(cpsr);
+	}
+	else {
+		while(fr->queued>=0) frame_idle();
+		fr->queued=fr->drawing;
+	}
+	fr->drawing=-1;
+}
+
+void ggl_frameflush(gglframes *fr)
+{
+	while(fr->queued>=0) frame_idle();
+}
+
+void ggl_frameresetstats(gglframes *fr)
+{
+	unsigned cpsr=frame_lock();
+
+	fr->presented=0;
+	fr->dropped=0;
+	fr->discarded=0;
+	fr->lastus=0;
+	fr->minus=0x7fffffff;
+	fr->maxus=0;
+	fr->totalus=0;
+	frame_unlock(cpsr);
+}
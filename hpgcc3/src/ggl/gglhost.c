@@ -0,0 +1,90 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <ggl.h>
+
+// HOST BUILD ONLY: STAND-INS FOR THE PREDEFINED OPERATORS AND FILTERS OF
+// libarmggl, ONE PIXEL AT A TIME. ggl_fastbltoper/ggl_fastfilter RECOGNIZE
+// THEM BY ADDRESS, AND THE BENCHMARKS USE THEM AS THE REFERENCE
+
+unsigned ggl_opmask(unsigned dest,unsigned src,int tcolor)
+{
+	unsigned res=0;
+	int k;
+	for(k=0;k<32;k+=4) res|=((((src>>k)&0xf)==(unsigned)tcolor)? (dest>>k)&0xf:(src>>k)&0xf)<<k;
+	return res;
+}
+
+unsigned ggl_optransp(unsigned dest,unsigned src,int weight)
+{
+	unsigned res=0;
+	int k;
+	for(k=0;k<32;k+=4) res|=(((((src>>k)&0xf)*(16-weight)+((dest>>k)&0xf)*weight)>>4)&0xf)<<k;
+	return res;
+}
+
+unsigned ggl_fltlighten(unsigned word,int param)
+{
+	unsigned res=0;
+	int k,c;
+	for(k=0;k<32;k+=4) {
+		c=((word>>k)&0xf)-param;
+		if(c<0) c=0;
+		res|=(unsigned)c<<k;
+	}
+	return res;
+}
+
+unsigned ggl_fltdarken(unsigned word,int param)
+{
+	unsigned res=0;
+	int k,c;
+	for(k=0;k<32;k+=4) {
+		c=((word>>k)&0xf)+param;
+		if(c>15) c=15;
+		res|=(unsigned)c<<k;
+	}
+	return res;
+}
+
+
+// DRAWING PRIMITIVES, SAME PATTERN ALIGNMENT AS THE LIBRARY
+// hline/rect USE THE NIBBLE (x&7) OF THE PATTERN, vline USES (y&7)
+
+static void host_pset(gglsurface *srf,int x,int y,int color)
+{
+	int off=y*srf->width+x;
+	unsigned *p=((unsigned *)srf->addr)+(off>>3);
+	int sh=(off&7)<<2;
+	*p=(*p&~(0xfU<<sh))|((unsigned)(color&0xf)<<sh);
+}
+
+int ggl_mkcolor(int color)
+{
+	return (int)((unsigned)(color&0xf)*0x11111111);
+}
+
+void ggl_hline(gglsurface *srf,int y,int xl,int xr,int color)
+{
+	for(;xl<=xr;++xl) host_pset(srf,xl,y,(unsigned)color>>((xl&7)<<2));
+}
+
+void ggl_vline(gglsurface *srf,int x,int yt,int yb,int color)
+{
+	for(;yt<=yb;++yt) host_pset(srf,x,yt,(unsigned)color>>((yt&7)<<2));
+}
+
+void ggl_rect(gglsurface *srf,int x1,int y1,int x2,int y2,int color)
+{
+	for(;y1<=y2;++y1) ggl_hline(srf,y1,x1,x2,color);
+}
+
+void ggl_rectp(gglsurface *srf,int x1,int y1,int x2,int y2,int *color)
+{
+	for(;y1<=y2;++y1) ggl_hline(srf,y1,x1,x2,color[y1&7]);
+}
@@ -0,0 +1,96 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgraphics.h>
+#include "gglpriv.h"
+
+// TRANSFERS BETWEEN GGL SURFACES AND HPG IMAGES WITHOUT INTERMEDIATE BUFFERS
+// A GRAY16 SURFACE HAS THE LAYOUT OF THE BITS OF A 4 BPP hpg_static_t, SO A
+// SURFACE IS DRAWN ON AN HPG IMAGE BY DESCRIBING IT AS ONE AND CALLING
+// hpg_blit_static, WHICH READS THE SURFACE IN PLACE. THE BUFFER OF AN hpg_t
+// IS NOT REACHABLE, SO THE OTHER DIRECTION READS IT WITH hpg_get_pixel AND
+// WRITES THE SURFACE 8 PIXELS AT A TIME. HPG TEXT IS WRITTEN STRAIGHT INTO
+// THE SURFACE FROM THE GLYPH CACHE OF hpg_draw_text_fast_on
+
+// 4 MONO PIXELS -> 4 NIBBLE MASKS
+static const unsigned short bridge_nibmask[16]={
+	0x0000,0x000f,0x00f0,0x00ff,0x0f00,0x0f0f,0x0ff0,0x0fff,
+	0xf000,0xf00f,0xf0f0,0xf0ff,0xff00,0xff0f,0xfff0,0xffff
+};
+
+// WRITE THE PIXELS v (RIGHT ALIGNED) IN THE NIBBLES SET IN mask, STARTING AT
+// NIBBLE off
+static inline void bridge_putnibs(int *buf,int off,unsigned v,unsigned mask)
+{
+	unsigned *p=((unsigned *)buf)+(off>>3);
+	int sh=(off&7)<<2;
+
+	__ggl_putmasked(p,v<<sh,mask<<sh);
+	if(sh && (mask>>(32-sh))) __ggl_putmasked(p+1,v>>(32-sh),mask>>(32-sh));
+}
+
+
+void ggl_blthpg(hpg_t *dest,int dx,int dy,gglsurface *src,int width,int height,int flags)
+{
+	hpg_static_t view;
+
+	view.width=src->width;
+	view.height=src->y+height;
+	view.bpp=4;
+	view.bits=(const unsigned int *)src->addr;
+	hpg_blit_static(&view,src->x,src->y,width,height,dest,dx,dy,flags);
+}
+
+void ggl_hpgblt(gglsurface *dest,hpg_t *src,int sx,int sy,int width,int height)
+{
+	unsigned v;
+	int x,y,k,n,off;
+
+	// CLIP TO THE SOURCE, THE SURFACE IS NOT CLIPPED
+	if(sx<0) { width+=sx; sx=0; }
+	if(sy<0) { height+=sy; sy=0; }
+	if(sx+width>hpg_get_width(src)) width=hpg_get_width(src)-sx;
+	if(sy+height>hpg_get_height(src)) height=hpg_get_height(src)-sy;
+
+	for(y=0;y<height;++y) {
+		off=(dest->y+y)*dest->width+dest->x;
+		for(x=0;x<width;x+=8,off+=8) {
+			n=(width-x<8)? width-x:8;
+			v=0;
+			for(k=n-1;k>=0;--k) v=(v<<4)|(hpg_get_pixel(src,sx+x+k,sy+y)>>4);
+			bridge_putnibs(dest->addr,off,v,(n==8)? 0xffffffff:(1U<<(n<<2))-1);
+		}
+	}
+}
+
+void ggl_hpgtext(gglsurface *srf,hpg_font_t *font,char *s,int x,int y,int color)
+{
+	const unsigned char *glyph;
+	unsigned m;
+	int h,adv,r,cx,off;
+
+	h=hpg_font_get_height(font);
+	adv=hpg_font_get_advance(font);
+	if(adv>8) adv=8;
+	for(cx=x;*s;++s) {
+		if(*s=='\n') {
+			cx=x;
+			y+=h;
+			continue;
+		}
+		glyph=hpg_font_get_glyph(font,(unsigned char)*s);
+		if(!glyph) return;
+		off=(srf->y+y)*srf->width+srf->x+cx;
+		for(r=0;r<h;++r,off+=srf->width) {
+			if(!glyph[r]) continue;
+			m=bridge_nibmask[glyph[r]&15]|((unsigned)bridge_nibmask[glyph[r]>>4]<<16);
+			bridge_putnibs(srf->addr,off,(unsigned)color,m);
+		}
+		cx+=adv;
+	}
+}
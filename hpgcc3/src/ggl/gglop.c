@@ -0,0 +1,185 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <ggl.h>
+#include "gglpriv.h"
+
+// FUSED BLIT+OPERATOR AND FILTER KERNELS
+// THE PREDEFINED OPERATORS/FILTERS ARE EXPANDED INLINE INTO SHIFT-SPECIALIZED
+// ROW LOOPS, WITH THE PARAMETER PRECOMPUTED ONCE PER CALL. ANY OTHER
+// FUNCTION POINTER GOES THROUGH THE GENERIC LOOP, ONE CALL PER WORD.
+
+
+// ROW KERNEL: COMBINE n FULL DESTINATION WORDS WITH SHIFTED SOURCE WORDS
+typedef void (*gglopfn)(unsigned *d,const unsigned *s,int n,unsigned param,ggloperator op);
+
+// OPERATORS, d=DESTINATION WORD, s=SOURCE WORD
+#define GGL_APPLYMASK(d,s)		__ggl_inmask(d,s,param)
+#define GGL_APPLYTRANSP(d,s)	__ggl_intransp(d,s,param)
+#define GGL_APPLYOPER(d,s)		(op)(d,s,(int)param)
+
+#define GGL_OPKERNEL0(name,APPLY) \
+static void name(unsigned *d,const unsigned *s,int n,unsigned param,ggloperator op) \
+{ \
+	while(n>=4) { \
+		d[0]=APPLY(d[0],s[0]); \
+		d[1]=APPLY(d[1],s[1]); \
+		d[2]=APPLY(d[2],s[2]); \
+		d[3]=APPLY(d[3],s[3]); \
+		d+=4; s+=4; n-=4; \
+	} \
+	while(n--) { *d=APPLY(*d,*s); ++d; ++s; } \
+}
+
+#define GGL_OPKERNEL(name,r,APPLY) \
+static void name(unsigned *d,const unsigned *s,int n,unsigned param,ggloperator op) \
+{ \
+	unsigned a=*s++,b; \
+	while(n>=4) { \
+		b=s[0]; d[0]=APPLY(d[0],(a>>GGL_SHR(r))|(b<<GGL_SHL(r))); \
+		a=s[1]; d[1]=APPLY(d[1],(b>>GGL_SHR(r))|(a<<GGL_SHL(r))); \
+		b=s[2]; d[2]=APPLY(d[2],(a>>GGL_SHR(r))|(b<<GGL_SHL(r))); \
+		a=s[3]; d[3]=APPLY(d[3],(b>>GGL_SHR(r))|(a<<GGL_SHL(r))); \
+		d+=4; s+=4; n-=4; \
+	} \
+	while(n--) { \
+		b=*s++; *d=APPLY(*d,(a>>GGL_SHR(r))|(b<<GGL_SHL(r))); \
+		++d; a=b; \
+	} \
+}
+
+#define GGL_OPFAMILY(pre,APPLY) \
+GGL_OPKERNEL0(pre##0,APPLY) \
+GGL_OPKERNEL(pre##1,1,APPLY) \
+GGL_OPKERNEL(pre##2,2,APPLY) \
+GGL_OPKERNEL(pre##3,3,APPLY) \
+GGL_OPKERNEL(pre##4,4,APPLY) \
+GGL_OPKERNEL(pre##5,5,APPLY) \
+GGL_OPKERNEL(pre##6,6,APPLY) \
+GGL_OPKERNEL(pre##7,7,APPLY) \
+static const gglopfn pre##tbl[8]={ &pre##0,&pre##1,&pre##2,&pre##3,&pre##4,&pre##5,&pre##6,&pre##7 };
+
+GGL_OPFAMILY(ggl_mask,GGL_APPLYMASK)
+GGL_OPFAMILY(ggl_transp,GGL_APPLYTRANSP)
+GGL_OPFAMILY(ggl_oper,GGL_APPLYOPER)
+
+
+// COMBINE A PARTIAL DESTINATION WORD
+#define GGL_EDGE(APPLY,ptr,sword,mask) __ggl_putmasked(ptr,APPLY(*(ptr),sword),mask)
+
+// ONE ROW, SAME SPLIT AS __ggl_planrow
+#define GGL_OPROW(APPLY,tbl) \
+	{ \
+		unsigned *d=((unsigned *)dest->addr)+(doff>>3); \
+		int so=soff; \
+		if(plan.lcnt) { \
+			GGL_EDGE(APPLY,d,__ggl_getnibs(src->addr,so,plan.lcnt)<<(plan.lshift<<2),plan.lmask); \
+			++d; so+=plan.lcnt; \
+		} \
+		if(plan.nmid) { \
+			(tbl[plan.kernel])(d,((unsigned *)src->addr)+(so>>3),plan.nmid,param,op); \
+			d+=plan.nmid; so+=plan.nmid<<3; \
+		} \
+		if(plan.rcnt) GGL_EDGE(APPLY,d,__ggl_getnibs(src->addr,so,plan.rcnt),plan.rmask); \
+	}
+
+#define GGL_OPLOOP(APPLY,tbl) \
+	if(fixedplan) { \
+		while(height--) { \
+			GGL_OPROW(APPLY,tbl); \
+			doff+=dest->width; soff+=src->width; \
+		} \
+	} \
+	else { \
+		while(height--) { \
+			__ggl_mkplan(&plan,doff,soff,width); \
+			GGL_OPROW(APPLY,tbl); \
+			doff+=dest->width; soff+=src->width; \
+		} \
+	}
+
+
+void ggl_fastbltoper(gglsurface *dest,gglsurface *src,int width, int height,int param,ggloperator filterfunc)
+{
+	gglbltplan plan;
+	int doff,soff,fixedplan;
+	ggloperator op=filterfunc;
+
+	if(width<=0 || height<=0) return;
+
+	doff=dest->y*dest->width+dest->x;
+	soff=src->y*src->width+src->x;
+
+	fixedplan=!((dest->width|src->width)&7);
+	if(fixedplan) __ggl_mkplan(&plan,doff,soff,width);
+
+	if(filterfunc==(ggloperator)&ggl_opmask) {
+		param=(param&0xf)*0x11111111;
+		GGL_OPLOOP(GGL_APPLYMASK,ggl_masktbl);
+		return;
+	}
+	if(filterfunc==(ggloperator)&ggl_optransp) {
+		if(param<=0) {
+			// FULLY OPAQUE
+			ggl_fastblt(dest,src,width,height);
+			return;
+		}
+		if(param>=16) return;	// FULLY TRANSPARENT
+		GGL_OPLOOP(GGL_APPLYTRANSP,ggl_transptbl);
+		return;
+	}
+
+	GGL_OPLOOP(GGL_APPLYOPER,ggl_opertbl);
+}
+
+
+// FILTERS, IN PLACE ON THE DESTINATION WORDS
+#define GGL_APPLYLIGHTEN(w)		__ggl_inlighten(w,param)
+#define GGL_APPLYDARKEN(w)		__ggl_indarken(w,param)
+#define GGL_APPLYFILTER(w)		(flt)(w,(int)param)
+
+#define GGL_FLTLOOP(APPLY) \
+	while(height--) { \
+		unsigned *d=((unsigned *)dest->addr)+(doff>>3); \
+		int k; \
+		__ggl_mkplan(&plan,doff,doff,width); \
+		if(plan.lcnt) { __ggl_putmasked(d,APPLY(*d),plan.lmask); ++d; } \
+		k=plan.nmid; \
+		while(k>=4) { \
+			d[0]=APPLY(d[0]); \
+			d[1]=APPLY(d[1]); \
+			d[2]=APPLY(d[2]); \
+			d[3]=APPLY(d[3]); \
+			d+=4; k-=4; \
+		} \
+		while(k--) { *d=APPLY(*d); ++d; } \
+		if(plan.rcnt) __ggl_putmasked(d,APPLY(*d),plan.rmask); \
+		doff+=dest->width; \
+	}
+
+void ggl_fastfilter(gglsurface *dest,int width, int height, int param, gglfilter filterfunc)
+{
+	gglbltplan plan;
+	int doff;
+	gglfilter flt=filterfunc;
+
+	if(width<=0 || height<=0) return;
+
+	doff=dest->y*dest->width+dest->x;
+
+	if(filterfunc==(gglfilter)&ggl_fltlighten || filterfunc==(gglfilter)&ggl_fltdarken) {
+		if(param<=0) return;
+		if(param>15) param=15;
+		param*=0x01010101;
+		if(filterfunc==(gglfilter)&ggl_fltlighten) { GGL_FLTLOOP(GGL_APPLYLIGHTEN); }
+		else { GGL_FLTLOOP(GGL_APPLYDARKEN); }
+		return;
+	}
+
+	GGL_FLTLOOP(GGL_APPLYFILTER);
+}
@@ -0,0 +1,115 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#ifndef GGLPRIV_H_
+#define GGLPRIV_H_
+
+// PRIVATE HEADER FOR THE GGL ADD-ON MODULES - NOT INSTALLED
+
+#ifndef GGL_H_
+#include <ggl.h>
+#endif
+
+// ROW KERNEL: COPY n FULL WORDS TO d, TAKING EACH WORD FROM s WITH A
+// FIXED NIBBLE SHIFT. THE KERNEL READS n+1 SOURCE WORDS UNLESS THE SHIFT IS 0
+typedef void (*gglrowfn)(unsigned *d,const unsigned *s,int n);
+
+// KERNEL TABLES, INDEXED BY SOURCE NIBBLE SHIFT (0-7)
+extern const gglrowfn __ggl_fwdrow[8];	// LEFT TO RIGHT
+extern const gglrowfn __ggl_revrow[8];	// RIGHT TO LEFT, FOR OVERLAPPED AREAS
+
+// PRECOMPUTED SPLIT OF A ROW INTO LEADING/FULL/TRAILING WORDS
+// ONLY DEPENDS ON THE NIBBLE ALIGNMENT OF BOTH ROWS AND THE ROW WIDTH,
+// SO IT CAN BE REUSED FOR ALL ROWS WHEN BOTH SURFACES HAVE WIDTH%8==0
+typedef struct {
+	int lcnt,lshift;	// PIXELS IN THE LEADING PARTIAL WORD, THEIR NIBBLE POSITION
+	int nmid;			// NUMBER OF FULL WORDS
+	int rcnt;			// PIXELS IN THE TRAILING PARTIAL WORD
+	unsigned lmask,rmask;
+	int kernel;			// SOURCE NIBBLE SHIFT FOR THE FULL WORDS
+} gglbltplan;
+
+void __ggl_mkplan(gglbltplan *p,int doff,int soff,int npixels);
+void __ggl_planrow(gglbltplan *p,int *dest,int doff,int *src,int soff);
+void __ggl_planrevrow(gglbltplan *p,int *dest,int doff,int *src,int soff);
+
+// A WORD AT A SOURCE NIBBLE SHIFT OF r (1-7) IS (s[0]>>GGL_SHR(r))|(s[1]<<GGL_SHL(r))
+#define GGL_SHL(r) (32-4*(r))
+#define GGL_SHR(r) (4*(r))
+
+
+// MASK OF NIBBLES [from,to) WITHIN A WORD, 0<=from<to<=8
+static inline unsigned __ggl_nibmask(int from,int to)
+{
+	unsigned m=(to>=8)? 0xffffffff:((1U<<(to<<2))-1);
+	return m & ~((1U<<(from<<2))-1);
+}
+
+// READ cnt (1-8) PIXELS STARTING AT NIBBLE off OF buf, RIGHT ALIGNED
+// ONLY WORDS CONTAINING REQUESTED PIXELS ARE READ, UPPER NIBBLES ARE GARBAGE
+static inline unsigned __ggl_getnibs(int *buf,int off,int cnt)
+{
+	unsigned *p=((unsigned *)buf)+(off>>3);
+	int sh=(off&7)<<2;
+	unsigned v=p[0]>>sh;
+	if(sh && cnt>8-(off&7)) v|=p[1]<<(32-sh);
+	return v;
+}
+
+// REPLACE THE NIBBLES IN mask OF THE WORD AT ptr
+static inline void __ggl_putmasked(unsigned *ptr,unsigned v,unsigned mask)
+{
+	*ptr=(*ptr&~mask)|(v&mask);
+}
+
+// INLINE VERSIONS OF THE PREDEFINED OPERATORS AND FILTERS, 8 PIXELS AT ONCE
+
+// ggl_opmask, tcol32 IS THE TRANSPARENT COLOR REPEATED ON ALL NIBBLES
+static inline unsigned __ggl_inmask(unsigned dest,unsigned src,unsigned tcol32)
+{
+	unsigned x=src^tcol32;
+	x|=x>>1;
+	x|=x>>2;
+	x=(x&0x11111111)*15;	// 0xF ON EVERY OPAQUE PIXEL
+	return (dest&~x)|(src&x);
+}
+
+// ggl_optransp, 0<weight<16, (src*(16-weight)+dest*weight)/16 TRUNCATED
+// PIXELS ARE PROCESSED IN PAIRS ON 16-BIT LANES
+static inline unsigned __ggl_intransp(unsigned dest,unsigned src,unsigned weight)
+{
+	unsigned sw=16-weight,res;
+	res=((((src&0x000f000f)*sw+(dest&0x000f000f)*weight)>>4)&0x000f000f);
+	res|=((((src>>4)&0x000f000f)*sw+((dest>>4)&0x000f000f)*weight)&0x00f000f0);
+	res|=((((src>>8)&0x000f000f)*sw+((dest>>8)&0x000f000f)*weight)&0x00f000f0)<<4;
+	res|=((((src>>12)&0x000f000f)*sw+((dest>>12)&0x000f000f)*weight)&0x00f000f0)<<8;
+	return res;
+}
+
+// ggl_fltlighten, p8 IS THE PARAMETER (1-15) REPEATED ON ALL BYTES
+// EVEN/ODD PIXELS ARE PROCESSED ON 8-BIT LANES, BIT 4 CATCHES THE BORROW
+static inline unsigned __ggl_inlighten(unsigned word,unsigned p8)
+{
+	unsigned a=((word&0x0f0f0f0f)|0x10101010)-p8;
+	unsigned b=(((word>>4)&0x0f0f0f0f)|0x10101010)-p8;
+	a&=((a&0x10101010)>>4)*15;
+	b&=((b&0x10101010)>>4)*15;
+	return a|(b<<4);
+}
+
+// ggl_fltdarken, p8 IS THE PARAMETER (1-15) REPEATED ON ALL BYTES
+static inline unsigned __ggl_indarken(unsigned word,unsigned p8)
+{
+	unsigned a=(word&0x0f0f0f0f)+p8;
+	unsigned b=((word>>4)&0x0f0f0f0f)+p8;
+	a=(a|(((a&0x10101010)>>4)*15))&0x0f0f0f0f;
+	b=(b|(((b&0x10101010)>>4)*15))&0x0f0f0f0f;
+	return a|(b<<4);
+}
+
+#endif /*GGLPRIV_H_*/
@@ -0,0 +1,178 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <ggl.h>
+#include "gglpriv.h"
+
+// PRECOMPILED TRANSPARENT SPRITES
+
+// SPRITE FORMAT (WORDS):
+// WIDTH|HEIGHT<<16
+// THEN FOR EACH ROW, A LIST OF RUNS OF SOURCE WORDS (8 PIXELS, ALIGNED TO THE
+// SPRITE'S LEFT EDGE), EACH STARTING WITH A HEADER WORD:
+// SKIP|COUNT<<16|GGL_SPR_MASKED
+// SKIP = NUMBER OF FULLY TRANSPARENT WORDS BEFORE THE RUN
+// OPAQUE RUN: COUNT DATA WORDS FOLLOW
+// MASKED RUN: COUNT PAIRS MASK,DATA FOLLOW, DATA IS ALREADY AND'ED WITH MASK
+// A HEADER WITH COUNT=0 ENDS THE ROW. FULLY TRANSPARENT WORDS ARE NEVER STORED
+
+#define GGL_SPR_MASKED 0x80000000
+#define GGL_SPR_COUNT(h) (((h)>>16)&0x7fff)
+#define GGL_SPR_SKIP(h) ((h)&0xffff)
+
+// EXPAND EVERY NON-ZERO NIBBLE TO 0xF
+static inline unsigned spr_nzmask(unsigned x)
+{
+	x|=x>>1;
+	x|=x>>2;
+	return (x&0x11111111)*15;
+}
+
+// EMIT A WORD, ONLY COUNT IT IF THERE'S NO BUFFER
+#define SPR_EMIT(v) { if(sprite) sprite[used]=(v); ++used; }
+
+static int spr_encode(unsigned int *sprite,gglsurface *src,gglsurface *mask,int tcol,int width,int height)
+{
+	int used=0,j,i,nwords,soff,moff,n,skip,hdr,cnt;
+	unsigned tcol32=(tcol&0xf)*0x11111111,s,m,kind,k;
+
+	if(width<=0 || height<=0 || width>0xffff || height>0xffff) return 0;
+
+	SPR_EMIT((unsigned)width|((unsigned)height<<16));
+
+	nwords=(width+7)>>3;
+	soff=src->y*src->width+src->x;
+	moff=(mask)? mask->y*mask->width+mask->x:0;
+
+	for(j=0;j<height;++j) {
+		skip=0;
+		hdr=-1;
+		kind=0;
+		cnt=0;
+		for(i=0;i<nwords;++i) {
+			n=width-(i<<3);
+			if(n>8) n=8;
+			s=__ggl_getnibs(src->addr,soff+(i<<3),n);
+			if(mask) m=spr_nzmask(__ggl_getnibs(mask->addr,moff+(i<<3),n));
+			else m=spr_nzmask(s^tcol32);
+			m&=__ggl_nibmask(0,n);
+			s&=m;
+
+			if(!m) {
+				// TRANSPARENT, CLOSE THE CURRENT RUN
+				if(hdr>=0) {
+					if(sprite) sprite[hdr]|=cnt<<16;
+					hdr=-1;
+				}
+				++skip;
+				continue;
+			}
+			k=(m==0xffffffff)? 0:GGL_SPR_MASKED;
+			if(hdr>=0 && k!=kind) {
+				if(sprite) sprite[hdr]|=cnt<<16;
+				hdr=-1;
+			}
+			if(hdr<0) {
+				// START A NEW RUN
+				hdr=used;
+				kind=k;
+				cnt=0;
+				SPR_EMIT(skip|kind);
+				skip=0;
+			}
+			if(kind) SPR_EMIT(m);
+			SPR_EMIT(s);
+			++cnt;
+		}
+		if(hdr>=0 && sprite) sprite[hdr]|=cnt<<16;
+		SPR_EMIT(0);	// END OF ROW
+
+		soff+=src->width;
+		if(mask) moff+=mask->width;
+	}
+	return used;
+}
+
+
+int ggl_mksprite(unsigned int *sprite,gglsurface *src,int width,int height,int tcol)
+{
+	return spr_encode(sprite,src,0,tcol,width,height);
+}
+
+int ggl_mkspritemask(unsigned int *sprite,gglsurface *src,gglsurface *mask,int width,int height)
+{
+	return spr_encode(sprite,src,mask,0,width,height);
+}
+
+
+void ggl_spriteblt(gglsurface *dest,const unsigned int *sprite)
+{
+	int height=sprite[0]>>16;
+	int doff=dest->y*dest->width+dest->x;
+	int sh,rsh,cnt;
+	unsigned lmask,hdr,a,b,m;
+	unsigned *d;
+	const unsigned *p=sprite+1;
+
+	while(height--) {
+		d=((unsigned *)dest->addr)+(doff>>3);
+		sh=(doff&7)<<2;
+		rsh=32-sh;
+		lmask=0xffffffff<<sh;
+
+		while((cnt=GGL_SPR_COUNT(hdr=*p++))) {
+			d+=GGL_SPR_SKIP(hdr);
+
+			if(hdr&GGL_SPR_MASKED) {
+				if(!sh) {
+					while(cnt--) {
+						m=p[0];
+						*d=(*d&~m)|p[1];
+						++d; p+=2;
+					}
+				}
+				else {
+					while(cnt--) {
+						m=p[0];
+						a=p[1];
+						d[0]=(d[0]&~(m<<sh))|(a<<sh);
+						// DON'T TOUCH THE NEXT WORD UNLESS NEEDED, IT MAY BE PAST THE SURFACE
+						if(m>>rsh) d[1]=(d[1]&~(m>>rsh))|(a>>rsh);
+						++d; p+=2;
+					}
+				}
+				continue;
+			}
+
+			// OPAQUE RUN
+			if(!sh) {
+				while(cnt>=4) {
+					d[0]=p[0];
+					d[1]=p[1];
+					d[2]=p[2];
+					d[3]=p[3];
+					d+=4; p+=4; cnt-=4;
+				}
+				while(cnt--) *d++=*p++;
+				continue;
+			}
+
+			a=*p++;
+			d[0]=(d[0]&~lmask)|(a<<sh);
+			++d;
+			while(--cnt) {
+				b=*p++;
+				*d++=(a>>rsh)|(b<<sh);
+				a=b;
+			}
+			*d=(*d&lmask)|(a>>rsh);
+		}
+
+		doff+=dest->width;
+	}
+}
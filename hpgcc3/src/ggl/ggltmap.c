@@ -0,0 +1,163 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <ggl.h>
+
+// TILE MAPS
+// TILE k OF THE ATLAS IS tilesize ROWS OF tilesize PIXELS STARTING AT WORD
+// k*tilesize*tilesize/8, SO THE ATLAS IS A SURFACE OF WIDTH tilesize WITH THE
+// TILES STACKED VERTICALLY, AND EVERY TILE ROW IS 1 OR 2 WHOLE WORDS
+
+
+// FLOOR DIVISION FOR NEGATIVE SCROLL POSITIONS
+static inline int tm_div(int a,int b)
+{
+	return (a>=0)? a/b:-((b-1-a)/b);
+}
+
+// COPY w x h PIXELS OF A TILE, STARTING AT (sx,sy) WITHIN THE TILE, TO
+// NIBBLE OFFSET doff OF dest
+static void tm_blittile(gglsurface *dest,int doff,int *tile,int ts,int sx,int sy,int w,int h)
+{
+	gglsurface d,s;
+
+	if(w==ts && !(doff&7) && !(dest->width&7)) {
+		// WORD-ALIGNED FULL-WIDTH ROWS, PLAIN WORD COPIES
+		int *dptr=dest->addr+(doff>>3);
+		int *sptr=tile+sy*(ts>>3);
+		int stride=dest->width>>3;
+		if(ts==8) {
+			while(h--) { *dptr=*sptr++; dptr+=stride; }
+		}
+		else {
+			while(h--) { dptr[0]=sptr[0]; dptr[1]=sptr[1]; sptr+=2; dptr+=stride; }
+		}
+		return;
+	}
+
+	d.addr=dest->addr;
+	d.width=dest->width;
+	d.x=doff;
+	d.y=0;
+	s.addr=tile;
+	s.width=ts;
+	s.x=sx;
+	s.y=sy;
+	ggl_fastblt(&d,&s,w,h);
+}
+
+
+void ggl_tminit(ggltilemap *tm,int *tiles,int tilesize,unsigned short *map,int mapwidth,int mapheight,int viewwidth,int viewheight)
+{
+	tm->tiles=tiles;
+	tm->tilesize=tilesize;
+	tm->map=map;
+	tm->mapwidth=mapwidth;
+	tm->mapheight=mapheight;
+	tm->scrollx=tm->scrolly=0;
+	tm->viewwidth=viewwidth;
+	tm->viewheight=viewheight;
+	tm->bgcolor=0;
+}
+
+void ggl_tmdrawrect(ggltilemap *tm,gglsurface *dest,int x,int y,int w,int h)
+{
+	int ts=tm->tilesize,tilewords=(ts*ts)>>3;
+	int mx1,my1,mx2,my2,tx,ty,tx1,tx2,ty1,ty2,rx1,rx2,ry1,ry2,idx,rot;
+	unsigned bg;
+
+	// CLIP TO THE VIEWPORT
+	if(x<0) { w+=x; x=0; }
+	if(y<0) { h+=y; y=0; }
+	if(x+w>tm->viewwidth) w=tm->viewwidth-x;
+	if(y+h>tm->viewheight) h=tm->viewheight-y;
+	if(w<=0 || h<=0) return;
+
+	// MAP PIXEL COORDINATES OF THE AREA
+	mx1=tm->scrollx+x;
+	my1=tm->scrolly+y;
+	mx2=mx1+w-1;
+	my2=my1+h-1;
+
+	// ALIGN THE BACKGROUND PATTERN TO THE MAP, SO IT SCROLLS WITH IT
+	rot=((dest->x-tm->scrollx)&7)<<2;
+	bg=(unsigned)tm->bgcolor;
+	if(rot) bg=(bg<<rot)|(bg>>(32-rot));
+
+	tx1=tm_div(mx1,ts);
+	tx2=tm_div(mx2,ts);
+	ty1=tm_div(my1,ts);
+	ty2=tm_div(my2,ts);
+
+	for(ty=ty1;ty<=ty2;++ty) {
+		ry1=ty*ts;
+		ry2=ry1+ts-1;
+		if(ry1<my1) ry1=my1;
+		if(ry2>my2) ry2=my2;
+
+		for(tx=tx1;tx<=tx2;++tx) {
+			rx1=tx*ts;
+			rx2=rx1+ts-1;
+			if(rx1<mx1) rx1=mx1;
+			if(rx2>mx2) rx2=mx2;
+
+			// DESTINATION = VIEWPORT ORIGIN + MAP POSITION - SCROLL
+			if(tx<0 || ty<0 || tx>=tm->mapwidth || ty>=tm->mapheight) {
+				ggl_rect(dest,dest->x+rx1-tm->scrollx,dest->y+ry1-tm->scrolly,
+						dest->x+rx2-tm->scrollx,dest->y+ry2-tm->scrolly,(int)bg);
+				continue;
+			}
+			idx=tm->map[ty*tm->mapwidth+tx];
+			tm_blittile(dest,(dest->y+ry1-tm->scrolly)*dest->width+dest->x+rx1-tm->scrollx,
+					tm->tiles+idx*tilewords,ts,rx1-tx*ts,ry1-ty*ts,rx2-rx1+1,ry2-ry1+1);
+		}
+	}
+}
+
+void ggl_tmdraw(ggltilemap *tm,gglsurface *dest)
+{
+	ggl_tmdrawrect(tm,dest,0,0,tm->viewwidth,tm->viewheight);
+}
+
+void ggl_tmscroll(ggltilemap *tm,gglsurface *dest,int dx,int dy)
+{
+	gglsurface s,d;
+	int adx=(dx<0)? -dx:dx,ady=(dy<0)? -dy:dy;
+
+	if(!dx && !dy) return;
+
+	tm->scrollx+=dx;
+	tm->scrolly+=dy;
+
+	if(adx>=tm->viewwidth || ady>=tm->viewheight) {
+		ggl_tmdraw(tm,dest);
+		return;
+	}
+
+	// MOVE THE PART THAT STAYS VISIBLE
+	s=*dest;
+	d=*dest;
+	if(dx>0) s.x+=dx; else d.x-=dx;
+	if(dy>0) s.y+=dy; else d.y-=dy;
+	ggl_fastovlblt(&d,&s,tm->viewwidth-adx,tm->viewheight-ady);
+
+	// DRAW THE EXPOSED ROWS ACROSS THE WHOLE WIDTH, THEN THE EXPOSED
+	// COLUMNS ONLY WHERE THEY WEREN'T ALREADY DRAWN
+	if(dy>0) ggl_tmdrawrect(tm,dest,0,tm->viewheight-dy,tm->viewwidth,dy);
+	else if(dy<0) ggl_tmdrawrect(tm,dest,0,0,tm->viewwidth,ady);
+
+	if(dx>0) ggl_tmdrawrect(tm,dest,tm->viewwidth-dx,(dy<0)? ady:0,dx,tm->viewheight-ady);
+	else if(dx<0) ggl_tmdrawrect(tm,dest,0,(dy<0)? ady:0,adx,tm->viewheight-ady);
+}
+
+void ggl_tmsettile(ggltilemap *tm,gglsurface *dest,int col,int row,int tile)
+{
+	if(col<0 || row<0 || col>=tm->mapwidth || row>=tm->mapheight) return;
+	tm->map[row*tm->mapwidth+col]=(unsigned short)tile;
+	if(dest) ggl_tmdrawrect(tm,dest,col*tm->tilesize-tm->scrollx,row*tm->tilesize-tm->scrolly,tm->tilesize,tm->tilesize);
+}
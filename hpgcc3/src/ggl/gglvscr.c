@@ -0,0 +1,164 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <ggl.h>
+
+// HARDWARE SCROLLING VIRTUAL SCREEN
+// THE LCD CONTROLLER FETCHES A WINDOW OF THE VIRTUAL FRAMEBUFFER: START
+// ADDRESS IN LCDSADDR1/2, LINE STRIDE = PAGEWIDTH+OFFSIZE (HALFWORDS) IN
+// LCDSADDR3. SCROLLING ONLY MOVES THE WINDOW. WHEN THE WINDOW REACHES AN EDGE
+// OF THE BUFFER, THE PART THAT STAYS VISIBLE IS COPIED BACK TO THE OPPOSITE
+// EDGE (ONE COPY EVERY vheight-viewheight ROWS INSTEAD OF ONE PER STEP)
+
+#define LCDREG(off) (*((volatile unsigned int *)(LCD_REGS+(off))))
+#define LCDSADDR1 0x14
+#define LCDSADDR2 0x18
+#define LCDSADDR3 0x1c
+
+
+// POINT THE LCD AT THE CURRENT WINDOW
+static void vscr_program(gglvscreen *vs)
+{
+	unsigned start=(unsigned)vs->physaddr+((vs->posy*vs->srf.width+vs->posx)>>1);
+	unsigned end=start+((vs->srf.width*vs->viewheight)>>1);
+
+	LCDREG(LCDSADDR1)=((start>>22)<<21)|((start>>1)&0x1fffff);
+	LCDREG(LCDSADDR2)=(end>>1)&0x1fffff;
+}
+
+int ggl_vscrinit(gglvscreen *vs,int vwidth,int vheight)
+{
+	int size;
+
+	// THE VISIBLE WINDOW IS ONE NORMAL SCREEN, LCD_W PIXELS PER SCANLINE
+	vs->viewwidth=LCD_W;
+	vs->viewheight=lcd_getheight();
+
+	vwidth=(vwidth+GGL_VSCR_XSTEP-1)&~(GGL_VSCR_XSTEP-1);
+	if(vwidth<vs->viewwidth) vwidth=vs->viewwidth;
+	if(vheight<vs->viewheight) vheight=vs->viewheight;
+	// OFFSIZE IS AN 11-BIT FIELD
+	if(((vwidth-vs->viewwidth)>>2)>0x7ff) return 0;
+
+	size=(vwidth*vheight)>>1;
+	vs->srf.addr=(int *)sys_phys_malloc(size);
+	if(!vs->srf.addr) return 0;
+	memset((char *)vs->srf.addr,0,size);
+
+	vs->srf.width=vwidth;
+	vs->srf.x=vs->srf.y=0;
+	vs->height=vheight;
+	vs->posx=vs->posy=0;
+	vs->physaddr=(int *)sys_map_v2p((unsigned int)vs->srf.addr);
+
+	lcd_save(vs->lcdstate);
+	lcd_setmode(MODE_16GRAY,vs->physaddr);
+	LCDREG(LCDSADDR3)=(((vwidth-vs->viewwidth)>>2)<<11)|(vs->viewwidth>>2);
+	vscr_program(vs);
+	return 1;
+}
+
+void ggl_vscrexit(gglvscreen *vs)
+{
+	lcd_restore(vs->lcdstate);
+	if(vs->srf.addr) free(vs->srf.addr);
+	vs->srf.addr=0;
+}
+
+void ggl_vscrsetpos(gglvscreen *vs,int x,int y)
+{
+	if(x>vs->srf.width-vs->viewwidth) x=vs->srf.width-vs->viewwidth;
+	if(y>vs->height-vs->viewheight) y=vs->height-vs->viewheight;
+	if(x<0) x=0;
+	if(y<0) y=0;
+	vs->posx=x&~(GGL_VSCR_XSTEP-1);
+	vs->posy=y;
+	vscr_program(vs);
+}
+
+
+// MOVE THE PART OF THE WINDOW THAT STAYS VISIBLE TO (nx,ny), THEN SHOW THE NEW WINDOW
+// (kx,ky) IS THE OFFSET OF THE KEPT AREA WITHIN THE OLD WINDOW, (w,h) ITS SIZE
+static void vscr_rebase(gglvscreen *vs,int kx,int ky,int w,int h,int nx,int ny,int newx,int newy)
+{
+	gglsurface src=vs->srf;
+	gglsurface dst=vs->srf;
+	src.x=vs->posx+kx;
+	src.y=vs->posy+ky;
+	dst.x=nx;
+	dst.y=ny;
+	if(w>0 && h>0) ggl_fastovlblt(&dst,&src,w,h);
+	vs->posx=newx;
+	vs->posy=newy;
+	vscr_program(vs);
+}
+
+int ggl_vscrollup(gglvscreen *vs,int npixels)
+{
+	int keep;
+	if(npixels<=0) return 0;
+	if(npixels>vs->viewheight) npixels=vs->viewheight;
+	if(vs->posy+npixels+vs->viewheight<=vs->height) {
+		vs->posy+=npixels;
+		vscr_program(vs);
+		return npixels;
+	}
+	keep=vs->viewheight-npixels;
+	vscr_rebase(vs,0,npixels,vs->viewwidth,keep,vs->posx,0,vs->posx,0);
+	return npixels;
+}
+
+int ggl_vscrolldn(gglvscreen *vs,int npixels)
+{
+	int keep,top;
+	if(npixels<=0) return 0;
+	if(npixels>vs->viewheight) npixels=vs->viewheight;
+	if(vs->posy>=npixels) {
+		vs->posy-=npixels;
+		vscr_program(vs);
+		return npixels;
+	}
+	keep=vs->viewheight-npixels;
+	top=vs->height-vs->viewheight;
+	vscr_rebase(vs,0,0,vs->viewwidth,keep,vs->posx,top+npixels,vs->posx,top);
+	return npixels;
+}
+
+int ggl_vscrolllf(gglvscreen *vs,int npixels)
+{
+	int keep;
+	npixels&=~(GGL_VSCR_XSTEP-1);
+	if(npixels<=0) return 0;
+	if(npixels>vs->viewwidth) npixels=vs->viewwidth;
+	if(vs->posx+npixels+vs->viewwidth<=vs->srf.width) {
+		vs->posx+=npixels;
+		vscr_program(vs);
+		return npixels;
+	}
+	keep=vs->viewwidth-npixels;
+	vscr_rebase(vs,npixels,0,keep,vs->viewheight,0,vs->posy,0,vs->posy);
+	return npixels;
+}
+
+int ggl_vscrollrt(gglvscreen *vs,int npixels)
+{
+	int keep,left;
+	npixels&=~(GGL_VSCR_XSTEP-1);
+	if(npixels<=0) return 0;
+	if(npixels>vs->viewwidth) npixels=vs->viewwidth;
+	if(vs->posx>=npixels) {
+		vs->posx-=npixels;
+		vscr_program(vs);
+		return npixels;
+	}
+	keep=vs->viewwidth-npixels;
+	left=vs->srf.width-vs->viewwidth;
+	vscr_rebase(vs,0,0,keep,vs->viewheight,left+npixels,vs->posy,left,vs->posy);
+	return npixels;
+}
@@ -0,0 +1,157 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <gui.h>
+
+// BACKING STORE
+// drawsurf.x,y IS THE TOP-LEFT CORNER OF THE CONTROL IN ITS SURFACE AND
+// gUpdate IS IN SURFACE COORDINATES, SO THE STORE IS THE SAME CONTROL ON A
+// SURFACE OF ITS OWN SIZE, WITH THE CORNER AT 0,0
+
+// THE PARENT HAS PAINTED u BY THE TIME THE CONTROL IS ASKED TO UPDATE IT, SO
+// THE SCREEN UNDER u IS THE CURRENT BACKGROUND. IT IS COMPARED WITH THE
+// CAPTURE ON EVERY UPDATE: A DIFFERENCE MEANS THE PARENT DREW SOMETHING NEW
+// UNDER THE CONTROL, THE CAPTURE IS REFRESHED AND THE STORE RENDERED AGAIN
+
+// THE BUFFERS ARE Width PIXELS ROUNDED UP TO WHOLE WORDS, SO THEIR ROWS ARE
+// ALIGNED AND ggl_fastblt PICKS ITS COPY LOOP ONCE PER CALL
+#define BS_WORDS(w,h) ((((w)+7)>>3)*(h))
+
+
+// n (1 TO 8) PIXELS STARTING AT NIBBLE off, THE NEXT WORD IS ONLY READ WHEN
+// THE PIXELS REACH IT
+static inline unsigned int bs_get(int *addr,int off,int n)
+{
+	unsigned int *p=(unsigned int *)addr+(off>>3);
+	int sh=(off&7)<<2;
+
+	if(!sh) return *p;
+	if(n>8-(off&7)) return (p[0]>>sh)|(p[1]<<(32-sh));
+	return p[0]>>sh;
+}
+
+// TRUE IF THE AREA OF a AT ITS x,y MATCHES THE SAME AREA OF b AT ITS x,y
+static BOOL bs_same(gglsurface *a,gglsurface *b,int width,int height)
+{
+	unsigned int m;
+	int y,k,n,oa,ob;
+
+	for(y=0;y<height;++y) {
+		oa=(a->y+y)*a->width+a->x;
+		ob=(b->y+y)*b->width+b->x;
+		for(k=0;k<width;k+=8) {
+			n=(width-k<8)? width-k:8;
+			m=(n==8)? 0xffffffff:(1U<<(n<<2))-1;
+			if((bs_get(a->addr,oa+k,n)^bs_get(b->addr,ob+k,n))&m) return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+
+gBackingStore::gBackingStore()
+{
+	Surface.addr=Back.addr=NULL;
+	Surface.width=Surface.x=Surface.y=0;
+	Back.width=Back.x=Back.y=0;
+	Width=Height=0;
+	Valid=BackValid=FALSE;
+	Rendering=FALSE;
+}
+
+gBackingStore::~gBackingStore()
+{
+	Free();
+}
+
+void gBackingStore::Free()
+{
+	if(Surface.addr) free(Surface.addr);
+	if(Back.addr) free(Back.addr);
+	Surface.addr=Back.addr=NULL;
+	Width=Height=0;
+	Valid=BackValid=FALSE;
+}
+
+BOOL gBackingStore::Update(gControl *ctl,gUpdate *u)
+{
+	gglsurface screen,dest;
+	gUpdate all;
+	int x1,y1,x2,y2,cx1,cy1,cx2,cy2;
+
+	// WHILE RENDERING, THE CONTROL DRAWS ITSELF INTO THE STORE
+	if(Rendering || ctl->FirstChild || ctl->sizex<=0 || ctl->sizey<=0) return FALSE;
+
+	screen=ctl->drawsurf;
+	if(ctl->sizex!=Width || ctl->sizey!=Height) {
+		if(!Surface.addr || BS_WORDS(ctl->sizex,ctl->sizey)!=BS_WORDS(Width,Height)) {
+			Free();
+			Surface.addr=(int *)malloc(BS_WORDS(ctl->sizex,ctl->sizey)*sizeof(int));
+			Back.addr=(int *)malloc(BS_WORDS(ctl->sizex,ctl->sizey)*sizeof(int));
+			if(!Surface.addr || !Back.addr) {
+				Free();
+				return FALSE;		// OUT OF MEMORY, DRAW DIRECTLY
+			}
+		}
+		Width=ctl->sizex;
+		Height=ctl->sizey;
+		Surface.width=Back.width=(Width+7)&~7;
+		Valid=BackValid=FALSE;
+	}
+
+	// THE PART OF u COVERED BY THE CONTROL, IN SURFACE COORDINATES
+	x1=(u->clipx>screen.x)? u->clipx:screen.x;
+	y1=(u->clipy>screen.y)? u->clipy:screen.y;
+	x2=(u->clipx2<screen.x+Width-1)? u->clipx2:screen.x+Width-1;
+	y2=(u->clipy2<screen.y+Height-1)? u->clipy2:screen.y+Height-1;
+	if(x1>x2 || y1>y2) return TRUE;
+
+	// CAPTURE THE BACKGROUND UNDER u. UNTIL ONE UPDATE HAS COVERED THE WHOLE
+	// CONTROL THE REST OF THE SCREEN MAY STILL HOLD ANYTHING, SO THE CONTROL
+	// DRAWS DIRECTLY
+	dest=screen;
+	dest.x=x1;
+	dest.y=y1;
+	Back.x=x1-screen.x;
+	Back.y=y1-screen.y;
+	if(!BackValid) {
+		if(x2-x1+1<Width || y2-y1+1<Height) return FALSE;
+		ggl_fastblt(&Back,&dest,Width,Height);
+		BackValid=TRUE;
+		Valid=FALSE;
+	}
+	else if(!bs_same(&Back,&dest,x2-x1+1,y2-y1+1)) {
+		ggl_fastblt(&Back,&dest,x2-x1+1,y2-y1+1);
+		Valid=FALSE;
+	}
+	Back.x=Back.y=0;
+
+	if(!Valid) {
+		// START FROM THE BACKGROUND, THEN LET THE CONTROL DRAW ON THE STORE
+		Surface.x=Surface.y=0;
+		ggl_fastblt(&Surface,&Back,Width,Height);
+		cx1=ctl->clipx; cy1=ctl->clipy; cx2=ctl->clipx2; cy2=ctl->clipy2;
+		ctl->drawsurf=Surface;
+		all.clipx=all.clipy=0;
+		all.clipx2=Width-1;
+		all.clipy2=Height-1;
+		Rendering=TRUE;
+		ctl->Update(&all);
+		Rendering=FALSE;
+		ctl->drawsurf=screen;
+		ctl->clipx=cx1; ctl->clipy=cy1; ctl->clipx2=cx2; ctl->clipy2=cy2;
+		Valid=TRUE;
+	}
+
+	Surface.x=x1-screen.x;
+	Surface.y=y1-screen.y;
+	ggl_fastblt(&dest,&Surface,x2-x1+1,y2-y1+1);
+	Surface.x=Surface.y=0;
+	return TRUE;
+}
@@ -0,0 +1,377 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <gui.h>
+
+// DISPLAY LIST RECORDER/EXECUTOR
+
+// RECORD FORMAT (WORDS):
+// GCMD_HLINE, GCMD_VLINE, GCMD_RECT: CMD, X1|X2<<16, Y1|Y2<<16, COLOR
+// GCMD_DRAWICON: CMD, X1|X2<<16, Y1|Y2<<16, ICONWIDTH, ICONX|ICONY<<16, DATA
+// DATA IS THE ICON POINTER, COPIED INTO AS MANY WORDS AS IT TAKES
+// ALL COORDINATES ARE ALREADY CLIPPED, SO THEY ARE NEVER NEGATIVE
+
+#define DL_MAXCOORD 0x7fff
+#define DL_PTRWORDS ((int)((sizeof(unsigned int *)+sizeof(unsigned int)-1)/sizeof(unsigned int)))
+#define DL_ICONWORDS (5+DL_PTRWORDS)
+#define DL_PACK(a,b) ((unsigned int)(a)|((unsigned int)(b)<<16))
+#define DL_LO(a) ((int)((a)&0xffff))
+#define DL_HI(a) ((int)((a)>>16))
+
+// UNPACKED COMMAND, ONLY USED DURING EXECUTE
+struct gDLItem {
+	int Cmd;
+	int x1,y1,x2,y2;
+	unsigned int Color;
+	unsigned int *Data;
+	int IconWidth,IconX,IconY;
+};
+
+
+gDisplayList::gDisplayList()
+{
+	Buffer=NULL;
+	Used=Size=0;
+	Clear();
+}
+
+gDisplayList::gDisplayList(int initialwords)
+{
+	Buffer=NULL;
+	Used=Size=0;
+	Grow(initialwords);
+	Clear();
+}
+
+gDisplayList::~gDisplayList()
+{
+	if(Buffer) free(Buffer);
+}
+
+BOOL gDisplayList::Grow(int nwords)
+{
+	// ALWAYS KEEP ROOM FOR THE GCMD_END TERMINATOR
+	if(Used+nwords+1<=Size) return TRUE;
+	int newsize=(Used+nwords+1+DLIST_GROUP-1)&~(DLIST_GROUP-1);
+	unsigned int *newbuf=(unsigned int *)realloc(Buffer,newsize*sizeof(unsigned int));
+	if(!newbuf) return FALSE;
+	Buffer=newbuf;
+	Size=newsize;
+	return TRUE;
+}
+
+void gDisplayList::Clear()
+{
+	Used=0;
+	NumCmds=0;
+	if(Buffer) Buffer[0]=GCMD_END;
+	ClearClip();
+}
+
+void gDisplayList::ClearClip()
+{
+	clipx=clipy=0;
+	clipx2=clipy2=DL_MAXCOORD;
+}
+
+void gDisplayList::SetClip(int x1,int y1,int x2,int y2)
+{
+	clipx=(x1<0)? 0:x1;
+	clipy=(y1<0)? 0:y1;
+	clipx2=(x2>DL_MAXCOORD)? DL_MAXCOORD:x2;
+	clipy2=(y2>DL_MAXCOORD)? DL_MAXCOORD:y2;
+}
+
+// CLIP AND STORE A 4-WORD RECORD
+static BOOL dl_addrect(gDisplayList *dl,int cmd,int x1,int y1,int x2,int y2,int color)
+{
+	int t;
+	if(x1>x2) { t=x1; x1=x2; x2=t; }
+	if(y1>y2) { t=y1; y1=y2; y2=t; }
+	if(x1<dl->clipx) x1=dl->clipx;
+	if(y1<dl->clipy) y1=dl->clipy;
+	if(x2>dl->clipx2) x2=dl->clipx2;
+	if(y2>dl->clipy2) y2=dl->clipy2;
+	if(x1>x2 || y1>y2) return TRUE;	// NOTHING TO DRAW
+
+	if(!dl->Grow(4)) return FALSE;
+	unsigned int *ptr=dl->Buffer+dl->Used;
+	ptr[0]=cmd;
+	ptr[1]=DL_PACK(x1,x2);
+	ptr[2]=DL_PACK(y1,y2);
+	ptr[3]=(unsigned int)color;
+	ptr[4]=GCMD_END;
+	dl->Used+=4;
+	++dl->NumCmds;
+	return TRUE;
+}
+
+BOOL gDisplayList::HLine(int y,int x1,int x2,int pattern)
+{
+	return dl_addrect(this,GCMD_HLINE,x1,y,x2,y,pattern);
+}
+
+BOOL gDisplayList::VLine(int x,int y1,int y2,int pattern)
+{
+	return dl_addrect(this,GCMD_VLINE,x,y1,x,y2,pattern);
+}
+
+BOOL gDisplayList::Rect(int x1,int y1,int x2,int y2,int pattern)
+{
+	return dl_addrect(this,GCMD_RECT,x1,y1,x2,y2,pattern);
+}
+
+BOOL gDisplayList::DrawIcon(int x,int y,unsigned int *IconData,int width,int height)
+{
+	return DrawIconPartial(x,y,IconData,width,0,0,width,height);
+}
+
+BOOL gDisplayList::DrawIconPartial(int x,int y,unsigned int *IconData,int iconwidth,int iconx,int icony,int width,int height)
+{
+	int x2=x+width-1,y2=y+height-1;
+
+	if(x<clipx) { iconx+=clipx-x; x=clipx; }
+	if(y<clipy) { icony+=clipy-y; y=clipy; }
+	if(x2>clipx2) x2=clipx2;
+	if(y2>clipy2) y2=clipy2;
+	if(x>x2 || y>y2) return TRUE;
+
+	if(!Grow(DL_ICONWORDS)) return FALSE;
+	unsigned int *ptr=Buffer+Used;
+	ptr[0]=GCMD_DRAWICON;
+	ptr[1]=DL_PACK(x,x2);
+	ptr[2]=DL_PACK(y,y2);
+	ptr[3]=iconwidth;
+	ptr[4]=DL_PACK(iconx,icony);
+	memcpy(ptr+5,&IconData,sizeof(unsigned int *));
+	ptr[DL_ICONWORDS]=GCMD_END;
+	Used+=DL_ICONWORDS;
+	++NumCmds;
+	return TRUE;
+}
+
+
+// DRAW THE ROWS [ys,ye] OF A SINGLE ITEM
+static void dl_draw(gglsurface *surf,gDLItem *it,int ys,int ye)
+{
+	if(ys<it->y1) ys=it->y1;
+	if(ye>it->y2) ye=it->y2;
+	if(ys>ye) return;
+
+	switch(it->Cmd)
+	{
+	case GCMD_HLINE:
+	case GCMD_RECT:
+		ggl_rect(surf,it->x1,ys,it->x2,ye,it->Color);
+		break;
+	case GCMD_VLINE:
+		ggl_vline(surf,it->x1,ys,ye,it->Color);
+		break;
+	case GCMD_DRAWICON:
+	{
+		gglsurface icon;
+		icon.addr=(int *)it->Data;
+		icon.width=it->IconWidth;
+		icon.x=it->IconX;
+		icon.y=it->IconY+ys-it->y1;
+		surf->x=it->x1;
+		surf->y=ys;
+		ggl_fastblt(surf,&icon,it->x2-it->x1+1,ye-ys+1);
+		break;
+	}
+	}
+}
+
+// UNPACK ONE RECORD, RETURN POINTER TO THE NEXT ONE
+static unsigned int *dl_unpack(unsigned int *ptr,gDLItem *it)
+{
+	it->Cmd=ptr[0];
+	it->x1=DL_LO(ptr[1]);
+	it->x2=DL_HI(ptr[1]);
+	it->y1=DL_LO(ptr[2]);
+	it->y2=DL_HI(ptr[2]);
+	if(it->Cmd==GCMD_DRAWICON) {
+		it->IconWidth=ptr[3];
+		it->IconX=DL_LO(ptr[4]);
+		it->IconY=DL_HI(ptr[4]);
+		memcpy(&it->Data,ptr+5,sizeof(unsigned int *));
+		return ptr+DL_ICONWORDS;
+	}
+	it->Color=ptr[3];
+	return ptr+4;
+}
+
+// CLIP AN ITEM TO u, RETURN FALSE IF NOTHING IS LEFT
+static BOOL dl_clip(gDLItem *it,gUpdate *u)
+{
+	if(!u) return TRUE;
+	if(it->x1<u->clipx) {
+		if(it->Cmd==GCMD_DRAWICON) it->IconX+=u->clipx-it->x1;
+		it->x1=u->clipx;
+	}
+	if(it->y1<u->clipy) {
+		if(it->Cmd==GCMD_DRAWICON) it->IconY+=u->clipy-it->y1;
+		it->y1=u->clipy;
+	}
+	if(it->x2>u->clipx2) it->x2=u->clipx2;
+	if(it->y2>u->clipy2) it->y2=u->clipy2;
+	return it->x1<=it->x2 && it->y1<=it->y2;
+}
+
+static inline int dl_area(gDLItem *it)
+{
+	return (it->x2-it->x1+1)*(it->y2-it->y1+1);
+}
+
+// TRUE IF b CAN BE FOLDED INTO a, WITH NOTHING DRAWN IN BETWEEN
+// PATTERNS ARE ALWAYS ALIGNED TO THE SURFACE, SO ANY UNION OF TWO
+// TOUCHING/OVERLAPPING BOXES OF THE SAME COLOR IS PIXEL-EXACT
+static BOOL dl_merge(gDLItem *a,gDLItem *b)
+{
+	if(a->Color!=b->Color) return FALSE;
+
+	if(a->Cmd==GCMD_VLINE || b->Cmd==GCMD_VLINE) {
+		// VLINE PATTERNS RUN VERTICALLY, ONLY MERGE STACKED VLINES
+		if(a->Cmd!=b->Cmd || a->x1!=b->x1) return FALSE;
+		if(b->y1>a->y2+1 || b->y2<a->y1-1) return FALSE;
+	}
+	else {
+		if(a->Cmd==GCMD_DRAWICON || b->Cmd==GCMD_DRAWICON) return FALSE;
+		if(a->x1==b->x1 && a->x2==b->x2) {
+			if(b->y1>a->y2+1 || b->y2<a->y1-1) return FALSE;
+		}
+		else if(a->y1==b->y1 && a->y2==b->y2) {
+			if(b->x1>a->x2+1 || b->x2<a->x1-1) return FALSE;
+		}
+		else return FALSE;
+		a->Cmd=GCMD_RECT;
+	}
+
+	if(b->x1<a->x1) a->x1=b->x1;
+	if(b->x2>a->x2) a->x2=b->x2;
+	if(b->y1<a->y1) a->y1=b->y1;
+	if(b->y2>a->y2) a->y2=b->y2;
+	return TRUE;
+}
+
+void gDisplayList::Execute(gglsurface *surf,gUpdate *clip)
+{
+	gDLItem *items,*it,*covers[DLIST_COVERS];
+	unsigned int *ptr;
+	int *start,*order,*active,*next,*swap;
+	int k,j,n,nc,last,miny,maxy,nbands,b,nact,m,idx,by,bye;
+	gglsurface dest;
+
+	if(!NumCmds) return;
+
+	dest=*surf;
+
+	items=(gDLItem *)malloc(NumCmds*sizeof(gDLItem));
+
+	if(!items) {
+		// NOT ENOUGH MEMORY TO OPTIMIZE, DRAW IN RECORDED ORDER
+		gDLItem one;
+		ptr=Buffer;
+		while(*ptr!=GCMD_END) {
+			ptr=dl_unpack(ptr,&one);
+			if(dl_clip(&one,clip)) dl_draw(&dest,&one,one.y1,one.y2);
+		}
+		return;
+	}
+
+	// UNPACK AND CLIP ONCE, DROPPING WHAT FALLS OUTSIDE THE DAMAGE
+	ptr=Buffer;
+	for(k=n=0;k<NumCmds;++k) {
+		ptr=dl_unpack(ptr,items+n);
+		if(dl_clip(items+n,clip)) ++n;
+	}
+
+	// DROP ITEMS FULLY COVERED BY A LATER ONE (ALL PRIMITIVES ARE OPAQUE).
+	// GOING BACKWARDS, EACH ITEM IS ONLY TESTED AGAINST THE DLIST_COVERS
+	// LARGEST ITEMS AFTER IT, DEAD ITEMS ARE MARKED WITH Cmd=GCMD_END
+	nc=0;
+	for(k=n-1;k>=0;--k) {
+		it=items+k;
+		for(j=0;j<nc;++j) {
+			if(covers[j]->x1<=it->x1 && covers[j]->x2>=it->x2 && covers[j]->y1<=it->y1 && covers[j]->y2>=it->y2) break;
+		}
+		if(j<nc) {
+			it->Cmd=GCMD_END;
+			continue;
+		}
+		if(nc<DLIST_COVERS) covers[nc++]=it;
+		else {
+			for(m=0,j=1;j<nc;++j) if(dl_area(covers[j])<dl_area(covers[m])) m=j;
+			if(dl_area(it)>dl_area(covers[m])) covers[m]=it;
+		}
+	}
+
+	// MERGE THE SURVIVORS WITH THE PREVIOUS ONE
+	last=-1;
+	for(k=j=0;k<n;++k) {
+		it=items+k;
+		if(it->Cmd==GCMD_END) continue;
+		if(last>=0 && dl_merge(items+last,it)) continue;
+		last=j;
+		if(j!=k) items[j]=*it;
+		++j;
+	}
+	n=j;
+
+	miny=DL_MAXCOORD;
+	maxy=0;
+	for(k=0;k<n;++k) {
+		if(items[k].y1<miny) miny=items[k].y1;
+		if(items[k].y2>maxy) maxy=items[k].y2;
+	}
+	nbands=(n)? (maxy-miny)/DLIST_BANDHEIGHT+1:0;
+
+	start=(nbands)? (int *)malloc((nbands+1+3*n)*sizeof(int)):NULL;
+	if(!start) {
+		for(k=0;k<n;++k) dl_draw(&dest,items+k,items[k].y1,items[k].y2);
+		free(items);
+		return;
+	}
+	order=start+nbands+1;
+	active=order+n;
+	next=active+n;
+
+	// BUCKET THE ITEMS BY THE BAND OF THEIR FIRST ROW, IN RECORDED ORDER
+	for(b=0;b<=nbands;++b) start[b]=0;
+	for(k=0;k<n;++k) ++start[(items[k].y1-miny)/DLIST_BANDHEIGHT+1];
+	for(b=0;b<nbands;++b) start[b+1]+=start[b];
+	for(k=0;k<n;++k) order[start[(items[k].y1-miny)/DLIST_BANDHEIGHT]++]=k;
+	for(b=nbands;b>0;--b) start[b]=start[b-1];
+	start[0]=0;
+
+	// DRAW BAND BY BAND. THE ITEMS OF A BAND ARE THOSE STILL ACTIVE FROM THE
+	// BANDS ABOVE PLUS THE ONES STARTING IN IT, BOTH LISTS ARE IN RECORDED
+	// ORDER AND ARE MERGED BY INDEX
+	nact=0;
+	for(b=0;b<nbands;++b) {
+		by=miny+b*DLIST_BANDHEIGHT;
+		bye=by+DLIST_BANDHEIGHT-1;
+		k=0;
+		j=start[b];
+		m=0;
+		while(k<nact || j<start[b+1]) {
+			if(j>=start[b+1] || (k<nact && active[k]<order[j])) idx=active[k++];
+			else idx=order[j++];
+			dl_draw(&dest,items+idx,by,bye);
+			if(items[idx].y2>bye) next[m++]=idx;
+		}
+		swap=active;
+		active=next;
+		next=swap;
+		nact=m;
+	}
+
+	free(start);
+	free(items);
+}
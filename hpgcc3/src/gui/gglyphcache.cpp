@@ -0,0 +1,285 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <gui.h>
+
+// GLYPH CACHE
+
+// GLYPH FORMAT: Height ROWS OF (Width+7)/8 WORDS, PIXEL i OF A ROW IN NIBBLE
+// i&7 OF WORD i>>3, 0xF=INK, 0=PAPER. THE PADDING NIBBLES ARE ALWAYS 0.
+// GLYPHS ARE RENDERED ONCE BY THE LIBRARY'S OWN TEXT ROUTINE INTO A PLAIN
+// SURFACE OVER THE GLYPH BUFFER, SO THE CACHE DOESN'T DEPEND ON THE LAYOUT
+// OF THE FONT BITMAP
+
+#define GC_MAXCOORD 0x7fffffff
+
+static gGlyphCache *gc_list=NULL;	// SHARED CACHES, ONE PER gFontData
+
+
+gGlyphCache::gGlyphCache(gFont *f) : Font(*f)
+{
+	int k,w;
+
+	FontData=f->FontData;
+	Height=Font.TextHeight();
+	MaxWidth=0;
+	for(k=0;k<256;++k) {
+		w=(k)? Font.CharWidth((char)k):0;
+		if(w<0) w=0;
+		if(w>255) w=255;
+		Width[k]=(unsigned char)w;
+		if(w>MaxWidth) MaxWidth=w;
+		Glyph[k]=NULL;
+	}
+	for(k=0;k<8;++k) Loaded[k]=0;
+	Strip=NULL;
+	StripSize=0;
+	Next=NULL;
+}
+
+gGlyphCache::~gGlyphCache()
+{
+	gGlyphCache **ptr;
+
+	Flush();
+	if(Strip) free(Strip);
+
+	for(ptr=&gc_list;*ptr;ptr=&(*ptr)->Next) {
+		if(*ptr==this) { *ptr=Next; break; }
+	}
+}
+
+void gGlyphCache::Flush()
+{
+	int k;
+	for(k=0;k<256;++k) {
+		if(Glyph[k]) free(Glyph[k]);
+		Glyph[k]=NULL;
+	}
+	for(k=0;k<8;++k) Loaded[k]=0;
+}
+
+gGlyphCache *gGlyphCache::Get(gFont *f)
+{
+	gGlyphCache *gc;
+
+	for(gc=gc_list;gc;gc=gc->Next) if(gc->FontData==f->FontData) return gc;
+
+	gc=new gGlyphCache(f);
+	if(!gc) return NULL;
+	gc->Next=gc_list;
+	gc_list=gc;
+	return gc;
+}
+
+void gGlyphCache::FlushAll()
+{
+	gGlyphCache *gc;
+	for(gc=gc_list;gc;gc=gc->Next) gc->Flush();
+}
+
+// RENDER CHARACTER c AT THE CORNER OF surf, CLIPPED TO width x height
+// gFontData IS ONLY READ BY THE LIBRARY, SO ITS DrawText RUNS ON A DETACHED
+// CONTROL SIZED AND CLIPPED THROUGH ITS PUBLIC MEMBERS, DRAWING ON surf
+static void gc_render(gFont *f,gglsurface *surf,int width,int height,int c)
+{
+	gControl target;
+	char text[2];
+
+	target.Resize(surf->width,height);
+	target.drawsurf=*surf;
+	target.SetClipRegion(0,0,width-1,height-1);
+	text[0]=(char)c;
+	text[1]=0;
+	target.DrawText(0,0,text,f,GBLACK);
+}
+
+BOOL gGlyphCache::Load(int c)
+{
+	gglsurface surf;
+	int w,nw;
+	unsigned int *glyph;
+
+	c&=0xff;
+	w=Width[c];
+	nw=(w+7)>>3;
+	if(!w || !Height) {
+		// NOTHING TO DRAW, JUST REMEMBER IT'S BEEN LOOKED AT
+		Loaded[c>>5]|=1u<<(c&31);
+		return TRUE;
+	}
+
+	glyph=(unsigned int *)malloc(nw*Height*sizeof(unsigned int));
+	if(!glyph) return FALSE;
+	memset((char *)glyph,0,nw*Height*sizeof(unsigned int));
+
+	// THE ROWS ARE PADDED TO WHOLE WORDS, CLIPPED TO THE GLYPH WIDTH SO THE
+	// PADDING STAYS CLEAR
+	surf.addr=(int *)glyph;
+	surf.width=nw<<3;
+	surf.x=surf.y=0;
+	gc_render(&Font,&surf,w,Height,c);
+
+	Glyph[c]=glyph;
+	Loaded[c>>5]|=1u<<(c&31);
+	return TRUE;
+}
+
+int gGlyphCache::TextWidth(const char *Text)
+{
+	int w=0;
+	while(*Text) w+=Width[(unsigned char)*Text++];
+	return w;
+}
+
+
+// STORE ONE GLYPH WITH ITS TOP-LEFT CORNER AT (x,y), ONLY INSIDE [cx1,cx2]x[cy1,cy2]
+// THE GLYPH ROWS ARE SHIFTED TO THE DESTINATION NIBBLE AND MERGED WITH
+// ONE OR TWO MASKED WORD STORES PER GLYPH WORD
+static void gc_put(unsigned int *addr,int width,unsigned int *glyph,int gw,int h,int x,int y,
+		int cx1,int cx2,int cy1,int cy2,unsigned int color)
+{
+	int nw=(gw+7)>>3,r,r1,r2,c1,c2,k,k1,k2,off,sh;
+	unsigned int m,lo,hi,lmask,rmask,*p,*g;
+
+	r1=(y<cy1)? cy1-y:0;
+	r2=(y+h-1>cy2)? cy2-y:h-1;
+	c1=(x<cx1)? cx1-x:0;
+	c2=(x+gw-1>cx2)? cx2-x:gw-1;
+	if(r1>r2 || c1>c2) return;
+
+	k1=c1>>3;
+	k2=c2>>3;
+	lmask=0xffffffffU<<((c1&7)<<2);
+	rmask=0xffffffffU>>((7-(c2&7))<<2);
+	if(k1==k2) lmask=rmask=lmask&rmask;
+
+	for(r=r1;r<=r2;++r) {
+		off=(y+r)*width+x+(k1<<3);
+		// CLIPPED PIXELS NEVER REACH A WORD BEFORE THE SURFACE, BUT off>>3 MAY
+		// POINT THERE: ONLY WORDS WITH VISIBLE PIXELS ARE WRITTEN
+		p=addr+(off>>3);
+		sh=(off&7)<<2;
+		g=glyph+r*nw+k1;
+		for(k=k1;k<=k2;++k,++g,++p) {
+			m=*g;
+			if(k==k1) m&=lmask;
+			if(k==k2) m&=rmask;
+			if(!m) continue;
+			lo=m<<sh;
+			if(lo) *p=(*p&~lo)|(color&lo);
+			if(sh) {
+				hi=m>>(32-sh);
+				if(hi) p[1]=(p[1]&~hi)|(color&hi);
+			}
+		}
+	}
+}
+
+void gGlyphCache::DrawText(gglsurface *surf,gUpdate *clip,int x,int y,const char *Text,int color)
+{
+	int cx1=0,cy1=0,cx2=surf->width-1,cy2=GC_MAXCOORD,c;
+
+	if(clip) {
+		cx1=clip->clipx;
+		cy1=clip->clipy;
+		cx2=clip->clipx2;
+		cy2=clip->clipy2;
+	}
+	if(y>cy2 || y+Height-1<cy1) return;
+
+	while(*Text && x<=cx2) {
+		c=(unsigned char)*Text++;
+		if(!(Loaded[c>>5]&(1u<<(c&31)))) Load(c);
+		if(Glyph[c] && x+Width[c]>cx1)
+			gc_put((unsigned int *)surf->addr,surf->width,Glyph[c],Width[c],Height,x,y,cx1,cx2,cy1,cy2,(unsigned int)color);
+		x+=Width[c];
+	}
+}
+
+void gGlyphCache::DrawTextBk(gglsurface *surf,gUpdate *clip,int x,int y,const char *Text,int color,int BkColor)
+{
+	int cx1=0,cy1=0,cx2=surf->width-1,cy2=GC_MAXCOORD;
+	int x1=x,y1=y,x2=x+TextWidth(Text)-1,y2=y+Height-1;
+
+	if(clip) {
+		cx1=clip->clipx;
+		cy1=clip->clipy;
+		cx2=clip->clipx2;
+		cy2=clip->clipy2;
+	}
+	if(x1<cx1) x1=cx1;
+	if(y1<cy1) y1=cy1;
+	if(x2>cx2) x2=cx2;
+	if(y2>cy2) y2=cy2;
+	if(x1>x2 || y1>y2) return;
+
+	ggl_rect(surf,x1,y1,x2,y2,BkColor);
+	DrawText(surf,clip,x,y,Text,color);
+}
+
+
+// COMPOSE A WHOLE STRING IN THE SCRATCH STRIP, RETURN ITS WIDTH IN PIXELS
+// THE STRIP IS *stripwidth PIXELS WIDE (MULTIPLE OF 8), FILLED WITH bk FIRST
+static int gc_compose(gGlyphCache *gc,const char *Text,unsigned int color,unsigned int bk,int *stripwidth)
+{
+	int tw=gc->TextWidth(Text),sw=(tw+7)&~7,nwords=(sw>>3)*gc->Height,x,c,k;
+
+	if(!tw || !gc->Height) return 0;
+
+	if(nwords>gc->StripSize) {
+		int newsize=(nwords+GLYPHCACHE_GROUP-1)&~(GLYPHCACHE_GROUP-1);
+		unsigned int *newbuf=(unsigned int *)realloc(gc->Strip,newsize*sizeof(unsigned int));
+		if(!newbuf) return 0;
+		gc->Strip=newbuf;
+		gc->StripSize=newsize;
+	}
+	for(k=0;k<nwords;++k) gc->Strip[k]=bk;
+
+	x=0;
+	while(*Text) {
+		c=(unsigned char)*Text++;
+		if(!(gc->Loaded[c>>5]&(1u<<(c&31)))) gc->Load(c);
+		if(gc->Glyph[c])
+			gc_put(gc->Strip,sw,gc->Glyph[c],gc->Width[c],gc->Height,x,0,0,sw-1,0,gc->Height-1,color);
+		x+=gc->Width[c];
+	}
+	*stripwidth=sw;
+	return tw;
+}
+
+// OPAQUE TEXT IS A SINGLE ICON, CLIPPED AND PLACED BY THE CONTROL
+void gGlyphCache::DrawTextBk(gControl *ctl,int x,int y,const char *Text,int color,int BkColor)
+{
+	int sw,tw=gc_compose(this,Text,(unsigned int)color,(unsigned int)BkColor,&sw);
+	if(!tw) {
+		// OUT OF MEMORY, LET THE LIBRARY DO IT
+		if(*Text) ctl->DrawTextBk(x,y,(char *)Text,&Font,color,BkColor);
+		return;
+	}
+	ctl->DrawIconPartial(x,y,Strip,sw,0,0,tw,Height);
+}
+
+// TRANSPARENT TEXT IS STORED STRAIGHT INTO THE SURFACE OF THE CONTROL.
+// drawsurf.x,y IS THE CORNER OF THE CONTROL, THE CLIENT AREA STARTS ncx,ncy
+// FROM IT SCROLLED BY viewx,viewy, AND THE CLIPPING AREA IS IN SURFACE
+// COORDINATES
+void gGlyphCache::DrawText(gControl *ctl,int x,int y,const char *Text,int color)
+{
+	gUpdate clip;
+	int ox=ctl->drawsurf.x+ctl->ncx,oy=ctl->drawsurf.y+ctl->ncy;
+
+	clip.clipx=(ctl->clipx>ox)? ctl->clipx:ox;
+	clip.clipy=(ctl->clipy>oy)? ctl->clipy:oy;
+	clip.clipx2=(ctl->clipx2<ox+ctl->ncwidth-1)? ctl->clipx2:ox+ctl->ncwidth-1;
+	clip.clipy2=(ctl->clipy2<oy+ctl->ncheight-1)? ctl->clipy2:oy+ctl->ncheight-1;
+	if(clip.clipx>clip.clipx2 || clip.clipy>clip.clipy2) return;
+
+	DrawText(&ctl->drawsurf,&clip,ox-ctl->viewx+x,oy-ctl->viewy+y,Text,color);
+}
@@ -0,0 +1,485 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <gui.h>
+
+// LINE INDEX
+// AN EDIT OF b BYTES AT p CAN ONLY CHANGE WHETHER p TO p+b+1 ARE LINE
+// STARTS: A START DEPENDS ON THE CHARACTER BEFORE IT, AND AFTER A \r ALSO
+// ON ITS OWN. EVERYTHING PAST THAT JUST MOVES BY b.
+// INSERTS OR DELETES OF MORE THAN HALF THE TEXT REBUILD THE INDEX.
+
+
+static BOOL li_grow(gLineIndex *li)
+{
+	gLineChunk *c;
+
+	if(li->NumChunks<li->MaxChunks) return TRUE;
+	c=(gLineChunk *)realloc(li->Chunks,(li->MaxChunks+LINEINDEX_GROUP)*sizeof(gLineChunk));
+	if(!c) return FALSE;
+	li->Chunks=c;
+	li->MaxChunks+=LINEINDEX_GROUP;
+	return TRUE;
+}
+
+
+gLineIndex::gLineIndex(gLineSource src,void *ctx)
+{
+	Chunks=NULL;
+	MaxChunks=0;
+	Source=src;
+	Context=ctx;
+	Clear();
+}
+
+gLineIndex::~gLineIndex()
+{
+	if(Chunks) free(Chunks);
+}
+
+void gLineIndex::Clear()
+{
+	NumChunks=0;
+	NumStarts=0;
+	Length=0;
+	PendChunk=PendDelta=0;
+	FirstValid=-1;
+	Valid=FALSE;
+}
+
+BOOL gLineIndex::Build(int length)
+{
+	int q;
+
+	Clear();
+	Length=length;
+	Valid=TRUE;
+	for(q=1;q<=length;++q) {
+		if(IsStart(q) && !Add(q)) {
+			Valid=FALSE;
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+BOOL gLineIndex::IsStart(int offset)
+{
+	int c;
+
+	if(offset<=0 || offset>Length) return FALSE;
+	c=Source(Context,offset-1);
+	if(c=='\n') return TRUE;
+	return c=='\r' && Source(Context,offset)!='\n';
+}
+
+int gLineIndex::Find(int offset,int *k)
+{
+	gLineChunk *c;
+	int lo,hi,mid,j,rel;
+
+	j=-1;
+	lo=0;
+	hi=NumChunks-1;
+	while(lo<=hi) {
+		mid=(lo+hi)>>1;
+		if(Abs(mid,0)<=offset) { j=mid; lo=mid+1; }
+		else hi=mid-1;
+	}
+	if(j<0) return -1;
+
+	c=&Chunks[j];
+	rel=offset-c->Base-((j>=PendChunk)? PendDelta:0);
+	lo=0;
+	hi=c->Count-1;
+	*k=0;
+	while(lo<=hi) {
+		mid=(lo+hi)>>1;
+		if(c->Start[mid]<=rel) { *k=mid; lo=mid+1; }
+		else hi=mid-1;
+	}
+	return j;
+}
+
+// MAKE PendChunk=chunk, WITHOUT CHANGING ANY OFFSET
+void gLineIndex::MovePending(int chunk)
+{
+	int j;
+
+	if(PendDelta) {
+		for(j=PendChunk;j<chunk;++j) Chunks[j].Base+=PendDelta;
+		for(j=chunk;j<PendChunk;++j) Chunks[j].Base-=PendDelta;
+	}
+	PendChunk=chunk;
+}
+
+void gLineIndex::FixFirst(int chunk)
+{
+	if(!NumChunks) return;
+	if(FirstValid<0) {
+		Chunks[0].First=1;
+		FirstValid=0;
+	}
+	for(;FirstValid<chunk;++FirstValid) Chunks[FirstValid+1].First=Chunks[FirstValid].First+Chunks[FirstValid].Count;
+}
+
+BOOL gLineIndex::Add(int offset)
+{
+	gLineChunk *c,*n;
+	int j,k,h;
+
+	j=Find(offset,&k);
+	if(j<0) {
+		if(!NumChunks) {
+			if(!li_grow(this)) return FALSE;
+			Chunks[0].Base=0;
+			Chunks[0].Count=0;
+			NumChunks=1;
+		}
+		j=0;
+		k=-1;
+	}
+
+	if(Chunks[j].Count==LINEINDEX_CHUNK) {
+		if(!li_grow(this)) return FALSE;
+		memmove(&Chunks[j+2],&Chunks[j+1],(NumChunks-j-1)*sizeof(gLineChunk));
+		++NumChunks;
+		if(PendChunk>j) ++PendChunk;
+		c=&Chunks[j];
+		n=&Chunks[j+1];
+		n->Base=c->Base;
+		// APPENDING STARTS AN EMPTY CHUNK, SO A BUILD LEAVES THEM FULL
+		h=(k==LINEINDEX_CHUNK-1)? LINEINDEX_CHUNK:LINEINDEX_CHUNK/2;
+		n->Count=LINEINDEX_CHUNK-h;
+		memcpy(n->Start,c->Start+h,n->Count*sizeof(int));
+		c->Count=h;
+		if(FirstValid>j) FirstValid=j;
+		if(k>=h || h==LINEINDEX_CHUNK) { ++j; k-=h; }
+	}
+
+	c=&Chunks[j];
+	memmove(c->Start+k+2,c->Start+k+1,(c->Count-k-1)*sizeof(int));
+	c->Start[k+1]=offset-c->Base-((j>=PendChunk)? PendDelta:0);
+	++c->Count;
+	++NumStarts;
+	if(FirstValid>j) FirstValid=j;
+	return TRUE;
+}
+
+void gLineIndex::Remove(int j,int k)
+{
+	gLineChunk *c=&Chunks[j],*n;
+	int i;
+
+	memmove(c->Start+k,c->Start+k+1,(c->Count-k-1)*sizeof(int));
+	--c->Count;
+	--NumStarts;
+
+	if(!c->Count) {
+		memmove(c,c+1,(NumChunks-j-1)*sizeof(gLineChunk));
+		--NumChunks;
+		if(PendChunk>j) --PendChunk;
+		if(FirstValid>=j) FirstValid=j-1;
+		return;
+	}
+	if(FirstValid>j) FirstValid=j;
+
+	// MERGE SMALL NEIGHBORS, SO DELETES DON'T LEAVE A TRAIL OF TINY CHUNKS
+	if(j+1<NumChunks && c->Count+c[1].Count<=LINEINDEX_CHUNK/2) {
+		n=c+1;
+		for(i=0;i<n->Count;++i) c->Start[c->Count+i]=Abs(j+1,i)-c->Base-((j>=PendChunk)? PendDelta:0);
+		c->Count+=n->Count;
+		memmove(n,n+1,(NumChunks-j-2)*sizeof(gLineChunk));
+		--NumChunks;
+		if(PendChunk>j+1) --PendChunk;
+	}
+}
+
+// ADD delta TO ALL STARTS PAST offset
+void gLineIndex::Shift(int offset,int delta)
+{
+	gLineChunk *c;
+	int j,k,i;
+
+	if(!NumChunks) return;
+	j=Find(offset,&k);
+	if(j<0) { j=0; k=-1; }
+	c=&Chunks[j];
+	for(i=k+1;i<c->Count;++i) c->Start[i]+=delta;
+	MovePending(j+1);
+	PendDelta+=delta;
+}
+
+void gLineIndex::Recheck(int offset)
+{
+	int j,k;
+	BOOL is,was;
+
+	is=IsStart(offset);
+	j=Find(offset,&k);
+	was=(j>=0 && Abs(j,k)==offset);
+	if(is && !was && !Add(offset)) Valid=FALSE;
+	if(was && !is) Remove(j,k);
+}
+
+void gLineIndex::Inserted(int offset,int bytes)
+{
+	int q;
+
+	if(!Valid || bytes<=0) return;
+	if(2*bytes>Length) {
+		Build(Length+bytes);
+		return;
+	}
+	Length+=bytes;
+	Shift(offset,bytes);
+	for(q=offset+1;q<=offset+bytes;++q) {
+		if(IsStart(q) && !Add(q)) {
+			Valid=FALSE;
+			return;
+		}
+	}
+	Recheck(offset);
+	Recheck(offset+bytes+1);
+}
+
+void gLineIndex::Deleted(int offset,int bytes)
+{
+	int j,k;
+
+	if(!Valid || bytes<=0) return;
+	if(2*bytes>Length) {
+		Build(Length-bytes);
+		return;
+	}
+	Length-=bytes;
+	while((j=Find(offset+bytes,&k))>=0 && Abs(j,k)>offset) Remove(j,k);
+	Shift(offset,-bytes);
+	Recheck(offset);
+	Recheck(offset+1);
+}
+
+void gLineIndex::Changed(int offset,int bytes)
+{
+	int q;
+
+	if(!Valid) return;
+	for(q=offset;q<=offset+bytes && Valid;++q) Recheck(q);
+}
+
+
+int gLineIndex::LineOf(int offset)
+{
+	int j,k;
+
+	j=Find(offset,&k);
+	if(j<0) return 0;
+	FixFirst(j);
+	return Chunks[j].First+k;
+}
+
+int gLineIndex::LineStart(int line)
+{
+	int lo,hi,mid,j;
+
+	if(!line) return 0;
+	if(line<0 || line>NumStarts) return -1;
+
+	// First IS ONLY UPDATED AS FAR AS NEEDED
+	FixFirst(0);
+	while(FirstValid<NumChunks-1 && Chunks[FirstValid].First+Chunks[FirstValid].Count<=line) FixFirst(FirstValid+1);
+	j=0;
+	lo=0;
+	hi=FirstValid;
+	while(lo<=hi) {
+		mid=(lo+hi)>>1;
+		if(Chunks[mid].First<=line) { j=mid; lo=mid+1; }
+		else hi=mid-1;
+	}
+	return Abs(j,line-Chunks[j].First);
+}
+
+int gLineIndex::StartOf(int offset)
+{
+	int j,k;
+
+	j=Find(offset,&k);
+	return (j<0)? 0:Abs(j,k);
+}
+
+int gLineIndex::NextStart(int offset)
+{
+	int j,k;
+
+	j=Find(offset,&k);
+	if(j<0) return (NumChunks)? Abs(0,0):-1;
+	if(k+1<Chunks[j].Count) return Abs(j,k+1);
+	if(j+1<NumChunks) return Abs(j+1,0);
+	return -1;
+}
+
+int gLineIndex::PrevStart(int offset)
+{
+	int j,k;
+
+	j=Find(offset,&k);
+	if(j<0) return -1;
+	if(k>0) return Abs(j,k-1);
+	if(j>0) return Abs(j-1,Chunks[j-1].Count-1);
+	return 0;
+}
+
+
+// STRING WITH A LINE INDEX
+
+static int li_char(void *Context,int Offset)
+{
+	gIndexedString *s=(gIndexedString *)Context;
+
+	if(Offset<0 || Offset>=s->TotalUsed) return -1;
+	return (unsigned char)*s->GetPtr(Offset);
+}
+
+void gIndexedString::vTable()
+{
+}
+
+gIndexedString::gIndexedString() : Lines(li_char,this)
+{
+	Lines.Build(TotalUsed);
+}
+
+gIndexedString::~gIndexedString()
+{
+}
+
+BOOL gIndexedString::Reindex()
+{
+	return Lines.Build(TotalUsed);
+}
+
+BOOL gIndexedString::Append(int bytes,char *Data)
+{
+	int old=TotalUsed;
+
+	if(!MemBlock::Append(bytes,Data)) return FALSE;
+	Lines.Inserted(old,TotalUsed-old);
+	return TRUE;
+}
+
+void gIndexedString::Shrink(int bytes)
+{
+	int old=TotalUsed;
+
+	MemBlock::Shrink(bytes);
+	Lines.Deleted(TotalUsed,old-TotalUsed);
+}
+
+BOOL gIndexedString::Insert(int offset,int bytes,char *Data)
+{
+	int old=TotalUsed;
+
+	if(!MemBlock::Insert(offset,bytes,Data)) return FALSE;
+	Lines.Inserted(offset,TotalUsed-old);
+	return TRUE;
+}
+
+void gIndexedString::Delete(int offset,int bytes)
+{
+	int old=TotalUsed;
+
+	MemBlock::Delete(offset,bytes);
+	Lines.Deleted(offset,old-TotalUsed);
+}
+
+void gIndexedString::Delete(int offset)
+{
+	int old=TotalUsed;
+
+	gString::Delete(offset);
+	Lines.Deleted(offset,old-TotalUsed);
+}
+
+void gIndexedString::InsertChar(int offset,char a)
+{
+	int old=TotalUsed;
+
+	gString::InsertChar(offset,a);
+	Lines.Inserted(offset,TotalUsed-old);
+}
+
+void gIndexedString::MemMove(int destoffset,int srcoffset,int bytes)
+{
+	int old=TotalUsed;
+
+	MemBlock::MemMove(destoffset,srcoffset,bytes);
+	if(TotalUsed!=old) Reindex();
+	else Lines.Changed(destoffset,bytes);
+}
+
+void gIndexedString::MemMove(int destoffset,MemBlock &src,int srcoffset,int bytes)
+{
+	int old=TotalUsed;
+
+	MemBlock::MemMove(destoffset,src,srcoffset,bytes);
+	if(TotalUsed!=old) Reindex();
+	else Lines.Changed(destoffset,bytes);
+}
+
+void gIndexedString::MemMove(int destoffset,char *src,int bytes)
+{
+	int old=TotalUsed;
+
+	MemBlock::MemMove(destoffset,src,bytes);
+	if(TotalUsed!=old) Reindex();
+	else Lines.Changed(destoffset,bytes);
+}
+
+int gIndexedString::PrevLine(int Offset)
+{
+	if(!Lines.Valid) return gString::PrevLine(Offset);
+	return Lines.PrevStart(Offset);
+}
+
+int gIndexedString::NextLine(int Offset)
+{
+	if(!Lines.Valid) return gString::NextLine(Offset);
+	return Lines.NextStart(Offset);
+}
+
+int gIndexedString::StartOfLine(int Offset)
+{
+	if(!Lines.Valid) return gString::StartOfLine(Offset);
+	return Lines.StartOf(Offset);
+}
+
+int gIndexedString::NumLines()
+{
+	if(!Lines.Valid) return gString::NumLines();
+	return Lines.NumLines();
+}
+
+int gIndexedString::LineOf(int Offset)
+{
+	int n,k;
+
+	if(Lines.Valid) return Lines.LineOf(Offset);
+	for(n=0,k=gString::StartOfLine(Offset);k>0 && (k=gString::PrevLine(k))>=0;++n) ;
+	return n;
+}
+
+int gIndexedString::LineStart(int Line)
+{
+	int k;
+
+	if(Lines.Valid) return Lines.LineStart(Line);
+	if(Line<0) return -1;
+	for(k=0;Line>0 && k>=0;--Line) k=gString::NextLine(k);
+	return k;
+}
@@ -0,0 +1,172 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <gui.h>
+
+// DAMAGE REGIONS
+// TWO RECTANGLES ARE MERGED WHEN THEIR BOUNDING BOX COVERS AT MOST HALF
+// AGAIN THE AREA OF THEIR UNION, WHICH JOINS THE ADJACENT PIECES OF A TEXT
+// LINE BUT KEEPS A CURSOR AND A CLOCK IN OPPOSITE CORNERS APART
+
+#define RG_MAXPIECES (4*GREGION_MAXRECTS)	// PIECES OF ONE NEW RECTANGLE
+
+static inline int rg_area(gUpdate *a)
+{
+	return (a->clipx2-a->clipx+1)*(a->clipy2-a->clipy+1);
+}
+
+static inline BOOL rg_overlap(gUpdate *a,gUpdate *b)
+{
+	return a->clipx<=b->clipx2 && b->clipx<=a->clipx2 && a->clipy<=b->clipy2 && b->clipy<=a->clipy2;
+}
+
+static inline BOOL rg_contains(gUpdate *a,gUpdate *b)
+{
+	return a->clipx<=b->clipx && a->clipx2>=b->clipx2 && a->clipy<=b->clipy && a->clipy2>=b->clipy2;
+}
+
+// a = BOUNDING BOX OF a AND b
+static void rg_bbox(gUpdate *a,gUpdate *b)
+{
+	if(b->clipx<a->clipx) a->clipx=b->clipx;
+	if(b->clipy<a->clipy) a->clipy=b->clipy;
+	if(b->clipx2>a->clipx2) a->clipx2=b->clipx2;
+	if(b->clipy2>a->clipy2) a->clipy2=b->clipy2;
+}
+
+// AREA OF THE BOUNDING BOX OF a AND b THAT IS IN NEITHER
+static int rg_waste(gUpdate *a,gUpdate *b,int *uni)
+{
+	gUpdate box=*a,both;
+
+	rg_bbox(&box,b);
+	*uni=rg_area(a)+rg_area(b);
+	if(rg_overlap(a,b)) {
+		both.clipx=(a->clipx>b->clipx)? a->clipx:b->clipx;
+		both.clipy=(a->clipy>b->clipy)? a->clipy:b->clipy;
+		both.clipx2=(a->clipx2<b->clipx2)? a->clipx2:b->clipx2;
+		both.clipy2=(a->clipy2<b->clipy2)? a->clipy2:b->clipy2;
+		*uni-=rg_area(&both);
+	}
+	return rg_area(&box)-*uni;
+}
+
+static inline void rg_remove(gRegion *r,int k)
+{
+	r->Rects[k]=r->Rects[--r->NumRects];
+}
+
+// APPEND u, MERGING IT WITH ANY RECTANGLE IT OVERLAPS, AND WITH THE CLOSEST
+// ONE WHILE THE LIST IS FULL
+static void rg_put(gRegion *r,gUpdate u)
+{
+	int k,best,w,bw,uni;
+
+	for(;;) {
+		for(k=0;k<r->NumRects;++k) if(rg_overlap(&r->Rects[k],&u)) break;
+		if(k<r->NumRects) {
+			rg_bbox(&u,&r->Rects[k]);
+			rg_remove(r,k);
+			continue;
+		}
+		if(r->NumRects<GREGION_MAXRECTS) break;
+		best=0;
+		bw=rg_waste(&r->Rects[0],&u,&uni);
+		for(k=1;k<r->NumRects;++k) {
+			w=rg_waste(&r->Rects[k],&u,&uni);
+			if(w<bw) { bw=w; best=k; }
+		}
+		rg_bbox(&u,&r->Rects[best]);
+		rg_remove(r,best);
+	}
+	r->Rects[r->NumRects++]=u;
+}
+
+
+void gRegion::Add(int x1,int y1,int x2,int y2)
+{
+	gUpdate u,p,*e,pieces[RG_MAXPIECES];
+	int k,i,n,uni,top,bot;
+	BOOL merged;
+
+	u.clipx=x1; u.clipy=y1; u.clipx2=x2; u.clipy2=y2;
+	if(x1>x2 || y1>y2) return;
+
+	// ABSORB THE RECTANGLES INSIDE u OR CLOSE ENOUGH TO IT
+	do {
+		merged=FALSE;
+		for(k=0;k<NumRects;++k) {
+			e=&Rects[k];
+			if(rg_contains(e,&u)) return;
+			if(2*rg_waste(e,&u,&uni)<=uni) {
+				rg_bbox(&u,e);
+				rg_remove(this,k);
+				merged=TRUE;
+				break;
+			}
+		}
+	} while(merged);
+
+	// CUT u AROUND THE REST, UP TO 4 PIECES FOR EACH RECTANGLE IT OVERLAPS
+	pieces[0]=u;
+	n=1;
+	for(k=0;k<NumRects;++k) {
+		e=&Rects[k];
+		for(i=0;i<n;) {
+			p=pieces[i];
+			if(!rg_overlap(&p,e)) { ++i; continue; }
+			if(n+3>RG_MAXPIECES) {
+				// TOO FRAGMENTED, KEEP u WHOLE AND MERGE WHAT IT OVERLAPS
+				rg_put(this,u);
+				return;
+			}
+			pieces[i]=pieces[--n];
+			top=(p.clipy>e->clipy)? p.clipy:e->clipy;
+			bot=(p.clipy2<e->clipy2)? p.clipy2:e->clipy2;
+			if(p.clipy<e->clipy) { pieces[n]=p; pieces[n++].clipy2=e->clipy-1; }
+			if(p.clipy2>e->clipy2) { pieces[n]=p; pieces[n++].clipy=e->clipy2+1; }
+			if(p.clipx<e->clipx) {
+				pieces[n]=p;
+				pieces[n].clipy=top; pieces[n].clipy2=bot;
+				pieces[n++].clipx2=e->clipx-1;
+			}
+			if(p.clipx2>e->clipx2) {
+				pieces[n]=p;
+				pieces[n].clipy=top; pieces[n].clipy2=bot;
+				pieces[n++].clipx=e->clipx2+1;
+			}
+		}
+	}
+	for(i=0;i<n;++i) rg_put(this,pieces[i]);
+}
+
+void gRegion::Discard(gUpdate *u)
+{
+	int k;
+	for(k=0;k<NumRects;) {
+		if(rg_contains(u,&Rects[k])) rg_remove(this,k);
+		else ++k;
+	}
+}
+
+BOOL gRegion::Bounds(gUpdate *u)
+{
+	int k;
+	if(!NumRects) return FALSE;
+	*u=Rects[0];
+	for(k=1;k<NumRects;++k) rg_bbox(u,&Rects[k]);
+	return TRUE;
+}
+
+BOOL gRegion::Intersects(gUpdate *u)
+{
+	int k;
+	for(k=0;k<NumRects;++k) if(rg_overlap(&Rects[k],u)) return TRUE;
+	return FALSE;
+}
@@ -0,0 +1,60 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <gui.h>
+
+// APPLICATION WITH A MULTI-RECTANGLE INVALID AREA
+// KEPT APART FROM gregion.cpp, WHICH ONLY NEEDS ARITHMETIC AND IS ALSO
+// BUILT ON THE HOST
+
+
+// r = r CLIPPED TO u, FALSE IF NOTHING IS LEFT
+static BOOL ra_clip(gUpdate *r,gUpdate *u)
+{
+	if(r->clipx<u->clipx) r->clipx=u->clipx;
+	if(r->clipy<u->clipy) r->clipy=u->clipy;
+	if(r->clipx2>u->clipx2) r->clipx2=u->clipx2;
+	if(r->clipy2>u->clipy2) r->clipy2=u->clipy2;
+	return r->clipx<=r->clipx2 && r->clipy<=r->clipy2;
+}
+
+void gRegionApplication::vTable()
+{
+}
+
+void gRegionApplication::Invalidate(gUpdate *u,gControl *Sender)
+{
+	Damage.Add(u);
+	// THE BOUNDING BOX IS STILL KEPT, IT TRIGGERS THE Update OF THE LOOP
+	gApplication::Invalidate(u,Sender);
+}
+
+void gRegionApplication::Update(gUpdate *u)
+{
+	gUpdate b,r;
+	int k;
+
+	if(!Damage.Bounds(&b) || !ra_clip(&b,u)) {
+		gApplication::Update(u);
+		return;
+	}
+
+	if(b.clipx!=u->clipx || b.clipy!=u->clipy || b.clipx2!=u->clipx2 || b.clipy2!=u->clipy2) {
+		// NOT THE INVALID AREA, ALSO REDRAWS WHAT WASN'T INVALIDATED
+		gApplication::Update(u);
+		Damage.Discard(u);
+		return;
+	}
+
+	for(k=0;k<Damage.NumRects;++k) {
+		r=Damage.Rects[k];
+		if(ra_clip(&r,u)) gApplication::Update(&r);
+	}
+	Damage.Clear();
+}
@@ -0,0 +1,269 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <gui.h>
+
+// TEXT STORAGE BACKENDS
+
+
+static int tb_char(void *Context,int Offset)
+{
+	return ((gTextBuffer *)Context)->CharAt(Offset);
+}
+
+// DROP THE OLDEST UNDO RECORD, AND ITS TEXT FROM THE START OF UndoText
+static void tb_dropundo(gTextBuffer *tb)
+{
+	int k,n;
+
+	if(!tb->NumUndo) return;
+	n=(tb->UndoLog[0].Length<0)? -tb->UndoLog[0].Length:0;
+	memmove(tb->UndoLog,tb->UndoLog+1,(tb->NumUndo-1)*sizeof(gUndoRecord));
+	--tb->NumUndo;
+	if(!n) return;
+	memmove(tb->UndoText,tb->UndoText+n,tb->UndoUsed-n);
+	tb->UndoUsed-=n;
+	for(k=0;k<tb->NumUndo;++k) tb->UndoLog[k].TextPos-=n;
+}
+
+static gUndoRecord *tb_newundo(gTextBuffer *tb)
+{
+	if(tb->NumUndo==GTEXT_UNDOSTEPS) tb_dropundo(tb);
+	return &tb->UndoLog[tb->NumUndo++];
+}
+
+
+gTextBuffer::gTextBuffer()
+{
+	NumUndo=0;
+	UndoUsed=0;
+}
+
+gTextBuffer::~gTextBuffer()
+{
+}
+
+void gTextBuffer::ClearUndo()
+{
+	NumUndo=0;
+	UndoUsed=0;
+}
+
+BOOL gTextBuffer::Insert(int Offset,const char *Data,int Bytes)
+{
+	gUndoRecord *r;
+
+	if(Bytes<=0) return TRUE;
+	if(!DoInsert(Offset,Data,Bytes)) return FALSE;
+
+	r=(NumUndo)? &UndoLog[NumUndo-1]:NULL;
+	if(r && r->Length>0 && r->Offset+r->Length==Offset) r->Length+=Bytes;
+	else {
+		r=tb_newundo(this);
+		r->Offset=Offset;
+		r->Length=Bytes;
+		r->TextPos=UndoUsed;
+	}
+	return TRUE;
+}
+
+void gTextBuffer::Delete(int Offset,int Bytes)
+{
+	gUndoRecord *r;
+
+	if(Offset<0) { Bytes+=Offset; Offset=0; }
+	if(Offset+Bytes>Length()) Bytes=Length()-Offset;
+	if(Bytes<=0) return;
+
+	if(Bytes>GTEXT_UNDOBYTES) ClearUndo();		// TOO BIG TO UNDO
+	else {
+		while(NumUndo && UndoUsed+Bytes>GTEXT_UNDOBYTES) tb_dropundo(this);
+		// THE TEXT OF THE LAST RECORD IS AT THE END OF UndoText
+		r=(NumUndo)? &UndoLog[NumUndo-1]:NULL;
+		if(r && r->Length<0 && r->Offset==Offset) {
+			// DELETE KEY, THE TEXT GOES AFTER
+			GetText(UndoText+UndoUsed,Offset,Offset+Bytes);
+			r->Length-=Bytes;
+		}
+		else if(r && r->Length<0 && Offset+Bytes==r->Offset) {
+			// BACKSPACE, THE TEXT GOES BEFORE
+			memmove(UndoText+r->TextPos+Bytes,UndoText+r->TextPos,-r->Length);
+			GetText(UndoText+r->TextPos,Offset,Offset+Bytes);
+			r->Offset=Offset;
+			r->Length-=Bytes;
+		}
+		else {
+			r=tb_newundo(this);
+			r->Offset=Offset;
+			r->Length=-Bytes;
+			r->TextPos=UndoUsed;
+			GetText(UndoText+UndoUsed,Offset,Offset+Bytes);
+		}
+		UndoUsed+=Bytes;
+	}
+	DoDelete(Offset,Bytes);
+}
+
+int gTextBuffer::Undo()
+{
+	gUndoRecord *r;
+
+	if(!NumUndo) return -1;
+	r=&UndoLog[--NumUndo];
+	if(r->Length>0) {
+		DoDelete(r->Offset,r->Length);
+		return r->Offset;
+	}
+	UndoUsed=r->TextPos;
+	if(!DoInsert(r->Offset,UndoText+r->TextPos,-r->Length)) {
+		ClearUndo();
+		return -1;
+	}
+	return r->Offset-r->Length;
+}
+
+int gTextBuffer::GetText(char *Dest,int Start,int End)
+{
+	const char *p;
+	int n,total=0;
+
+	if(Start<0) Start=0;
+	if(End>Length()) End=Length();
+	while(Start<End) {
+		p=GetRange(Start,&n);
+		if(n>End-Start) n=End-Start;
+		memcpy(Dest,p,n);
+		Dest+=n;
+		Start+=n;
+		total+=n;
+	}
+	return total;
+}
+
+
+// GAP BUFFER
+
+gGapText::gGapText() : Lines(tb_char,this)
+{
+	Buffer=NULL;
+	Size=GapStart=GapEnd=0;
+	Lines.Build(0);
+}
+
+gGapText::~gGapText()
+{
+	if(Buffer) free(Buffer);
+}
+
+int gGapText::CharAt(int Offset)
+{
+	if(Offset<0) return -1;
+	if(Offset<GapStart) return (unsigned char)Buffer[Offset];
+	Offset+=GapEnd-GapStart;
+	return (Offset<Size)? (unsigned char)Buffer[Offset]:-1;
+}
+
+const char *gGapText::GetRange(int Start,int *Bytes)
+{
+	if(Start<GapStart) {
+		*Bytes=GapStart-Start;
+		return Buffer+Start;
+	}
+	Start+=GapEnd-GapStart;
+	*Bytes=Size-Start;
+	return Buffer+Start;
+}
+
+void gGapText::MoveGap(int Offset)
+{
+	int gap=GapEnd-GapStart;
+
+	if(Offset<GapStart) memmove(Buffer+Offset+gap,Buffer+Offset,GapStart-Offset);
+	else if(Offset>GapStart) memmove(Buffer+GapStart,Buffer+GapEnd,Offset-GapStart);
+	GapStart=Offset;
+	GapEnd=Offset+gap;
+}
+
+const char *gGapText::GetText(int Start,int End)
+{
+	if(Start<0) Start=0;
+	if(End>Length()) End=Length();
+	if(Start<GapStart && End>GapStart) {
+		// MOVE THE GAP TO THE CLOSEST END OF THE RANGE
+		if(GapStart-Start<End-GapStart) MoveGap(Start);
+		else MoveGap(End);
+	}
+	return (Start<GapStart)? Buffer+Start:Buffer+Start+GapEnd-GapStart;
+}
+
+BOOL gGapText::DoInsert(int Offset,const char *Data,int Bytes)
+{
+	char *nb;
+	int grow,tail;
+
+	if(Offset<0 || Offset>Length()) return FALSE;
+	if(GapEnd-GapStart<Bytes) {
+		// GROW BY A FRACTION OF THE SIZE, SO TYPING IS O(1) AMORTIZED
+		grow=Size>>2;
+		if(grow<GAPTEXT_GROUP) grow=GAPTEXT_GROUP;
+		if(grow<Bytes) grow=Bytes+GAPTEXT_GROUP;
+		nb=(char *)realloc(Buffer,Size+grow);
+		if(!nb) return FALSE;
+		tail=Size-GapEnd;
+		memmove(nb+GapEnd+grow,nb+GapEnd,tail);
+		Buffer=nb;
+		Size+=grow;
+		GapEnd+=grow;
+	}
+	MoveGap(Offset);
+	memcpy(Buffer+GapStart,Data,Bytes);
+	GapStart+=Bytes;
+	Lines.Inserted(Offset,Bytes);
+	return TRUE;
+}
+
+void gGapText::DoDelete(int Offset,int Bytes)
+{
+	if(Offset<0 || Bytes<=0 || Offset+Bytes>Length()) return;
+	MoveGap(Offset);
+	GapEnd+=Bytes;
+	Lines.Deleted(Offset,Bytes);
+}
+
+
+// MemBlock FRAGMENTS
+// GetUpperLimit IS TAKEN AS THE END OF THE FRAGMENT OF offset, AT LEAST ONE
+// BYTE IS RETURNED IN ANY CASE
+
+int gStringText::CharAt(int Offset)
+{
+	if(Offset<0 || Offset>=Str.TotalUsed) return -1;
+	return (unsigned char)*Str.GetPtr(Offset);
+}
+
+const char *gStringText::GetRange(int Start,int *Bytes)
+{
+	int n=Str.GetUpperLimit(Start)-Start;
+
+	if(n>Str.TotalUsed-Start) n=Str.TotalUsed-Start;
+	*Bytes=(n>0)? n:1;
+	return Str.GetPtr(Start);
+}
+
+BOOL gStringText::DoInsert(int Offset,const char *Data,int Bytes)
+{
+	if(Offset<0 || Offset>Str.TotalUsed) return FALSE;
+	return Str.Insert(Offset,Bytes,(char *)Data);
+}
+
+void gStringText::DoDelete(int Offset,int Bytes)
+{
+	if(Offset<0 || Bytes<=0 || Offset+Bytes>Str.TotalUsed) return;
+	Str.Delete(Offset,Bytes);
+}
@@ -0,0 +1,380 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <gui.h>
+
+// MULTILINE EDITOR OVER A gTextBuffer
+// LINES ARE FOUND THROUGH THE LINE INDEX OF THE BACKEND, ONLY THE VISIBLE
+// LINES ARE READ. A \r\n PAIR IS ONE LINE BREAK FOR THE CURSOR.
+
+
+static const unsigned char te_letters[26]={
+	KB_A,KB_B,KB_C,KB_D,KB_E,KB_F,KB_G,KB_H,KB_I,KB_J,KB_K,KB_L,KB_M,
+	KB_N,KB_O,KB_P,KB_Q,KB_R,KB_S,KB_T,KB_U,KB_V,KB_W,KB_X,KB_Y,KB_Z
+};
+
+static const unsigned char te_digits[10]={
+	KB_0,KB_1,KB_2,KB_3,KB_4,KB_5,KB_6,KB_7,KB_8,KB_9
+};
+
+// CHARACTER TYPED BY A KEY, 0 IF NONE
+static int te_char(int key,int plane)
+{
+	int k;
+
+	if(plane&SHIFT_ALPHA) {
+		for(k=0;k<26;++k) if(te_letters[k]==key) return ((plane&SHIFT_LS)? 'a':'A')+k;
+	}
+	else if(plane) return 0;
+	for(k=0;k<10;++k) if(te_digits[k]==key) return '0'+k;
+	switch(key) {
+	case KB_ADD: return '+';
+	case KB_SUB: return '-';
+	case KB_MUL: return '*';
+	case KB_DIV: return '/';
+	case KB_DOT: return '.';
+	case KB_SPC: return ' ';
+	}
+	return 0;
+}
+
+static int te_height(gTextEdit *te)
+{
+	gGlyphCache *gc=gGlyphCache::Get(&te->Font);
+	int h=(gc)? gc->Height:te->Font.TextHeight();
+	return (h>0)? h:1;
+}
+
+static gLineIndex *te_lines(gTextEdit *te)
+{
+	gLineIndex *li=te->Text->GetLines();
+
+	if(!li->Valid && !li->Build(te->Text->Length())) te->InsufMemoryError();
+	return li;
+}
+
+// END OF THE LINE STARTING AT start, BEFORE ITS LINE BREAK
+static int te_lineend(gTextEdit *te,int start)
+{
+	int end=te_lines(te)->NextStart(start);
+
+	if(end<0) return te->Text->Length();
+	--end;
+	if(end>start && te->Text->CharAt(end)=='\n' && te->Text->CharAt(end-1)=='\r') --end;
+	return end;
+}
+
+// BYTES OF THE LINE BREAK AT (OR BEFORE, back=TRUE) Offset
+static int te_breaklen(gTextEdit *te,int Offset,BOOL back)
+{
+	gTextBuffer *t=te->Text;
+
+	if(back) return (t->CharAt(Offset-1)=='\n' && t->CharAt(Offset-2)=='\r')? 2:1;
+	return (t->CharAt(Offset)=='\r' && t->CharAt(Offset+1)=='\n')? 2:1;
+}
+
+// WIDTH OF THE TEXT [start,end) OF A LINE
+static int te_width(gTextEdit *te,int start,int end)
+{
+	gGlyphCache *gc=gGlyphCache::Get(&te->Font);
+	char buf[TEXTEDIT_LINEMAX+1];
+	int n;
+
+	if(end-start>TEXTEDIT_LINEMAX) end=start+TEXTEDIT_LINEMAX;
+	n=te->Text->GetText(buf,start,end);
+	buf[n]=0;
+	return (gc)? gc->TextWidth(buf):te->Font.TextWidth(buf);
+}
+
+// OFFSET IN THE LINE STARTING AT start CLOSEST TO x
+static int te_posx(gTextEdit *te,int start,int x)
+{
+	gGlyphCache *gc=gGlyphCache::Get(&te->Font);
+	int end=te_lineend(te,start),w=0,cw;
+
+	for(;start<end;++start) {
+		cw=(gc)? gc->CharWidth((char)te->Text->CharAt(start)):te->Font.CharWidth((char)te->Text->CharAt(start));
+		if(w+cw/2>=x) break;
+		w+=cw;
+	}
+	return start;
+}
+
+// DAMAGE THE VISIBLE LINES first TO last, last<0 IS DOWN TO THE BOTTOM.
+// gUpdate IS IN SURFACE COORDINATES, LINE 0 OF THE VIEW IS AT THE TOP OF
+// THE CLIENT AREA
+static void te_damage(gTextEdit *te,int first,int last)
+{
+	gUpdate u;
+	int h=te_height(te),ox=te->drawsurf.x+te->ncx,oy=te->drawsurf.y+te->ncy;
+	int ly=oy-te->viewy;
+
+	first-=te->ViewLine;
+	if(first<0) first=0;
+	u.clipx=ox;
+	u.clipx2=ox+te->ncwidth-1;
+	u.clipy=ly+first*h;
+	u.clipy2=(last<0)? oy+te->ncheight-1:ly+(last-te->ViewLine+1)*h-1;
+	if(u.clipy<oy) u.clipy=oy;
+	if(u.clipy2>oy+te->ncheight-1) u.clipy2=oy+te->ncheight-1;
+	if(u.clipy>u.clipy2) return;
+	te->Invalidate(&u);
+}
+
+// PUT THE CURSOR AT Offset AND REPAINT WHAT CHANGED SINCE IT WAS IN LINE
+// old OF A TEXT OF count LINES. ONLY THE LINES BETWEEN THE OLD AND NEW
+// CURSOR ARE TOUCHED, UNLESS LINES WERE ADDED OR REMOVED (EVERYTHING BELOW
+// MOVES) OR THE VIEW SCROLLED
+static void te_place(gTextEdit *te,int Offset,int old,int count)
+{
+	int view=te->ViewLine,line,k;
+
+	if(Offset<0) Offset=0;
+	if(Offset>te->Text->Length()) Offset=te->Text->Length();
+	te->CursorPos=Offset;
+	te->EnsureVisible();
+	if(te->ViewLine!=view) {
+		te->Invalidate();
+		return;
+	}
+	line=te->CursorLine();
+	if(old>line) { k=old; old=line; line=k; }
+	te_damage(te,old,(te_lines(te)->NumLines()!=count)? -1:line);
+}
+
+
+void gTextEdit::vTable()
+{
+}
+
+gTextEdit::gTextEdit(gControl& Parent,int x,int y,int width,int height,gFont *f,int Backend) : gControl(Parent)
+{
+	if(f) Font=*f;
+	Color=GBLACK;
+	BkColor=GWHITE;
+	ReadOnly=FALSE;
+	CursorPos=0;
+	ViewLine=0;
+	Targetx=-1;
+	if(Backend==GTEXT_STRING) Text=new gStringText;
+	else Text=new gGapText;
+	if(!Text) InsufMemoryError();
+	Move(x,y);
+	Resize(width,height);
+}
+
+gTextEdit::~gTextEdit()
+{
+	if(Text) delete Text;
+}
+
+void gTextEdit::SetText(const char *text)
+{
+	if(!Text) return;
+	Text->DoDelete(0,Text->Length());
+	if(text && !Text->DoInsert(0,text,strlen(text))) InsufMemoryError();
+	Text->ClearUndo();
+	CursorPos=0;
+	ViewLine=0;
+	Targetx=-1;
+	Invalidate();
+}
+
+int gTextEdit::GetText(char *data,int maxbytes)
+{
+	int n;
+
+	if(!Text || maxbytes<=0) return 0;
+	n=Text->GetText(data,0,maxbytes-1);
+	data[n]=0;
+	return n;
+}
+
+int gTextEdit::CursorLine()
+{
+	return te_lines(this)->LineOf(CursorPos);
+}
+
+int gTextEdit::DispLines()
+{
+	int n=ncheight/te_height(this);
+	return (n>0)? n:1;
+}
+
+void gTextEdit::EnsureVisible()
+{
+	int line=CursorLine(),n=DispLines();
+
+	if(line<ViewLine) ViewLine=line;
+	else if(line>=ViewLine+n) ViewLine=line-n+1;
+}
+
+void gTextEdit::MoveCursor(int Offset)
+{
+	Targetx=-1;
+	te_place(this,Offset,CursorLine(),te_lines(this)->NumLines());
+}
+
+void gTextEdit::CursorLeft()
+{
+	if(CursorPos>0) MoveCursor(CursorPos-te_breaklen(this,CursorPos,TRUE));
+}
+
+void gTextEdit::CursorRight()
+{
+	if(CursorPos<Text->Length()) MoveCursor(CursorPos+te_breaklen(this,CursorPos,FALSE));
+}
+
+void gTextEdit::CursorUp()
+{
+	gLineIndex *li=te_lines(this);
+	int start=li->StartOf(CursorPos),prev=li->PrevStart(CursorPos);
+
+	if(prev<0) return;
+	if(Targetx<0) Targetx=te_width(this,start,CursorPos);
+	te_place(this,te_posx(this,prev,Targetx),CursorLine(),li->NumLines());
+}
+
+void gTextEdit::CursorDown()
+{
+	gLineIndex *li=te_lines(this);
+	int start=li->StartOf(CursorPos),next=li->NextStart(CursorPos);
+
+	if(next<0) return;
+	if(Targetx<0) Targetx=te_width(this,start,CursorPos);
+	te_place(this,te_posx(this,next,Targetx),CursorLine(),li->NumLines());
+}
+
+void gTextEdit::InsertText(const char *text,int bytes)
+{
+	int line,count;
+
+	if(ReadOnly || bytes<=0) return;
+	line=CursorLine();
+	count=te_lines(this)->NumLines();
+	if(!Text->Insert(CursorPos,text,bytes)) {
+		InsufMemoryError();
+		return;
+	}
+	Targetx=-1;
+	te_place(this,CursorPos+bytes,line,count);
+}
+
+void gTextEdit::InsertChar(int c)
+{
+	char a=(char)c;
+	InsertText(&a,1);
+}
+
+void gTextEdit::BackSpace()
+{
+	int n,line,count;
+
+	if(ReadOnly || CursorPos<=0) return;
+	line=CursorLine();
+	count=te_lines(this)->NumLines();
+	n=te_breaklen(this,CursorPos,TRUE);
+	Text->Delete(CursorPos-n,n);
+	Targetx=-1;
+	te_place(this,CursorPos-n,line,count);
+}
+
+void gTextEdit::Delete()
+{
+	int line,count;
+
+	if(ReadOnly || CursorPos>=Text->Length()) return;
+	line=CursorLine();
+	count=te_lines(this)->NumLines();
+	Text->Delete(CursorPos,te_breaklen(this,CursorPos,FALSE));
+	Targetx=-1;
+	te_place(this,CursorPos,line,count);
+}
+
+// THE UNDONE CHANGE IS BETWEEN THE CURSOR AND THE OFFSET RETURNED, UNLESS IT
+// ADDED OR REMOVED LINES
+void gTextEdit::Undo()
+{
+	int k,line,count;
+
+	if(ReadOnly) return;
+	line=CursorLine();
+	count=te_lines(this)->NumLines();
+	k=Text->Undo();
+	if(k<0) return;
+	Targetx=-1;
+	te_place(this,k,line,count);
+}
+
+
+void gTextEdit::Update(gUpdate *u)
+{
+	gGlyphCache *gc=gGlyphCache::Get(&Font);
+	gLineIndex *li;
+	char buf[TEXTEDIT_LINEMAX+1];
+	int y,h,start,end,n,x,top,bottom;
+
+	ClipToView(u);
+	Rect(0,0,ncwidth-1,ncheight-1,BkColor);
+	if(!Text) return;
+
+	// ONLY THE LINES CROSSING THE CLIPPING AREA ARE READ AND DRAWN
+	top=clipy-(drawsurf.y+ncy-viewy);
+	bottom=clipy2-(drawsurf.y+ncy-viewy);
+	if(top<0) top=0;
+	if(bottom>ncheight-1) bottom=ncheight-1;
+	li=te_lines(this);
+	h=te_height(this);
+	y=top-top%h;
+	start=li->LineStart(ViewLine+y/h);
+	for(;y<=bottom && start>=0;y+=h) {
+		end=te_lineend(this,start);
+		n=end-start;
+		if(n>TEXTEDIT_LINEMAX) n=TEXTEDIT_LINEMAX;
+		n=Text->GetText(buf,start,start+n);
+		buf[n]=0;
+		if(gc) gc->DrawText(this,0,y,buf,Color);
+		else DrawText(0,y,buf,&Font,Color);
+		if(CursorPos>=start && CursorPos<=end) {
+			x=te_width(this,start,CursorPos);
+			VLine(x,y,y+h-1,Color);
+		}
+		start=li->NextStart(start);
+	}
+}
+
+BOOL gTextEdit::DefaultEvent(gEvent *e)
+{
+	int key,plane,c;
+
+	if(!Text || e->Type!=GEVENT_KEYB || KM_MESSAGE(e->Arg)!=KM_PRESS) return gControl::DefaultEvent(e);
+	key=KM_KEY(e->Arg);
+	plane=KM_SHIFTPLANE(e->Arg);
+
+	if(!plane) {
+		switch(key) {
+		case KB_UP: CursorUp(); return TRUE;
+		case KB_DN: CursorDown(); return TRUE;
+		case KB_LF: CursorLeft(); return TRUE;
+		case KB_RT: CursorRight(); return TRUE;
+		case KB_BKS: BackSpace(); return TRUE;
+		case KB_ENT: InsertChar('\n'); return TRUE;
+		}
+	}
+	if((plane&SHIFT_LS) && !(plane&SHIFT_ALPHA) && key==KB_BKS) {
+		Undo();
+		return TRUE;
+	}
+	c=te_char(key,plane);
+	if(c) {
+		InsertChar(c);
+		return TRUE;
+	}
+	return gControl::DefaultEvent(e);
+}
@@ -0,0 +1,176 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <gui.h>
+
+// HOST BUILD ONLY: STAND-INS FOR THE MemBlock AND gString MEMBERS OF THE
+// PREBUILT libarmggl THAT THE TEXT MODULES USE. A MemBlock IS A SINGLE
+// FRAGMENT HERE, SO GetPtr NEVER CHANGES FRAGMENT. LINES START AFTER A \n
+// OR A \r NOT FOLLOWED BY \n, AS IN THE LINE INDEX
+
+
+MemFrag::MemFrag()
+{
+	Offset=Size=Used=0;
+	Data=NULL;
+	Prev=Next=NULL;
+}
+
+MemFrag::~MemFrag()
+{
+	if(Data) free(Data);
+}
+
+BOOL MemFrag::Alloc(int size)
+{
+	char *d;
+
+	if(size<=Size) return TRUE;
+	d=(char *)realloc(Data,size);
+	if(!d) return FALSE;
+	Data=d;
+	Size=size;
+	return TRUE;
+}
+
+
+MemBlock::MemBlock()
+{
+	Current=Last=this;
+	TotalUsed=0;
+}
+
+MemBlock::~MemBlock()
+{
+}
+
+MemFrag *MemBlock::GetFrag(int offset)
+{
+	return this;
+}
+
+int MemBlock::GetUpperLimit(int offset)
+{
+	return Used;
+}
+
+BOOL MemBlock::Insert(int offset,int bytes,char *Data)
+{
+	if(offset<0 || offset>Used || bytes<0) return FALSE;
+	// GROW BY HALF, SO APPENDING ONE BYTE AT A TIME IS LINEAR
+	if(Used+bytes>Size && !Alloc(Used+bytes+(Used>>1)+16)) return FALSE;
+	memmove(MemFrag::Data+offset+bytes,MemFrag::Data+offset,Used-offset);
+	if(Data) memcpy(MemFrag::Data+offset,Data,bytes);
+	Used+=bytes;
+	TotalUsed=Used;
+	return TRUE;
+}
+
+BOOL MemBlock::Append(int bytes,char *Data)
+{
+	return Insert(Used,bytes,Data);
+}
+
+void MemBlock::Delete(int offset,int bytes)
+{
+	if(offset<0 || offset>=Used || bytes<=0) return;
+	if(bytes>Used-offset) bytes=Used-offset;
+	memmove(Data+offset,Data+offset+bytes,Used-offset-bytes);
+	Used-=bytes;
+	TotalUsed=Used;
+}
+
+void MemBlock::Shrink(int bytes)
+{
+	if(bytes>Used) bytes=Used;
+	if(bytes>0) Delete(Used-bytes,bytes);
+}
+
+// WRITING PAST THE END EXTENDS THE BLOCK
+void MemBlock::MemMove(int destoffset,char *src,int bytes)
+{
+	if(destoffset<0 || bytes<=0) return;
+	if(destoffset+bytes>Used && !Insert(Used,destoffset+bytes-Used)) return;
+	memmove(Data+destoffset,src,bytes);
+}
+
+void MemBlock::MemMove(int destoffset,int srcoffset,int bytes)
+{
+	if(srcoffset<0 || srcoffset+bytes>Used) return;
+	if(destoffset+bytes>Used && !Insert(Used,destoffset+bytes-Used)) return;
+	memmove(Data+destoffset,Data+srcoffset,bytes);
+}
+
+void MemBlock::MemMove(int destoffset,MemBlock &src,int srcoffset,int bytes)
+{
+	if(srcoffset<0 || srcoffset+bytes>src.Used) return;
+	MemMove(destoffset,src.Data+srcoffset,bytes);
+}
+
+
+static BOOL gs_start(gString *s,int q)
+{
+	char c;
+
+	if(q<=0 || q>s->TotalUsed) return FALSE;
+	c=*s->GetPtr(q-1);
+	if(c=='\n') return TRUE;
+	return c=='\r' && (q==s->TotalUsed || *s->GetPtr(q)!='\n');
+}
+
+void gString::vTable()
+{
+}
+
+gString::gString()
+{
+}
+
+gString::~gString()
+{
+}
+
+int gString::StartOfLine(int Offset)
+{
+	if(Offset>TotalUsed) Offset=TotalUsed;
+	while(Offset>0 && !gs_start(this,Offset)) --Offset;
+	return (Offset>0)? Offset:0;
+}
+
+int gString::NextLine(int Offset)
+{
+	if(Offset<0) Offset=0;
+	for(++Offset;Offset<=TotalUsed;++Offset) if(gs_start(this,Offset)) return Offset;
+	return -1;
+}
+
+int gString::PrevLine(int Offset)
+{
+	Offset=StartOfLine(Offset);
+	if(!Offset) return -1;
+	return StartOfLine(Offset-1);
+}
+
+int gString::NumLines()
+{
+	int q,n=1;
+
+	for(q=1;q<=TotalUsed;++q) if(gs_start(this,q)) ++n;
+	return n;
+}
+
+void gString::InsertChar(int offset,char a)
+{
+	MemBlock::Insert(offset,1,&a);
+}
+
+void gString::Delete(int offset)
+{
+	MemBlock::Delete(offset,1);
+}
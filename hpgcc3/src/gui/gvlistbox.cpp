@@ -0,0 +1,346 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgcc3.h>
+#include <gui.h>
+
+// VIRTUAL LIST BOXES
+// ROW k OF THE SCREEN SHOWS ROW ViewItem+k OF THE PROVIDER, ONLY THOSE ROWS
+// ARE FETCHED. THE EXPAND AND CHECK MARKS ARE 5x5 BOXES, CENTERED IN THE
+// FIRST LEVELWIDTH AND CHECKWIDTH PIXELS BEFORE THE TEXT.
+
+#define VL_MARK 5
+
+
+// WIDTH OF THE ROWS, THE SCROLL BAR IS AT THE RIGHT OF THE CLIENT AREA
+static inline int vl_width(gVirtualListBox *lb)
+{
+	return (lb->VStyle&S_VSCROLLBAR)? lb->ncwidth-SCROLLBARWIDTH:lb->ncwidth;
+}
+
+static void vl_box(gVirtualListBox *lb,int x,int y,int color)
+{
+	lb->HLine(y,x,x+VL_MARK-1,color);
+	lb->HLine(y+VL_MARK-1,x,x+VL_MARK-1,color);
+	lb->VLine(x,y+1,y+VL_MARK-2,color);
+	lb->VLine(x+VL_MARK-1,y+1,y+VL_MARK-2,color);
+}
+
+static void vl_notify(gVirtualListBox *lb,int arg,int Index)
+{
+	gEvent e;
+	e.Type=GEVENT_GUI;
+	e.Arg=arg;
+	e.Data=Index;
+	lb->DoEvent(&e);
+}
+
+// MOVE A ROW NUMBER PAST Index WHEN delta ROWS ARE INSERTED (OR REMOVED) AFTER IT
+static inline int vl_shift(int row,int Index,int delta)
+{
+	if(row<=Index) return row;
+	if(delta<0 && row<=Index-delta) return Index;	// THE ROW WAS REMOVED
+	return row+delta;
+}
+
+
+void gVirtualListBox::vTable()
+{
+}
+
+gVirtualListBox::gVirtualListBox(gControl& Parent,int x,int y,int w,int h,int Style,gFont *Font,gListProvider *p)
+	: gListBox(Parent,x,y,w,h,Style&~(S_VSCROLLBAR|S_HSCROLLBAR),Font)
+{
+	int k;
+
+	VStyle=Style&S_VSCROLLBAR;
+	for(k=0;k<GVLIST_CACHESIZE;++k) Cache[k].Index=-1;
+	CacheStamp=0;
+	Provider=p;
+	NumRows=(p)? p->Count():0;
+	ViewItem=0;
+	SelectedItem=(NumRows>0)? 0:-1;
+}
+
+void gVirtualListBox::SetProvider(gListProvider *p)
+{
+	Provider=p;
+	NumRows=0;
+	ViewItem=0;
+	SelectedItem=0;
+	ListChanged();
+}
+
+void gVirtualListBox::ListChanged()
+{
+	int k;
+
+	for(k=0;k<GVLIST_CACHESIZE;++k) Cache[k].Index=-1;
+	NumRows=(Provider)? Provider->Count():0;
+	if(SelectedItem>=NumRows) SelectedItem=NumRows-1;
+	if(SelectedItem<0 && NumRows>0) SelectedItem=0;
+	if(ViewItem>=NumRows) ViewItem=(NumRows>0)? NumRows-1:0;
+	EnsureVisible(SelectedItem);
+	Invalidate();
+}
+
+void gVirtualListBox::RowsChanged(int Index,int delta)
+{
+	int k;
+
+	for(k=0;k<GVLIST_CACHESIZE;++k) {
+		if(Cache[k].Index==Index || (delta && Cache[k].Index>Index)) Cache[k].Index=-1;
+	}
+	NumRows+=delta;
+	if(delta) {
+		SelectedItem=vl_shift(SelectedItem,Index,delta);
+		ViewItem=vl_shift(ViewItem,Index,delta);
+		if(ViewItem>=NumRows) ViewItem=(NumRows>0)? NumRows-1:0;
+		EnsureVisible(SelectedItem);
+	}
+	Invalidate();
+}
+
+gListItem *gVirtualListBox::GetItem(int Index)
+{
+	gVListRow *r,*old;
+	int k;
+
+	if(!Provider || Index<0 || Index>=NumRows) return NULL;
+
+	// A HIT, OR ELSE A FREE ROW OR THE LEAST RECENTLY USED ONE
+	old=Cache;
+	for(k=0;k<GVLIST_CACHESIZE;++k) {
+		r=&Cache[k];
+		if(r->Index==Index) {
+			r->Stamp=++CacheStamp;
+			return &r->Item;
+		}
+		if(r->Index<0) {
+			if(old->Index>=0) old=r;
+		}
+		else if(old->Index>=0 && r->Stamp<old->Stamp) old=r;
+	}
+
+	if(!++CacheStamp) {
+		// THE STAMPS WRAPPED AROUND, START OVER
+		for(k=0;k<GVLIST_CACHESIZE;++k) Cache[k].Index=-1;
+		CacheStamp=1;
+	}
+	old->Index=-1;
+	old->Item.TreeLevel=old->Item.StateFlags=old->Item.Data=0;
+	old->Text[0]=0;
+	if(!Provider->GetItem(Index,&old->Item,old->Text,GVLIST_TEXTSIZE)) return NULL;
+	old->Text[GVLIST_TEXTSIZE-1]=0;
+	old->Item.Text=old->Text;
+	old->Index=Index;
+	old->Stamp=CacheStamp;
+	return &old->Item;
+}
+
+
+void gVirtualListBox::EnsureVisible(int Index)
+{
+	int n=(DispItems>0)? DispItems:1;
+
+	if(Index<0) return;
+	if(Index<ViewItem) ViewItem=Index;
+	else if(Index>=ViewItem+n) ViewItem=Index-n+1;
+}
+
+void gVirtualListBox::SetSelection(int Index)
+{
+	if(Index<0 || Index>=NumRows || Index==SelectedItem) return;
+	SelectedItem=Index;
+	EnsureVisible(Index);
+	Invalidate();
+	vl_notify(this,GEVGUI_AFTERCHANGE,Index);
+}
+
+BOOL gVirtualListBox::MoveSelectionUp(int nlines)
+{
+	int k=SelectedItem-nlines;
+
+	if(k<0) k=0;
+	if(NumRows<=0 || k==SelectedItem) return FALSE;
+	SetSelection(k);
+	return TRUE;
+}
+
+BOOL gVirtualListBox::MoveSelectionDown(int nlines)
+{
+	int k=SelectedItem+nlines;
+
+	if(k>=NumRows) k=NumRows-1;
+	if(NumRows<=0 || k==SelectedItem) return FALSE;
+	SetSelection(k);
+	return TRUE;
+}
+
+// PROVIDERS THAT KNOW THE PARENT SHOULD SAY SO, THE SCAN FETCHES EVERY
+// PRECEDING SIBLING
+int gVirtualListBox::ParentItem(int Index)
+{
+	gListItem *it;
+	int k,level;
+
+	if(!Provider || Index<0 || Index>=NumRows) return -1;
+	k=Provider->ParentItem(Index);
+	if(k!=GVLIST_SCAN) return k;
+
+	it=GetItem(Index);
+	if(!it) return -1;
+	level=it->TreeLevel;
+	for(k=Index-1;k>=0;--k) {
+		it=GetItem(k);
+		if(it && it->TreeLevel<level) return k;
+	}
+	return -1;
+}
+
+void gVirtualListBox::Expand(int Index)
+{
+	int old=NumRows;
+
+	if(!Provider || Index<0 || Index>=NumRows) return;
+	if(!Provider->Expand(Index)) return;
+	RowsChanged(Index,Provider->Count()-old);
+	vl_notify(this,GEVGUI_AFTEREXPAND,Index);
+}
+
+void gVirtualListBox::Collapse(int Index)
+{
+	int old=NumRows;
+
+	if(!Provider || Index<0 || Index>=NumRows) return;
+	if(!Provider->Collapse(Index)) return;
+	RowsChanged(Index,Provider->Count()-old);
+	vl_notify(this,GEVGUI_AFTERCOLLAPSE,Index);
+}
+
+void gVirtualListBox::SetCheck(int Index,BOOL value)
+{
+	if(!Provider || Index<0 || Index>=NumRows) return;
+	if(!Provider->SetCheck(Index,value)) return;
+	RowsChanged(Index,0);
+	vl_notify(this,GEVGUI_AFTERCHECK,Index);
+}
+
+
+int gVirtualListBox::CalcItemWidth(int Index)
+{
+	gListItem *it=GetItem(Index);
+	gGlyphCache *gc;
+	int w;
+
+	if(!it) return 0;
+	w=(it->TreeLevel+1)*LEVELWIDTH;
+	if(it->StateFlags&LS_HASCHECK) w+=CHECKWIDTH;
+	gc=gGlyphCache::Get(&Font);
+	return w+((gc)? gc->TextWidth(it->Text):Font.TextWidth(it->Text));
+}
+
+BOOL gVirtualListBox::DrawItem(int Index,int y)
+{
+	gListItem *it=GetItem(Index);
+	gGlyphCache *gc;
+	int x,my,bk;
+
+	if(!it) return FALSE;
+	bk=(Index==SelectedItem)? SelColor:BkColor;
+	Rect(0,y,vl_width(this)-1,y+ItemHeight-1,bk);
+
+	x=it->TreeLevel*LEVELWIDTH;
+	my=y+(ItemHeight-VL_MARK)/2;
+	if(it->StateFlags&LS_EXPANDABLE) {
+		vl_box(this,x+1,my,Color);
+		HLine(my+2,x+2,x+4,Color);
+		if(!(it->StateFlags&LS_EXPANDED)) VLine(x+3,my+1,my+3,Color);
+	}
+	x+=LEVELWIDTH;
+	if(it->StateFlags&LS_HASCHECK) {
+		vl_box(this,x+1,my,Color);
+		if(it->StateFlags&LS_CHECKED) Rect(x+2,my+1,x+4,my+3,Color);
+		else if(it->StateFlags&LS_UNKNOWN) HLine(my+2,x+2,x+4,Color);
+		x+=CHECKWIDTH;
+	}
+
+	gc=gGlyphCache::Get(&Font);
+	if(gc) gc->DrawText(this,x,y+(ItemHeight-gc->Height)/2,it->Text,Color);
+	else DrawText(x,y+(ItemHeight-Font.TextHeight())/2,it->Text,&Font,Color);
+	return TRUE;
+}
+
+void gVirtualListBox::Update(gUpdate *u)
+{
+	int k,y,w,h,t1,t2;
+
+	if(ItemHeight>0) DispItems=ncheight/ItemHeight;
+	if(DispItems<1) DispItems=1;
+	w=vl_width(this);
+	h=ncheight;
+
+	RedrawFrame();
+	ClipToView(u);
+	for(k=0,y=0;y<h;++k,y+=ItemHeight) {
+		if(!DrawItem(ViewItem+k,y)) {
+			Rect(0,y,w-1,h-1,BkColor);
+			break;
+		}
+	}
+
+	if(VStyle&S_VSCROLLBAR) {
+		Rect(w,0,w+SCROLLBARWIDTH-1,h-1,BkColor);
+		VLine(w,0,h-1,Color);
+		if(NumRows>DispItems) {
+			t1=ViewItem*h/NumRows;
+			t2=(ViewItem+DispItems)*h/NumRows-1;
+			if(t2<t1) t2=t1;
+			Rect(w+1,t1,w+SCROLLBARWIDTH-1,t2,Color);
+		}
+	}
+}
+
+// KEYS: UP/DOWN MOVE, LEFT COLLAPSES OR GOES TO THE PARENT, RIGHT EXPANDS OR
+// GOES TO THE FIRST CHILD, ENTER TOGGLES THE CHECK MARK
+BOOL gVirtualListBox::DefaultEvent(gEvent *e)
+{
+	gListItem *it;
+	int k;
+
+	// NAVIGATION KEYS ONLY ON A PLAIN PRESS, SHIFTED KEYS GO TO THE HANDLERS
+	if(e->Type==GEVENT_KEYB && NumRows>0 && KM_MESSAGE(e->Arg)==KM_PRESS && !KM_SHIFTPLANE(e->Arg)) {
+		it=GetItem(SelectedItem);
+		switch(KM_KEY(e->Arg)) {
+		case KB_UP:
+			MoveSelectionUp(1);
+			return TRUE;
+		case KB_DN:
+			MoveSelectionDown(1);
+			return TRUE;
+		case KB_LF:
+			if(it && (it->StateFlags&LS_EXPANDED)) Collapse(SelectedItem);
+			else {
+				k=ParentItem(SelectedItem);
+				if(k>=0) SetSelection(k);
+			}
+			return TRUE;
+		case KB_RT:
+			if(it && (it->StateFlags&LS_EXPANDABLE)) {
+				if(it->StateFlags&LS_EXPANDED) MoveSelectionDown(1);
+				else Expand(SelectedItem);
+			}
+			return TRUE;
+		case KB_ENT:
+			if(it && (it->StateFlags&LS_HASCHECK)) SetCheck(SelectedItem,!(it->StateFlags&LS_CHECKED));
+			vl_notify(this,GEVGUI_ENTER,SelectedItem);
+			return TRUE;
+		}
+	}
+	return gControl::DefaultEvent(e);
+}
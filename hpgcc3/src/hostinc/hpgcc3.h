@@ -0,0 +1,40 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#ifndef _HPGCC3_ALL
+#define _HPGCC3_ALL
+
+// HOST BUILD ONLY - NOT INSTALLED
+// FOUND BEFORE THE INSTALLED hpgcc3.h, WHICH PULLS IN sys.h AND THE REST OF
+// THE CALCULATOR C LIBRARY. ONLY WHAT THE GUI MODULES BUILT ON THE HOST
+// NEED IS KEPT, THE C LIBRARY IS THE HOST ONE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _LONGLONG_DEF
+typedef unsigned long long ULONGLONG;
+typedef long long LONGLONG;
+#define _LONGLONG_DEF
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <keyb.h>
+#include <kos.h>
+
+// FROM sys.h
+typedef ULONGLONG tmr_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,29 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#ifndef __MASTER_GLOBALS_H
+#define __MASTER_GLOBALS_H
+
+// HOST BUILD ONLY - NOT INSTALLED
+// FOUND BEFORE THE INSTALLED master_globals.h, WHICH PULLS IN THE CALCULATOR
+// C LIBRARY. ONLY THE FIELDS USED BY THE ADD-ON MODULES ARE KEPT, THE
+// GLOBALS LIVE IN hpg/hpghost.c
+
+#ifndef __HPGRAPHICS_TYPE_DEFINED
+#define __HPGRAPHICS_TYPE_DEFINED 1
+struct hpg_graphics;
+typedef struct hpg_graphics hpg_t;
+#endif
+
+typedef struct {
+	hpg_t *hpg_stdscreen;
+} MASTER_GLOBALS;
+
+extern MASTER_GLOBALS *__mg;
+
+#endif // __MASTER_GLOBALS_H
@@ -0,0 +1,177 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <stdlib.h>
+#include <string.h>
+#include <hpgraphics.h>
+
+// CROSS-DEPTH BLITS
+// THE DESTINATION IS ONLY REACHABLE THROUGH THE PUBLIC API, SO EACH SOURCE
+// ROW IS CONVERTED TO HPG COLORS (THROUGH THE LEVEL TABLE OF A STATIC IMAGE
+// OR THE DITHER THRESHOLDS), SPLIT INTO RUNS OF ONE COLOR AND DRAWN WITH ONE
+// hpg_fill_rect_on PER RUN. IDENTICAL ROWS ARE MERGED INTO TALLER RECTANGLES.
+// hpg_fill_rect_on APPLIES THE CLIP RECTANGLE, MODE AND PATTERN OF THE
+// DESTINATION, SO XOR MODE WORKS AS WITH ANY OTHER DRAWING
+
+// ORDERED DITHER, 4x4 BAYER MATRIX
+static const unsigned char blit_bayer[4][4]={
+	{ 0, 8, 2,10 },
+	{12, 4,14, 6 },
+	{ 3,11, 1, 9 },
+	{15, 7,13, 5 }
+};
+
+typedef struct {
+	hpg_t *dst;
+	int dx,dy,w;
+	int flags;
+	int levels;				// DITHER LEVELS - 1, 0 = NO DITHER
+	short thr[3][16];		// COLOR THRESHOLD OF EACH LEVEL, BY BAYER VALUE
+	unsigned char *row,*prev;
+	int ypend;				// FIRST ROW OF THE PENDING RECTANGLES, -1 = NONE
+	int color;				// LAST COLOR SET ON dst
+} hpgblitter;
+
+// CLIP THE AREA TO BOTH IMAGES, RETURN 0 IF NOTHING IS LEFT
+static int blit_clip(int *sx,int *sy,int *w,int *h,int *dx,int *dy,int srcw,int srch,hpg_t *dst)
+{
+	int d;
+
+	if(*sx<0) { *dx-=*sx; *w+=*sx; *sx=0; }
+	if(*sy<0) { *dy-=*sy; *h+=*sy; *sy=0; }
+	if(*dx<0) { *sx-=*dx; *w+=*dx; *dx=0; }
+	if(*dy<0) { *sy-=*dy; *h+=*dy; *dy=0; }
+	if(*sx+*w>srcw) *w=srcw-*sx;
+	if(*sy+*h>srch) *h=srch-*sy;
+	d=hpg_get_width(dst);
+	if(*dx+*w>d) *w=d-*dx;
+	d=hpg_get_height(dst);
+	if(*dy+*h>d) *h=d-*dy;
+	return *w>0 && *h>0;
+}
+
+static int blit_begin(hpgblitter *b,hpg_t *dst,int dx,int dy,int w,int flags)
+{
+	int k,bv,n,t;
+
+	b->row=(unsigned char *)hpg_pool_malloc(2*w);
+	if(!b->row) return 0;
+	b->prev=b->row+w;
+	b->dst=dst;
+	b->dx=dx;
+	b->dy=dy;
+	b->w=w;
+	b->flags=flags;
+	b->ypend=-1;
+	b->color=-1;
+
+	// LEVEL q OF n IS REACHED WHEN c*n*32+(2*bv+1)*255 >= q*255*32
+	if(flags&HPG_BLIT_DITHER_MONO) b->levels=1;
+	else if(flags&HPG_BLIT_DITHER_GRAY4) b->levels=3;
+	else b->levels=0;
+	n=b->levels;
+	for(k=1;k<=n;++k) {
+		for(bv=0;bv<16;++bv) {
+			t=k*8160-(2*bv+1)*255;
+			b->thr[k-1][bv]=(t<=0)? 0:(t+n*32-1)/(n*32);
+		}
+	}
+	return 1;
+}
+
+// DRAW THE PENDING ROWS [ypend,y) OF RUNS
+static void blit_flush(hpgblitter *b,int y)
+{
+	unsigned char *p=b->prev;
+	int i,start;
+
+	if(b->ypend<0 || y<=b->ypend) return;
+	for(i=0;i<b->w;) {
+		start=i;
+		while(i<b->w && p[i]==p[start]) ++i;
+		if(!p[start] && (b->flags&HPG_BLIT_TRANSPARENT)) continue;
+		if(p[start]!=b->color) {
+			b->color=p[start];
+			hpg_set_color(b->dst,(unsigned char)b->color);
+		}
+		hpg_fill_rect_on(b->dst,b->dx+start,b->dy+b->ypend,b->dx+i-1,b->dy+y-1);
+	}
+}
+
+// row HOLDS THE COLORS OF SOURCE ROW y
+static void blit_row(hpgblitter *b,int y)
+{
+	unsigned char *swap;
+	const unsigned char *bayer;
+	int i,c,q,n=b->levels;
+
+	if(n) {
+		bayer=blit_bayer[(b->dy+y)&3];
+		for(i=0;i<b->w;++i) {
+			c=b->row[i];
+			q=(c>=b->thr[0][bayer[(b->dx+i)&3]]);
+			if(n==3) q+=(c>=b->thr[1][bayer[(b->dx+i)&3]])+(c>=b->thr[2][bayer[(b->dx+i)&3]]);
+			b->row[i]=(unsigned char)(q*255/n);
+		}
+	}
+
+	if(b->ypend>=0 && !memcmp(b->row,b->prev,b->w)) return;
+	blit_flush(b,y);
+	swap=b->prev; b->prev=b->row; b->row=swap;
+	b->ypend=y;
+}
+
+static void blit_end(hpgblitter *b,int y,unsigned char oldcolor)
+{
+	blit_flush(b,y);
+	hpg_set_color(b->dst,oldcolor);
+	// row AND prev MAY HAVE BEEN SWAPPED
+	hpg_pool_free((b->row<b->prev)? b->row:b->prev);
+}
+
+
+void hpg_blit_static(const hpg_static_t *src,int sx,int sy,int w,int h,hpg_t *dst,int dx,int dy,int flags)
+{
+	hpgblitter b;
+	unsigned char lut[16],oldcolor;
+	unsigned int mask;
+	int bpp=src->bpp,i,y,off,maxv;
+
+	if(bpp!=1 && bpp!=2 && bpp!=4) return;
+	if(!blit_clip(&sx,&sy,&w,&h,&dx,&dy,src->width,src->height,dst)) return;
+	if(!blit_begin(&b,dst,dx,dy,w,flags)) return;
+
+	maxv=(1<<bpp)-1;
+	mask=maxv;
+	for(i=0;i<=maxv;++i) lut[i]=(unsigned char)(i*255/maxv);
+
+	oldcolor=hpg_get_color(dst);
+	for(y=0;y<h;++y) {
+		off=((sy+y)*src->width+sx)*bpp;
+		for(i=0;i<w;++i,off+=bpp) b.row[i]=lut[(src->bits[off>>5]>>(off&31))&mask];
+		blit_row(&b,y);
+	}
+	blit_end(&b,h,oldcolor);
+}
+
+void hpg_blit_convert(hpg_t *src,int sx,int sy,int w,int h,hpg_t *dst,int dx,int dy,int flags)
+{
+	hpgblitter b;
+	unsigned char oldcolor;
+	int i,y;
+
+	if(!blit_clip(&sx,&sy,&w,&h,&dx,&dy,hpg_get_width(src),hpg_get_height(src),dst)) return;
+	if(!blit_begin(&b,dst,dx,dy,w,flags)) return;
+
+	oldcolor=hpg_get_color(dst);
+	for(y=0;y<h;++y) {
+		for(i=0;i<w;++i) b.row[i]=hpg_get_pixel(src,sx+i,sy+y);
+		blit_row(&b,y);
+	}
+	blit_end(&b,h,oldcolor);
+}
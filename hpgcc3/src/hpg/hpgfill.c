@@ -0,0 +1,190 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <stdlib.h>
+#include <string.h>
+#include <hpgraphics.h>
+
+// POLYGON FILLING, EDGE TABLE + ACTIVE EDGE LIST
+// ALL POLYGONS OF A BATCH SHARE ONE EDGE TABLE AND ONE PASS OVER THE
+// SCANLINES. EACH POLYGON IS FILLED WITH THE EVEN-ODD RULE, COVERING
+// [ceil(xa),ceil(xb)) BETWEEN PAIRS OF ITS OWN CROSSINGS (TOP-LEFT RULE, SO
+// POLYGONS THAT SHARE AN EDGE NEVER OVERLAP AND XOR MODE WORKS ACROSS THEM).
+// SPANS ARE CLIPPED TO THE IMAGE ONCE, MERGED WHEN THEY TOUCH, AND REPEATED
+// ROWS OF IDENTICAL SPANS ARE SENT AS A SINGLE hpg_fill_rect_on, WHICH APPLIES
+// THE CLIP RECTANGLE, COLOR, MODE AND PATTERN AND WRITES WHOLE WORDS
+
+typedef struct {
+	int ytop,ybot;		// SCANLINES [ytop,ybot)
+	int q,r;			// CROSSING = q + r/dy, 0 <= r < dy
+	int dq,dr,dy;		// STEP PER SCANLINE = dq + dr/dy
+	int poly;			// POLYGON NUMBER WITHIN THE BATCH
+} hpgpedge;
+
+typedef struct {
+	int x1,x2;
+} hpgspan;
+
+// FLOOR DIVISION, b>0
+static inline int fill_fdiv(int a,int b)
+{
+	return (a>=0)? a/b:-((b-1-a)/b);
+}
+
+// ADVANCE AN EDGE BY n SCANLINES AT ONCE
+static void fill_skip(hpgpedge *e,int n)
+{
+	long long r=(long long)e->dr*n+e->r;
+	e->q+=e->dq*n+(int)(r/e->dy);
+	e->r=(int)(r%e->dy);
+}
+
+// ORDER OF THE ACTIVE LIST: BY POLYGON, THEN BY CROSSING
+static inline int fill_before(hpgpedge *a,hpgpedge *b)
+{
+	if(a->poly!=b->poly) return a->poly<b->poly;
+	if(a->q!=b->q) return a->q<b->q;
+	return (long long)a->r*b->dy<(long long)b->r*a->dy;
+}
+
+// DRAW THE PENDING ROWS [ystart,y) OF SPANS
+static void fill_flush(hpg_t *g,hpgspan *spans,int nspans,int ystart,int y)
+{
+	int k;
+	if(y<=ystart) return;
+	for(k=0;k<nspans;++k) hpg_fill_rect_on(g,spans[k].x1,ystart,spans[k].x2,y-1);
+}
+
+void hpg_fill_polygons_on(hpg_t *g,int vx[],int vy[],int lens[],int count)
+{
+	hpgpedge *edges,*e,**active,*t,tmp;
+	hpgspan *spans,*prev,*swap;
+	int total,nedges,nactive,nextedge,nspans,nprev,ypend;
+	int p,k,j,first,next,x0,y0,x1,y1,num,y,ymin,ymax,xl,xr,width,height;
+
+	if(count<=0) return;
+	total=0;
+	for(p=0;p<count;++p) if(lens[p]>0) total+=lens[p];
+	if(total<3) return;
+
+	width=hpg_get_width(g);
+	height=hpg_get_height(g);
+
+	// ONE BLOCK FOR THE EDGE TABLE, THE ACTIVE LIST AND TWO ROWS OF SPANS
+	// A SCANLINE CROSSES AT MOST total EDGES, SO THERE ARE AT MOST total/2 SPANS
+	edges=(hpgpedge *)hpg_pool_malloc(total*(sizeof(hpgpedge)+sizeof(hpgpedge *)+sizeof(hpgspan)));
+	if(!edges) return;
+	active=(hpgpedge **)(edges+total);
+	spans=(hpgspan *)(active+total);
+	prev=spans+(total>>1);
+
+	// BUILD THE EDGE TABLE, SKIPPING HORIZONTAL EDGES AND DEGENERATE POLYGONS
+	nedges=0;
+	ymin=0x7fffffff;
+	ymax=-0x7fffffff;
+	first=0;
+	for(p=0;p<count;first+=(lens[p]>0)? lens[p]:0,++p) {
+		if(lens[p]<3) continue;
+		for(k=0;k<lens[p];++k) {
+			next=(k+1<lens[p])? k+1:0;
+			x0=vx[first+k]; y0=vy[first+k];
+			x1=vx[first+next]; y1=vy[first+next];
+			if(y0==y1) continue;
+			if(y0>y1) {
+				j=x0; x0=x1; x1=j;
+				j=y0; y0=y1; y1=j;
+			}
+			e=edges+nedges++;
+			e->ytop=y0;
+			e->ybot=y1;
+			e->dy=y1-y0;
+			e->q=x0;
+			e->r=0;
+			num=x1-x0;
+			e->dq=fill_fdiv(num,e->dy);
+			e->dr=num-e->dq*e->dy;
+			e->poly=p;
+			if(y0<ymin) ymin=y0;
+			if(y1>ymax) ymax=y1;
+		}
+	}
+
+	// VERTICAL CLIPPING, ONCE FOR THE WHOLE BATCH
+	if(ymin<0) ymin=0;
+	if(ymax>height) ymax=height;
+
+	// SORT THE EDGE TABLE BY TOP SCANLINE
+	for(k=1;k<nedges;++k) {
+		tmp=edges[k];
+		for(j=k-1;j>=0 && edges[j].ytop>tmp.ytop;--j) edges[j+1]=edges[j];
+		edges[j+1]=tmp;
+	}
+
+	nactive=0;
+	nextedge=0;
+	nprev=0;
+	ypend=ymin;
+	for(y=ymin;y<ymax;++y) {
+		// DROP FINISHED EDGES, ADD NEW ONES (EDGES THAT START ABOVE THE IMAGE
+		// ARE MOVED DOWN TO THE FIRST VISIBLE SCANLINE IN ONE STEP)
+		for(k=j=0;k<nactive;++k) if(active[k]->ybot>y) active[j++]=active[k];
+		nactive=j;
+		while(nextedge<nedges && edges[nextedge].ytop<=y) {
+			e=edges+nextedge++;
+			if(e->ybot<=y) continue;
+			if(e->ytop<y) fill_skip(e,y-e->ytop);
+			active[nactive++]=e;
+		}
+
+		// INSERTION SORT, THE LIST IS ALMOST SORTED FROM THE PREVIOUS SCANLINE
+		for(k=1;k<nactive;++k) {
+			t=active[k];
+			for(j=k-1;j>=0 && fill_before(t,active[j]);--j) active[j+1]=active[j];
+			active[j+1]=t;
+		}
+
+		// PAIR THE CROSSINGS OF EACH POLYGON, CLIP AND MERGE TOUCHING SPANS
+		nspans=0;
+		for(k=0;k+1<nactive;) {
+			if(active[k]->poly!=active[k+1]->poly) { ++k; continue; }
+			xl=active[k]->q+(active[k]->r>0);
+			xr=active[k+1]->q+(active[k+1]->r>0)-1;
+			k+=2;
+			if(xl<0) xl=0;
+			if(xr>=width) xr=width-1;
+			if(xl>xr) continue;
+			// SPANS OF DIFFERENT POLYGONS ARE NOT SORTED, ONLY MERGE CONSECUTIVE ONES
+			if(nspans && spans[nspans-1].x2+1==xl) spans[nspans-1].x2=xr;
+			else if(nspans && xr+1==spans[nspans-1].x1) spans[nspans-1].x1=xl;
+			else {
+				spans[nspans].x1=xl;
+				spans[nspans].x2=xr;
+				++nspans;
+			}
+		}
+
+		// SAME SPANS AS THE PREVIOUS SCANLINE: EXTEND THE PENDING RECTANGLES
+		if(nspans!=nprev || memcmp(spans,prev,nspans*sizeof(hpgspan))) {
+			fill_flush(g,prev,nprev,ypend,y);
+			swap=prev; prev=spans; spans=swap;
+			nprev=nspans;
+			ypend=y;
+		}
+
+		// STEP TO THE NEXT SCANLINE
+		for(k=0;k<nactive;++k) {
+			e=active[k];
+			e->q+=e->dq;
+			e->r+=e->dr;
+			if(e->r>=e->dy) { e->r-=e->dy; ++e->q; }
+		}
+	}
+	fill_flush(g,prev,nprev,ypend,y);
+
+	hpg_pool_free(edges);
+}
@@ -0,0 +1,303 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <stdlib.h>
+#include <string.h>
+#include <hpgraphics.h>
+#include <master_globals.h>
+
+// HOST BUILD ONLY: STAND-INS FOR THE ROUTINES OF THE PREBUILT libarmhpg THAT
+// THE ADD-ON MODULES USE, OVER AN IN-MEMORY FRAMEBUFFER OF ONE BYTE PER
+// PIXEL. COLORS ARE REDUCED TO THE DEPTH OF THE IMAGE WHEN WRITTEN, SO
+// hpg_get_pixel RETURNS WHAT THE CALCULATOR WOULD. PATTERNS AND FONTS ARE
+// ONE BYTE PER ROW, LEAST SIGNIFICANT BIT = LEFT PIXEL. THE TWO BUILT-IN
+// FONTS ARE SYNTHETIC, BUT STABLE, SO GOLDEN IMAGES DON'T DEPEND ON THE ROM
+
+struct hpg_graphics {
+	int width,height,bpp;
+	unsigned char *pixels;
+	unsigned char color,mode;
+	hpg_pattern_t *pattern;
+	hpg_font_t *font;
+	int cx1,cy1,cx2,cy2;
+};
+
+struct hpg_pattern {
+	char *buffer;
+	int height,fixed;
+};
+
+struct hpg_font {
+	char *buffer;
+	int count,height,advance;
+};
+
+static MASTER_GLOBALS host_globals;
+MASTER_GLOBALS *__mg=&host_globals;
+
+static hpg_font_t host_minifont,host_bigfont;
+static char host_minibits[256*6],host_bigbits[256*8];
+
+
+static unsigned char host_depth(hpg_t *g,unsigned char c)
+{
+	switch(g->bpp) {
+	case 1: return (c&0x80)? 0xff:0x00;
+	case 2: return (c>>6)*0x55;
+	default: return (c>>4)*0x11;
+	}
+}
+
+static inline void host_pset(hpg_t *g,int x,int y,unsigned char c)
+{
+	unsigned char *p;
+
+	if(x<g->cx1 || x>g->cx2 || y<g->cy1 || y>g->cy2) return;
+	p=g->pixels+y*g->width+x;
+	*p=host_depth(g,(g->mode==HPG_MODE_XOR)? *p^c:c);
+}
+
+static hpg_t *host_image(int width,int height,int bpp)
+{
+	hpg_t *g=(hpg_t *)malloc(sizeof(hpg_t)+width*height);
+
+	if(!g) return NULL;
+	memset(g,0,sizeof(hpg_t));
+	g->width=width;
+	g->height=height;
+	g->bpp=bpp;
+	g->pixels=(unsigned char *)(g+1);
+	g->color=HPG_COLOR_BLACK;
+	hpg_clip_reset(g);
+	return g;
+}
+
+// A GLYPH OF 1 TO 8 COLUMNS, HASHED FROM THE CHARACTER CODE
+static void host_mkfont(hpg_font_t *f,char *bits,int height,int advance)
+{
+	unsigned h;
+	int c,r;
+
+	for(c=0;c<256;++c) {
+		h=c*2654435761U;
+		for(r=0;r<height;++r) {
+			h=h*1103515245U+12345U;
+			bits[c*height+r]=(c<=' ' || r==height-1)? 0:(char)((h>>16)&((1<<(advance-1))-1));
+		}
+	}
+	f->buffer=bits;
+	f->count=256;
+	f->height=height;
+	f->advance=advance;
+}
+
+
+void hpg_init(void)
+{
+	if(!HPG_STDSCREEN) HPG_STDSCREEN=host_image(131,80,4);
+}
+
+void hpg_cleanup(void)
+{
+	free(HPG_STDSCREEN);
+	HPG_STDSCREEN=NULL;
+}
+
+hpg_t *hpg_alloc_mono_image(int width,int height)
+{
+	return host_image(width,height,1);
+}
+
+hpg_t *hpg_alloc_gray4_image(int width,int height)
+{
+	return host_image(width,height,2);
+}
+
+hpg_t *hpg_alloc_gray16_image(int width,int height)
+{
+	return host_image(width,height,4);
+}
+
+void hpg_free_image(hpg_t *img)
+{
+	free(img);
+}
+
+int hpg_get_width(hpg_t *g) { return g->width; }
+int hpg_get_height(hpg_t *g) { return g->height; }
+unsigned char hpg_get_color(hpg_t *g) { return g->color; }
+void hpg_set_color(hpg_t *g,unsigned char color) { g->color=color; }
+unsigned char hpg_get_mode(hpg_t *g) { return g->mode; }
+void hpg_set_mode(hpg_t *g,unsigned char mode) { g->mode=mode; }
+hpg_pattern_t *hpg_get_pattern(hpg_t *g) { return g->pattern; }
+void hpg_set_pattern(hpg_t *g,hpg_pattern_t *pattern) { g->pattern=pattern; }
+hpg_font_t *hpg_get_font(hpg_t *g) { return g->font? g->font:hpg_get_minifont(); }
+void hpg_set_font(hpg_t *g,hpg_font_t *font) { g->font=font; }
+
+unsigned char hpg_get_pixel(hpg_t *g,int x,int y)
+{
+	if(x<0 || y<0 || x>=g->width || y>=g->height) return 0;
+	return g->pixels[y*g->width+x];
+}
+
+void hpg_clip_reset(hpg_t *g)
+{
+	g->cx1=g->cy1=0;
+	g->cx2=g->width-1;
+	g->cy2=g->height-1;
+}
+
+void hpg_clip(hpg_t *g,int x1,int y1,int x2,int y2)
+{
+	if(x1>g->cx1) g->cx1=x1;
+	if(y1>g->cy1) g->cy1=y1;
+	if(x2<g->cx2) g->cx2=x2;
+	if(y2<g->cy2) g->cy2=y2;
+}
+
+void hpg_clip_set(hpg_t *g,int x1,int y1,int x2,int y2)
+{
+	hpg_clip_reset(g);
+	hpg_clip(g,x1,y1,x2,y2);
+}
+
+void hpg_clear_on(hpg_t *g)
+{
+	memset(g->pixels,HPG_COLOR_WHITE,g->width*g->height);
+}
+
+void hpg_draw_pixel_on(hpg_t *g,int x,int y)
+{
+	host_pset(g,x,y,g->color);
+}
+
+void hpg_fill_rect_on(hpg_t *g,int x1,int y1,int x2,int y2)
+{
+	hpg_pattern_t *pat=g->pattern;
+	int x,y,t,px,py;
+
+	if(x1>x2) { t=x1; x1=x2; x2=t; }
+	if(y1>y2) { t=y1; y1=y2; y2=t; }
+	for(y=y1;y<=y2;++y) {
+		for(x=x1;x<=x2;++x) {
+			if(pat) {
+				px=pat->fixed? x:x-x1;
+				py=pat->fixed? y:y-y1;
+				if(!((pat->buffer[py%pat->height]>>(px&7))&1)) continue;
+			}
+			host_pset(g,x,y,g->color);
+		}
+	}
+}
+
+void hpg_draw_line_on(hpg_t *g,int x1,int y1,int x2,int y2)
+{
+	int dx=abs(x2-x1),dy=-abs(y2-y1),sx=(x1<x2)? 1:-1,sy=(y1<y2)? 1:-1,err=dx+dy,e2;
+
+	for(;;) {
+		host_pset(g,x1,y1,g->color);
+		if(x1==x2 && y1==y2) break;
+		e2=2*err;
+		if(e2>=dy) { err+=dy; x1+=sx; }
+		if(e2<=dx) { err+=dx; y1+=sy; }
+	}
+}
+
+void hpg_blit(hpg_t *src,int sx,int sy,int w,int h,hpg_t *dst,int dx,int dy)
+{
+	unsigned char oldmode=dst->mode;
+	int x,y;
+
+	dst->mode=HPG_MODE_PAINT;
+	for(y=0;y<h;++y) {
+		if(sy+y<0 || sy+y>=src->height) continue;
+		for(x=0;x<w;++x) {
+			if(sx+x<0 || sx+x>=src->width) continue;
+			host_pset(dst,dx+x,dy+y,src->pixels[(sy+y)*src->width+sx+x]);
+		}
+	}
+	dst->mode=oldmode;
+}
+
+hpg_pattern_t *hpg_alloc_pattern(char *buffer,int height,int fixed)
+{
+	hpg_pattern_t *p=(hpg_pattern_t *)malloc(sizeof(hpg_pattern_t));
+
+	if(!p) return NULL;
+	p->buffer=buffer;
+	p->height=height;
+	p->fixed=fixed;
+	return p;
+}
+
+void hpg_free_pattern(hpg_pattern_t *pattern)
+{
+	free(pattern);
+}
+
+hpg_font_t *hpg_alloc_font(char *buffer,int count,int height,int advance)
+{
+	hpg_font_t *f=(hpg_font_t *)malloc(sizeof(hpg_font_t));
+
+	if(!f) return NULL;
+	f->buffer=buffer;
+	f->count=count;
+	f->height=height;
+	f->advance=advance;
+	return f;
+}
+
+void hpg_free_font(hpg_font_t *font)
+{
+	free(font);
+}
+
+hpg_font_t *hpg_get_minifont(void)
+{
+	if(!host_minifont.buffer) host_mkfont(&host_minifont,host_minibits,6,4);
+	return &host_minifont;
+}
+
+hpg_font_t *hpg_get_bigfont(void)
+{
+	if(!host_bigfont.buffer) host_mkfont(&host_bigfont,host_bigbits,8,6);
+	return &host_bigfont;
+}
+
+int hpg_font_get_height(hpg_font_t *font) { return font->height; }
+int hpg_font_get_advance(hpg_font_t *font) { return font->advance; }
+
+void hpg_draw_letter_on(hpg_t *g,char a,int x,int y)
+{
+	hpg_font_t *f=hpg_get_font(g);
+	unsigned char c=(unsigned char)a;
+	int r,k;
+
+	if(c>=f->count) return;
+	for(r=0;r<f->height;++r) {
+		for(k=0;k<f->advance && k<8;++k) {
+			if((f->buffer[c*f->height+r]>>k)&1) host_pset(g,x+k,y+r,g->color);
+		}
+	}
+}
+
+void hpg_draw_text_on(hpg_t *g,char *s,int x,int y)
+{
+	hpg_font_t *f=hpg_get_font(g);
+	int cx=x;
+
+	for(;*s;++s) {
+		if(*s=='\n') {
+			cx=x;
+			y+=f->height;
+			continue;
+		}
+		hpg_draw_letter_on(g,*s,cx,y);
+		cx+=f->advance;
+	}
+}
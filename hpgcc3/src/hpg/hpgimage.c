@@ -0,0 +1,51 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <stdlib.h>
+#include <hpgraphics.h>
+
+// IMAGES COMPILED AT BUILD TIME (SEE tools/hpgimgc.c)
+// THE IMAGE IS CLEARED TO WHITE AND THE REST IS PAINTED STRAIGHT FROM THE
+// STATIC BITS, ONE hpg_fill_rect_on PER HORIZONTAL RUN OF ONE NON-WHITE
+// VALUE. NOTHING BUT THE IMAGE ITSELF IS ALLOCATED
+
+// VALUE OF THE PIXEL AT BIT OFFSET off
+static inline int image_pixel(const hpg_static_t *img,int off,unsigned int mask)
+{
+	return (img->bits[off>>5]>>(off&31))&mask;
+}
+
+hpg_t *hpg_image_from_static(const hpg_static_t *img)
+{
+	hpg_t *g;
+	unsigned int mask;
+	int bpp=img->bpp,x,y,v,start,off;
+
+	switch(bpp) {
+	case 1: g=hpg_alloc_mono_image(img->width,img->height); break;
+	case 2: g=hpg_alloc_gray4_image(img->width,img->height); break;
+	case 4: g=hpg_alloc_gray16_image(img->width,img->height); break;
+	default: return NULL;
+	}
+	if(!g) return NULL;
+
+	hpg_clear_on(g);
+	mask=(1<<bpp)-1;
+	for(y=0;y<img->height;++y) {
+		off=y*img->width*bpp;
+		for(x=0;x<img->width;) {
+			start=x;
+			v=image_pixel(img,off+x*bpp,mask);
+			while(++x<img->width && image_pixel(img,off+x*bpp,mask)==v) ;
+			if(!v) continue;
+			hpg_set_color(g,(unsigned char)(v*255/mask));
+			hpg_fill_rect_on(g,start,y,x-1,y);
+		}
+	}
+	return g;
+}
@@ -0,0 +1,304 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <stdlib.h>
+#include <string.h>
+#include <hpgraphics.h>
+
+// RETAINED LAYERS
+// EVERY CHANGE (MOVE, SHOW, HIDE, RESTACK, NEW CONTENTS) ADDS THE SCREEN AREA
+// IT AFFECTS TO A SHORT LIST OF DIRTY RECTANGLES. OVERLAPPING OR TOUCHING
+// RECTANGLES ARE MERGED, AND WHEN THE LIST IS FULL THE NEW RECTANGLE IS
+// MERGED WITH THE ONE THAT GROWS THE LEAST. hpg_layers_compose REDRAWS ONLY
+// THOSE RECTANGLES: FROM THE TOPMOST OPAQUE LAYER THAT COVERS THE WHOLE
+// RECTANGLE (OR THE BACKGROUND) UP, EACH LAYER BLITTED ONCE.
+// WITH A DOUBLE-BUFFERED TARGET THE BUFFER BEING DRAWN LAST RECEIVED THE
+// FRAME BEFORE THE PREVIOUS ONE, SO THE PREVIOUS DIRTY LIST IS REDRAWN TOO
+
+typedef struct {
+	int x1,y1,x2,y2;
+} hpglrect;
+
+typedef struct {
+	hpg_t *img;				// NULL = FREE SLOT
+	int x,y,w,h;
+	int flags;
+} hpglayer;
+
+struct hpg_layers {
+	hpg_t *target;
+	int width,height;
+	int maxlayers;
+	hpglayer *layers;		// BY ID
+	int *order;				// IDS FROM BOTTOM TO TOP
+	int nlayers;
+	int dbuf;
+	unsigned char bgcolor;
+	hpglrect dirty[HPG_LAYERS_MAXDIRTY];
+	int ndirty;
+	hpglrect prev[HPG_LAYERS_MAXDIRTY];
+	int nprev;
+};
+
+
+static inline int layer_area(hpglrect *r)
+{
+	return (r->x2-r->x1+1)*(r->y2-r->y1+1);
+}
+
+static inline void layer_union(hpglrect *a,hpglrect *b)
+{
+	if(b->x1<a->x1) a->x1=b->x1;
+	if(b->y1<a->y1) a->y1=b->y1;
+	if(b->x2>a->x2) a->x2=b->x2;
+	if(b->y2>a->y2) a->y2=b->y2;
+}
+
+// ADD A RECTANGLE TO A LIST OF AT MOST HPG_LAYERS_MAXDIRTY
+static void layer_addrect(hpglrect *list,int *count,hpglrect r)
+{
+	hpglrect u;
+	int k,best,grow,bestgrow;
+
+	for(;;) {
+		// MERGE WITH ANY RECTANGLE THAT OVERLAPS OR TOUCHES, THE UNION MAY
+		// REACH OTHERS, SO START OVER
+		for(k=0;k<*count;++k) {
+			if(r.x1<=list[k].x2+1 && list[k].x1<=r.x2+1 && r.y1<=list[k].y2+1 && list[k].y1<=r.y2+1) break;
+		}
+		if(k==*count) break;
+		layer_union(&r,&list[k]);
+		list[k]=list[--*count];
+	}
+
+	if(*count<HPG_LAYERS_MAXDIRTY) {
+		list[(*count)++]=r;
+		return;
+	}
+
+	// FULL, MERGE WITH THE RECTANGLE THAT GROWS THE LEAST AND ADD THE RESULT
+	best=0;
+	bestgrow=0x7fffffff;
+	for(k=0;k<*count;++k) {
+		u=list[k];
+		layer_union(&u,&r);
+		grow=layer_area(&u)-layer_area(&list[k])-layer_area(&r);
+		if(grow<bestgrow) { bestgrow=grow; best=k; }
+	}
+	layer_union(&r,&list[best]);
+	list[best]=list[--*count];
+	layer_addrect(list,count,r);
+}
+
+static void layer_dirty(hpg_layers_t *l,int x1,int y1,int x2,int y2)
+{
+	hpglrect r;
+
+	if(x1<0) x1=0;
+	if(y1<0) y1=0;
+	if(x2>=l->width) x2=l->width-1;
+	if(y2>=l->height) y2=l->height-1;
+	if(x1>x2 || y1>y2) return;
+	r.x1=x1; r.y1=y1; r.x2=x2; r.y2=y2;
+	layer_addrect(l->dirty,&l->ndirty,r);
+}
+
+static void layer_dirtylayer(hpg_layers_t *l,hpglayer *ly)
+{
+	if(ly->flags&HPG_LAYER_VISIBLE) layer_dirty(l,ly->x,ly->y,ly->x+ly->w-1,ly->y+ly->h-1);
+}
+
+static hpglayer *layer_get(hpg_layers_t *l,int id)
+{
+	if(id<0 || id>=l->maxlayers || !l->layers[id].img) return NULL;
+	return &l->layers[id];
+}
+
+// DRAW THE LAYERS OVER ONE SCREEN RECTANGLE
+static void layer_compose(hpg_layers_t *l,hpglrect *r)
+{
+	hpglayer *ly;
+	int k,start,x1,y1,x2,y2;
+
+	// LAYERS UNDER AN OPAQUE LAYER THAT COVERS THE WHOLE RECTANGLE ARE HIDDEN
+	for(start=l->nlayers-1;start>=0;--start) {
+		ly=&l->layers[l->order[start]];
+		if((ly->flags&(HPG_LAYER_VISIBLE|HPG_LAYER_TRANSPARENT))!=HPG_LAYER_VISIBLE) continue;
+		if(ly->x<=r->x1 && ly->y<=r->y1 && ly->x+ly->w>r->x2 && ly->y+ly->h>r->y2) break;
+	}
+	if(start<0) {
+		hpg_fill_rect_on(l->target,r->x1,r->y1,r->x2,r->y2);
+		start=0;
+	}
+
+	for(k=start;k<l->nlayers;++k) {
+		ly=&l->layers[l->order[k]];
+		if(!(ly->flags&HPG_LAYER_VISIBLE)) continue;
+		x1=(ly->x>r->x1)? ly->x:r->x1;
+		y1=(ly->y>r->y1)? ly->y:r->y1;
+		x2=(ly->x+ly->w-1<r->x2)? ly->x+ly->w-1:r->x2;
+		y2=(ly->y+ly->h-1<r->y2)? ly->y+ly->h-1:r->y2;
+		if(x1>x2 || y1>y2) continue;
+		if(ly->flags&HPG_LAYER_TRANSPARENT)
+			hpg_blit_convert(ly->img,x1-ly->x,y1-ly->y,x2-x1+1,y2-y1+1,l->target,x1,y1,HPG_BLIT_TRANSPARENT);
+		else hpg_blit(ly->img,x1-ly->x,y1-ly->y,x2-x1+1,y2-y1+1,l->target,x1,y1);
+	}
+}
+
+
+hpg_layers_t *hpg_alloc_layers(hpg_t *target,int maxlayers,int dbuf)
+{
+	hpg_layers_t *l;
+
+	if(maxlayers<1) return NULL;
+	l=(hpg_layers_t *)malloc(sizeof(hpg_layers_t)+maxlayers*(sizeof(hpglayer)+sizeof(int)));
+	if(!l) return NULL;
+	l->layers=(hpglayer *)(l+1);
+	l->order=(int *)(l->layers+maxlayers);
+	memset((char *)l->layers,0,maxlayers*sizeof(hpglayer));
+	l->target=target;
+	l->width=hpg_get_width(target);
+	l->height=hpg_get_height(target);
+	l->maxlayers=maxlayers;
+	l->nlayers=0;
+	l->dbuf=dbuf;
+	l->bgcolor=HPG_COLOR_WHITE;
+	l->ndirty=l->nprev=0;
+	layer_dirty(l,0,0,l->width-1,l->height-1);
+	return l;
+}
+
+void hpg_free_layers(hpg_layers_t *l)
+{
+	free(l);
+}
+
+int hpg_layer_add(hpg_layers_t *l,hpg_t *img,int x,int y,int flags)
+{
+	hpglayer *ly;
+	int id;
+
+	for(id=0;id<l->maxlayers && l->layers[id].img;++id) ;
+	if(id==l->maxlayers) return -1;
+	ly=&l->layers[id];
+	ly->img=img;
+	ly->x=x;
+	ly->y=y;
+	ly->w=hpg_get_width(img);
+	ly->h=hpg_get_height(img);
+	ly->flags=flags;
+	l->order[l->nlayers++]=id;
+	layer_dirtylayer(l,ly);
+	return id;
+}
+
+void hpg_layer_remove(hpg_layers_t *l,int id)
+{
+	hpglayer *ly=layer_get(l,id);
+	int k;
+
+	if(!ly) return;
+	layer_dirtylayer(l,ly);
+	ly->img=NULL;
+	for(k=0;l->order[k]!=id;++k) ;
+	for(;k<l->nlayers-1;++k) l->order[k]=l->order[k+1];
+	--l->nlayers;
+}
+
+void hpg_layer_move(hpg_layers_t *l,int id,int x,int y)
+{
+	hpglayer *ly=layer_get(l,id);
+
+	if(!ly || (ly->x==x && ly->y==y)) return;
+	layer_dirtylayer(l,ly);
+	ly->x=x;
+	ly->y=y;
+	layer_dirtylayer(l,ly);
+}
+
+void hpg_layer_show(hpg_layers_t *l,int id,int visible)
+{
+	hpglayer *ly=layer_get(l,id);
+
+	if(!ly || !(ly->flags&HPG_LAYER_VISIBLE)==!visible) return;
+	ly->flags|=HPG_LAYER_VISIBLE;
+	layer_dirtylayer(l,ly);
+	if(!visible) ly->flags&=~HPG_LAYER_VISIBLE;
+}
+
+void hpg_layer_set_z(hpg_layers_t *l,int id,int z)
+{
+	hpglayer *ly=layer_get(l,id);
+	int k;
+
+	if(!ly) return;
+	if(z<0) z=0;
+	if(z>=l->nlayers) z=l->nlayers-1;
+	for(k=0;l->order[k]!=id;++k) ;
+	if(k==z) return;
+	for(;k<z;++k) l->order[k]=l->order[k+1];
+	for(;k>z;--k) l->order[k]=l->order[k-1];
+	l->order[z]=id;
+	layer_dirtylayer(l,ly);
+}
+
+void hpg_layer_invalidate(hpg_layers_t *l,int id,int x1,int y1,int x2,int y2)
+{
+	hpglayer *ly=layer_get(l,id);
+
+	if(!ly || !(ly->flags&HPG_LAYER_VISIBLE)) return;
+	if(x1<0) x1=0;
+	if(y1<0) y1=0;
+	if(x2>=ly->w) x2=ly->w-1;
+	if(y2>=ly->h) y2=ly->h-1;
+	layer_dirty(l,ly->x+x1,ly->y+y1,ly->x+x2,ly->y+y2);
+}
+
+void hpg_layers_set_background(hpg_layers_t *l,unsigned char color)
+{
+	if(color==l->bgcolor) return;
+	l->bgcolor=color;
+	layer_dirty(l,0,0,l->width-1,l->height-1);
+}
+
+int hpg_layers_compose(hpg_layers_t *l)
+{
+	hpglrect list[HPG_LAYERS_MAXDIRTY];
+	hpg_pattern_t *oldpat;
+	unsigned char oldcolor,oldmode;
+	int k,n,area;
+
+	// THIS FRAME'S RECTANGLES, PLUS THE PREVIOUS FRAME'S WHEN DOUBLE BUFFERED
+	n=l->ndirty;
+	memcpy(list,l->dirty,n*sizeof(hpglrect));
+	if(l->dbuf) {
+		for(k=0;k<l->nprev;++k) layer_addrect(list,&n,l->prev[k]);
+		memcpy(l->prev,l->dirty,l->ndirty*sizeof(hpglrect));
+		l->nprev=l->ndirty;
+	}
+	l->ndirty=0;
+	if(!n) return 0;
+
+	oldcolor=hpg_get_color(l->target);
+	oldmode=hpg_get_mode(l->target);
+	oldpat=hpg_get_pattern(l->target);
+	hpg_set_color(l->target,l->bgcolor);
+	hpg_set_mode(l->target,HPG_MODE_PAINT);
+	hpg_set_pattern(l->target,NULL);
+
+	area=0;
+	for(k=0;k<n;++k) {
+		layer_compose(l,&list[k]);
+		area+=layer_area(&list[k]);
+	}
+
+	hpg_set_color(l->target,oldcolor);
+	hpg_set_mode(l->target,oldmode);
+	hpg_set_pattern(l->target,oldpat);
+	return area;
+}
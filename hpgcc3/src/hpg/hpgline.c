@@ -0,0 +1,171 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <hpgraphics.h>
+
+// BATCHED LINES
+// EACH SEGMENT IS CLIPPED TO THE IMAGE BEFORE IT IS RASTERIZED: OUTCODES
+// (COHEN-SUTHERLAND) ACCEPT OR REJECT WHOLE SEGMENTS, AND A PARTIALLY VISIBLE
+// ONE IS CUT IN BRESENHAM STEPS, SO THE PIXELS DRAWN ARE EXACTLY THE VISIBLE
+// PIXELS OF THE UNCLIPPED LINE. THE BRESENHAM LOOP OUTPUTS HORIZONTAL RUNS
+// (FLAT LINES) OR VERTICAL RUNS (STEEP LINES), AND TOUCHING RUNS IN THE SAME
+// ROW OR COLUMN ARE MERGED ACROSS SEGMENTS BEFORE THE hpg_fill_rect_on THAT
+// DRAWS THEM. IN A POLYLINE THE SHARED POINTS ARE DRAWN ONCE, WHICH KEEPS
+// XOR MODE CORRECT AND IS WHY RUNS ARE MERGED ONLY WHEN THEY TOUCH
+
+#define LINE_LEFT 1
+#define LINE_RIGHT 2
+#define LINE_TOP 4
+#define LINE_BOTTOM 8
+
+typedef struct {
+	hpg_t *g;
+	int width,height;
+	int x1,y1,x2,y2;		// PENDING RUN, x1==x2 OR y1==y2
+	int pending;
+} hpgliner;
+
+static inline int line_outcode(hpgliner *l,int x,int y)
+{
+	return ((x<0)? LINE_LEFT:0)|((x>=l->width)? LINE_RIGHT:0)|((y<0)? LINE_TOP:0)|((y>=l->height)? LINE_BOTTOM:0);
+}
+
+static void line_flush(hpgliner *l)
+{
+	if(l->pending) hpg_fill_rect_on(l->g,l->x1,l->y1,l->x2,l->y2);
+	l->pending=0;
+}
+
+// ADD THE RUN FROM (x1,y1) TO (x2,y2), x1<=x2 AND y1<=y2
+static void line_run(hpgliner *l,int x1,int y1,int x2,int y2)
+{
+	if(l->pending) {
+		if(y1==y2 && l->y1==y1 && l->y2==y1) {
+			if(x1==l->x2+1) { l->x2=x2; return; }
+			if(x2==l->x1-1) { l->x1=x1; return; }
+		}
+		if(x1==x2 && l->x1==x1 && l->x2==x1) {
+			if(y1==l->y2+1) { l->y2=y2; return; }
+			if(y2==l->y1-1) { l->y1=y1; return; }
+		}
+		line_flush(l);
+	}
+	l->x1=x1; l->y1=y1; l->x2=x2; l->y2=y2;
+	l->pending=1;
+}
+
+// ADD THE RUN OF STEPS [a,b] AT MINOR OFFSET v
+static inline void line_steps(hpgliner *l,int x0,int y0,int sx,int sy,int steep,int a,int b,int v)
+{
+	if(steep) {
+		if(sy>0) line_run(l,x0+sx*v,y0+a,x0+sx*v,y0+b);
+		else line_run(l,x0+sx*v,y0-b,x0+sx*v,y0-a);
+	}
+	else {
+		if(sx>0) line_run(l,x0+a,y0+sy*v,x0+b,y0+sy*v);
+		else line_run(l,x0-b,y0+sy*v,x0-a,y0+sy*v);
+	}
+}
+
+// FIRST STEP i>=0 WHERE THE MINOR COORDINATE floor((2*i*d+D)/(2*D)) REACHES v
+static inline int line_first(int v,int d,int D)
+{
+	long long n;
+
+	if(v<=0) return 0;
+	if(!d) return 0x7fffffff;
+	n=(long long)(2*v-1)*D;
+	return (int)((n+2*d-1)/(2*d));
+}
+
+// DRAW STEPS [skip0, D-skip1] OF THE SEGMENT, D=LENGTH ALONG THE MAJOR AXIS
+static void line_segment(hpgliner *l,int x0,int y0,int x1,int y1,int skip0,int skip1)
+{
+	int dx,dy,sx,sy,steep,D,d,i0,i1,t,lo,hi,vlo,vhi,err,u,v,start,c0,c1;
+
+	c0=line_outcode(l,x0,y0);
+	c1=line_outcode(l,x1,y1);
+	if(c0&c1) return;			// TRIVIALLY REJECTED
+
+	dx=x1-x0; sx=1;
+	if(dx<0) { dx=-dx; sx=-1; }
+	dy=y1-y0; sy=1;
+	if(dy<0) { dy=-dy; sy=-1; }
+	steep=(dy>dx);
+	D=steep? dy:dx;
+	d=steep? dx:dy;
+
+	i0=skip0;
+	i1=D-skip1;
+	if(c0|c1) {
+		// STEPS WHERE THE MAJOR COORDINATE IS INSIDE
+		if(steep) { lo=(sy>0)? -y0:y0-(l->height-1); hi=(sy>0)? l->height-1-y0:y0; }
+		else { lo=(sx>0)? -x0:x0-(l->width-1); hi=(sx>0)? l->width-1-x0:x0; }
+		if(lo>i0) i0=lo;
+		if(hi<i1) i1=hi;
+		// STEPS WHERE THE MINOR COORDINATE IS INSIDE
+		if(steep) { vlo=(sx>0)? -x0:x0-(l->width-1); vhi=(sx>0)? l->width-1-x0:x0; }
+		else { vlo=(sy>0)? -y0:y0-(l->height-1); vhi=(sy>0)? l->height-1-y0:y0; }
+		if(vhi<0) return;
+		t=line_first(vlo,d,D);
+		if(t>i0) i0=t;
+		t=line_first(vhi+1,d,D);
+		if(t!=0x7fffffff && t-1<i1) i1=t-1;
+	}
+	if(i0>i1) return;
+	if(!D) {
+		line_run(l,x0,y0,x0,y0);
+		return;
+	}
+
+	// BRESENHAM FROM STEP i0, err=2*u*d+D-2*(v+1)*D BECOMES >=0 AT THE FIRST
+	// STEP u WHERE THE MINOR COORDINATE IS v+1
+	v=(int)(((long long)2*i0*d+D)/(2*D));
+	err=(int)((long long)2*i0*d+D-(long long)2*(v+1)*D);
+	start=i0;
+	for(u=i0+1;u<=i1;++u) {
+		err+=2*d;
+		if(err>=0) {
+			line_steps(l,x0,y0,sx,sy,steep,start,u-1,v);
+			++v;
+			err-=2*D;
+			start=u;
+		}
+	}
+	line_steps(l,x0,y0,sx,sy,steep,start,i1,v);
+}
+
+
+void hpg_draw_lines_on(hpg_t *g,int *pts,int n,int flags)
+{
+	hpgliner l;
+	int k;
+
+	if(n<=0) return;
+	l.g=g;
+	l.width=hpg_get_width(g);
+	l.height=hpg_get_height(g);
+	l.pending=0;
+
+	if(!(flags&(HPG_LINES_STRIP|HPG_LINES_CLOSED))) {
+		for(k=0;k+1<n;k+=2) line_segment(&l,pts[2*k],pts[2*k+1],pts[2*k+2],pts[2*k+3],0,0);
+	}
+	else if(n==1) line_segment(&l,pts[0],pts[1],pts[0],pts[1],0,0);
+	else {
+		// EVERY SEGMENT AFTER THE FIRST SKIPS ITS FIRST PIXEL, THE CLOSING ONE
+		// ALSO ITS LAST
+		for(k=0;k+1<n;++k) line_segment(&l,pts[2*k],pts[2*k+1],pts[2*k+2],pts[2*k+3],k>0,0);
+		if((flags&HPG_LINES_CLOSED) && n>2) line_segment(&l,pts[2*n-2],pts[2*n-1],pts[0],pts[1],1,1);
+	}
+	line_flush(&l);
+}
+
+void hpg_draw_lines(int *pts,int n,int flags)
+{
+	hpg_draw_lines_on(HPG_STDSCREEN,pts,n,flags);
+}
@@ -0,0 +1,272 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <stdlib.h>
+#include <hpgraphics.h>
+
+// INCREMENTAL FUNCTION PLOTS
+// THE FUNCTION IS SAMPLED ONCE PER PIXEL COLUMN, AT x=k*xstep FOR THE
+// ABSOLUTE COLUMN NUMBER k. SAMPLES ARE KEPT IN A RING INDEXED BY k MODULO
+// THE WIDTH, SO A HORIZONTAL PAN ONLY INVALIDATES THE COLUMNS IT EXPOSES, AND
+// THE PICTURE IS SHIFTED WITH hpg_blit. PENDING COLUMNS ARE EVALUATED COARSE
+// FIRST (EVERY 8th k, THEN EVERY 4th, 2nd AND ALL), THE CURVE IS DRAWN
+// THROUGH THE SAMPLES AVAILABLE, SKIPPING PENDING COLUMNS AND BREAKING AT
+// UNDEFINED ONES.
+// AFTER EACH UPDATE ONLY THE COLUMNS BETWEEN THE VALID SAMPLES AROUND THE NEW
+// ONES ARE CLEARED AND REDRAWN, CLIPPED TO THOSE COLUMNS. A SEGMENT IS
+// RASTERIZED THE SAME WAY WHATEVER THE CLIP, SO THE RESULT IS THE PICTURE A
+// FULL REDRAW WOULD GIVE
+
+#define PLOT_PENDING 0
+#define PLOT_VALID 1
+#define PLOT_UNDEFINED 2
+
+#define PLOT_COARSE 8			// SAMPLE SPACING OF THE FIRST PASS
+#define PLOT_MAXROW 16000		// ROWS ARE CLAMPED TO +/- THIS
+
+struct hpg_plot {
+	hpg_t *img;
+	int width,height,bpp;
+	hpg_plot_func_t func;
+	void *arg;
+	unsigned char fg,bg,axes;
+	int flags;
+	int left;				// ABSOLUTE COLUMN NUMBER OF SCREEN COLUMN 0
+	double ytop;			// WORLD y OF ROW 0
+	double xstep,ystep;		// WORLD UNITS PER PIXEL
+	double *ys;				// SAMPLES BY k MODULO width
+	unsigned char *state;
+	int npending;
+	int *pts;				// POLYLINE BUFFER, 2*width INTS
+};
+
+
+static inline int plot_slot(hpg_plot_t *p,int col)
+{
+	int k=(p->left+col)%p->width;
+	return (k<0)? k+p->width:k;
+}
+
+static int plot_row(hpg_plot_t *p,double y)
+{
+	double r=(p->ytop-y)/p->ystep;
+
+	if(r>PLOT_MAXROW) return PLOT_MAXROW;
+	if(r<-PLOT_MAXROW) return -PLOT_MAXROW;
+	return (r<0)? -(int)(0.5-r):(int)(r+0.5);
+}
+
+static void plot_pending(hpg_plot_t *p,int c0,int c1)
+{
+	for(;c0<=c1;++c0) p->state[plot_slot(p,c0)]=PLOT_PENDING;
+}
+
+// CLEAR AND REDRAW SCREEN COLUMNS [c0,c1]
+static void plot_redraw(hpg_plot_t *p,int c0,int c1)
+{
+	int c,s,n,row;
+
+	if(c0<0) c0=0;
+	if(c1>=p->width) c1=p->width-1;
+	if(c0>c1) return;
+
+	hpg_clip_set(p->img,c0,0,c1,p->height-1);
+	hpg_set_mode(p->img,HPG_MODE_PAINT);
+	hpg_set_pattern(p->img,NULL);
+	hpg_set_color(p->img,p->bg);
+	hpg_fill_rect_on(p->img,c0,0,c1,p->height-1);
+
+	if(p->flags&HPG_PLOT_AXES) {
+		hpg_set_color(p->img,p->axes);
+		row=plot_row(p,0.0);
+		if(row>=0 && row<p->height) hpg_fill_rect_on(p->img,c0,row,c1,row);
+		if(-p->left>=c0 && -p->left<=c1) hpg_fill_rect_on(p->img,-p->left,0,-p->left,p->height-1);
+	}
+
+	// THE SEGMENTS CROSSING THE COLUMNS START AT THE LAST VALID SAMPLE
+	// BEFORE c0 AND END AT THE FIRST ONE AFTER c1
+	for(c=c0-1;c>=0 && p->state[plot_slot(p,c)]==PLOT_PENDING;--c) ;
+	if(c<0) c=0;
+	hpg_set_color(p->img,p->fg);
+	n=0;
+	for(;c<p->width;++c) {
+		s=plot_slot(p,c);
+		if(p->state[s]==PLOT_VALID) {
+			p->pts[2*n]=c;
+			p->pts[2*n+1]=plot_row(p,p->ys[s]);
+			++n;
+			if(c>c1) break;
+		}
+		else if(p->state[s]==PLOT_UNDEFINED) {
+			hpg_draw_lines_on(p->img,p->pts,n,HPG_LINES_STRIP);
+			n=0;
+			if(c>c1) break;
+		}
+	}
+	hpg_draw_lines_on(p->img,p->pts,n,HPG_LINES_STRIP);
+	hpg_clip_reset(p->img);
+}
+
+
+hpg_plot_t *hpg_alloc_plot(int width,int height,int bpp,hpg_plot_func_t func,void *arg)
+{
+	hpg_plot_t *p;
+
+	if(width<1 || height<1) return NULL;
+	p=(hpg_plot_t *)malloc(sizeof(hpg_plot_t)+width*(sizeof(double)+2*sizeof(int)+1));
+	if(!p) return NULL;
+	p->ys=(double *)(p+1);
+	p->pts=(int *)(p->ys+width);
+	p->state=(unsigned char *)(p->pts+2*width);
+	switch(bpp) {
+	case 1: p->img=hpg_alloc_mono_image(width,height); break;
+	case 2: p->img=hpg_alloc_gray4_image(width,height); break;
+	default: bpp=4; p->img=hpg_alloc_gray16_image(width,height); break;
+	}
+	if(!p->img) {
+		free(p);
+		return NULL;
+	}
+	p->width=width;
+	p->height=height;
+	p->bpp=bpp;
+	p->func=func;
+	p->arg=arg;
+	p->fg=HPG_COLOR_BLACK;
+	p->bg=HPG_COLOR_WHITE;
+	p->axes=HPG_COLOR_GRAY_8;
+	p->flags=HPG_PLOT_AXES;
+	p->left=-width/2;
+	p->ytop=height/2;
+	p->xstep=p->ystep=1.0;
+	plot_pending(p,0,width-1);
+	p->npending=width;
+	plot_redraw(p,0,width-1);
+	return p;
+}
+
+void hpg_free_plot(hpg_plot_t *p)
+{
+	hpg_free_image(p->img);
+	free(p);
+}
+
+hpg_t *hpg_plot_get_image(hpg_plot_t *p)
+{
+	return p->img;
+}
+
+void hpg_plot_set_style(hpg_plot_t *p,unsigned char fg,unsigned char bg,unsigned char axes,int flags)
+{
+	p->fg=fg;
+	p->bg=bg;
+	p->axes=axes;
+	p->flags=flags;
+	plot_redraw(p,0,p->width-1);
+}
+
+void hpg_plot_set_view(hpg_plot_t *p,double xmin,double ymax,double xstep,double ystep)
+{
+	double k;
+
+	if(xstep<=0 || ystep<=0) return;
+	k=xmin/xstep;
+	p->left=(k<0)? -(int)(0.5-k):(int)(k+0.5);
+	p->ytop=ymax;
+	p->xstep=xstep;
+	p->ystep=ystep;
+	hpg_plot_invalidate(p);
+}
+
+void hpg_plot_invalidate(hpg_plot_t *p)
+{
+	plot_pending(p,0,p->width-1);
+	p->npending=p->width;
+	plot_redraw(p,0,p->width-1);
+}
+
+void hpg_plot_pan(hpg_plot_t *p,int dx,int dy)
+{
+	hpg_t *tmp;
+	int w=p->width,keep,c;
+
+	p->ytop-=dy*p->ystep;
+	if(!dx) {
+		if(dy) plot_redraw(p,0,w-1);
+		return;
+	}
+
+	keep=w-((dx<0)? -dx:dx);
+	if(keep<=0 || dy) tmp=NULL;
+	else switch(p->bpp) {
+	case 1: tmp=hpg_pool_alloc_mono_image(keep,p->height); break;
+	case 2: tmp=hpg_pool_alloc_gray4_image(keep,p->height); break;
+	default: tmp=hpg_pool_alloc_gray16_image(keep,p->height); break;
+	}
+
+	// THE SLOTS OF THE COLUMNS LEAVING THE VIEW ARE THE ONES ENTERING IT
+	if(keep<=0) plot_pending(p,0,w-1);
+	else if(dx>0) plot_pending(p,0,dx-1);
+	else plot_pending(p,w+dx,w-1);
+	p->left+=dx;
+	p->npending=0;
+	for(keep=0;keep<w;++keep) if(p->state[plot_slot(p,keep)]==PLOT_PENDING) ++p->npending;
+
+	if(!tmp) {
+		// TOO FAR OR VERTICAL PAN TOO, REDRAW FROM THE SAMPLES LEFT
+		plot_redraw(p,0,w-1);
+		return;
+	}
+	keep=hpg_get_width(tmp);
+	hpg_blit(p->img,(dx>0)? dx:0,0,keep,p->height,tmp,0,0);
+	hpg_blit(tmp,0,0,keep,p->height,p->img,(dx>0)? 0:-dx,0);
+	hpg_pool_free_image(tmp);
+
+	// THE EXPOSED COLUMNS, AND AT THE OTHER EDGE THE COLUMNS UP TO THE FIRST
+	// SAMPLE, CROSSED BY A SEGMENT FROM A SAMPLE NOW OUT OF VIEW
+	if(dx>0) {
+		plot_redraw(p,keep,w-1);
+		for(c=0;c<w-1 && p->state[plot_slot(p,c)]==PLOT_PENDING;++c) ;
+		plot_redraw(p,0,c);
+	}
+	else {
+		plot_redraw(p,0,-dx-1);
+		for(c=w-1;c>0 && p->state[plot_slot(p,c)]==PLOT_PENDING;--c) ;
+		plot_redraw(p,c,w-1);
+	}
+}
+
+int hpg_plot_update(hpg_plot_t *p,int maxevals)
+{
+	int step,c,s,lo,hi,k;
+
+	lo=p->width;
+	hi=-1;
+	for(step=PLOT_COARSE;step && p->npending && maxevals;step>>=1) {
+		// FIRST COLUMN WITH k MULTIPLE OF step
+		k=p->left%step;
+		c=(k>0)? step-k:-k;
+		for(;c<p->width && maxevals;c+=step) {
+			s=plot_slot(p,c);
+			if(p->state[s]!=PLOT_PENDING) continue;
+			p->state[s]=(p->func((p->left+c)*p->xstep,&p->ys[s],p->arg))? PLOT_VALID:PLOT_UNDEFINED;
+			--p->npending;
+			--maxevals;
+			if(c<lo) lo=c;
+			if(c>hi) hi=c;
+		}
+	}
+	if(hi<0) return p->npending;
+
+	// FROM THE VALID SAMPLE BEFORE lo TO THE ONE AFTER hi, INCLUSIVE: THE
+	// SEGMENTS THAT CROSSED THE NEW SAMPLES CHANGE UP TO THERE
+	for(--lo;lo>0 && p->state[plot_slot(p,lo)]!=PLOT_VALID;--lo) ;
+	for(++hi;hi<p->width-1 && p->state[plot_slot(p,hi)]!=PLOT_VALID;++hi) ;
+	plot_redraw(p,lo,hi);
+	return p->npending;
+}
@@ -0,0 +1,238 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <stdlib.h>
+#include <hpgraphics.h>
+
+// HPG MEMORY POOL
+// IMAGES: A RELEASED IMAGE IS KEPT IDLE AND HANDED OUT AGAIN FOR THE NEXT
+// REQUEST OF THE SAME DEPTH AND SIZE, SO A BUFFER THAT IS ALLOCATED AND FREED
+// EVERY FRAME KEEPS ITS PLACE IN THE HEAP INSTEAD OF LEAVING HOLES IN IT.
+// THE TABLE TRACKS THE IMAGES IN USE TOO, TO KNOW THEIR DEPTH ON RELEASE.
+// BLOCKS: FREE LISTS BY SIZE CLASS, THE CLASS IS STORED IN A HEADER WORD.
+// LARGER BLOCKS GO STRAIGHT TO malloc
+
+#define POOL_NCLASSES 5
+#define POOL_MAXBLOCKS 8		// IDLE BLOCKS KEPT PER CLASS
+
+// SMALL BUFFERS SUCH AS PATTERNS, SCANLINE BUFFERS, EDGE TABLES, A 131x80
+// SCREEN AT 2 BITS PER PIXEL OR HALF OF ONE AT 4 (2620 BYTES), AND A FULL ONE
+// AT 4 (5240 BYTES). SIZES ARE ROUNDED UP TO 64 BYTES
+static const int pool_classes[POOL_NCLASSES]={ 64, 256, 1024, 2624, 5248 };
+
+typedef struct {
+	hpg_t *img;				// NULL = FREE ENTRY
+	short depth;			// BITS PER PIXEL
+	short inuse;
+	int width,height;
+	unsigned int stamp;		// RELEASE ORDER, TO DROP THE OLDEST IDLE IMAGE
+} hpgpoolimage;
+
+typedef union hpgpoolblock {
+	union hpgpoolblock *next;	// WHILE IDLE
+	int cls;					// WHILE IN USE, -1 = NOT FROM A CLASS
+	double align;
+} hpgpoolblock;
+
+static hpgpoolimage pool_images[HPG_POOL_MAXIMAGES];
+static hpgpoolblock *pool_free[POOL_NCLASSES];
+static int pool_nfree[POOL_NCLASSES];
+static unsigned int pool_stamp=0;
+static hpg_pool_stats_t pool_stats;
+
+
+static hpg_t *pool_newimage(int depth,int width,int height)
+{
+	switch(depth) {
+	case 1: return hpg_alloc_mono_image(width,height);
+	case 2: return hpg_alloc_gray4_image(width,height);
+	default: return hpg_alloc_gray16_image(width,height);
+	}
+}
+
+static hpg_t *pool_image(int depth,int width,int height)
+{
+	hpgpoolimage *e,*slot=NULL;
+	hpg_t *img;
+	int k;
+
+	++pool_stats.requests;
+	for(k=0;k<HPG_POOL_MAXIMAGES;++k) {
+		e=&pool_images[k];
+		if(!e->img) { if(!slot) slot=e; continue; }
+		if(!e->inuse && e->depth==depth && e->width==width && e->height==height) {
+			e->inuse=1;
+			++pool_stats.hits;
+			--pool_stats.idleimages;
+			pool_stats.idlebytes-=(width*height*depth+7)>>3;
+			return e->img;
+		}
+	}
+
+	if(!slot) {
+		// NO FREE ENTRY, DROP THE OLDEST IDLE IMAGE
+		for(k=0;k<HPG_POOL_MAXIMAGES;++k) {
+			e=&pool_images[k];
+			if(!e->inuse && (!slot || (int)(e->stamp-slot->stamp)<0)) slot=e;
+		}
+		if(slot) {
+			hpg_free_image(slot->img);
+			slot->img=NULL;
+			--pool_stats.idleimages;
+			pool_stats.idlebytes-=(slot->width*slot->height*slot->depth+7)>>3;
+		}
+	}
+
+	img=pool_newimage(depth,width,height);
+	if(!img && pool_stats.idleimages+pool_stats.idleblocks) {
+		// OUT OF MEMORY, RELEASE EVERYTHING IDLE AND RETRY ONCE
+		hpg_pool_trim();
+		img=pool_newimage(depth,width,height);
+	}
+	// WHEN THE TABLE IS FULL OF IMAGES IN USE THE NEW ONE IS NOT TRACKED
+	if(img && slot) {
+		slot->img=img;
+		slot->depth=depth;
+		slot->inuse=1;
+		slot->width=width;
+		slot->height=height;
+	}
+	return img;
+}
+
+hpg_t *hpg_pool_alloc_mono_image(int width,int height)
+{
+	return pool_image(1,width,height);
+}
+
+hpg_t *hpg_pool_alloc_gray4_image(int width,int height)
+{
+	return pool_image(2,width,height);
+}
+
+hpg_t *hpg_pool_alloc_gray16_image(int width,int height)
+{
+	return pool_image(4,width,height);
+}
+
+void hpg_pool_free_image(hpg_t *img)
+{
+	hpgpoolimage *e;
+	int k;
+
+	if(!img) return;
+	for(k=0;k<HPG_POOL_MAXIMAGES;++k) {
+		e=&pool_images[k];
+		if(e->img==img) {
+			e->inuse=0;
+			e->stamp=++pool_stamp;
+			++pool_stats.idleimages;
+			pool_stats.idlebytes+=(e->width*e->height*e->depth+7)>>3;
+			return;
+		}
+	}
+	hpg_free_image(img);
+}
+
+void *hpg_pool_malloc(int size)
+{
+	hpgpoolblock *b;
+	int cls;
+
+	++pool_stats.requests;
+	for(cls=0;cls<POOL_NCLASSES && pool_classes[cls]<size;++cls) ;
+	if(cls==POOL_NCLASSES) {
+		b=(hpgpoolblock *)malloc(sizeof(hpgpoolblock)+size);
+		if(!b) return NULL;
+		b->cls=-1;
+		return b+1;
+	}
+	b=pool_free[cls];
+	if(b) {
+		pool_free[cls]=b->next;
+		--pool_nfree[cls];
+		++pool_stats.hits;
+		--pool_stats.idleblocks;
+		pool_stats.idlebytes-=pool_classes[cls];
+	}
+	else {
+		b=(hpgpoolblock *)malloc(sizeof(hpgpoolblock)+pool_classes[cls]);
+		if(!b && pool_stats.idleblocks+pool_stats.idleimages) {
+			hpg_pool_trim();
+			b=(hpgpoolblock *)malloc(sizeof(hpgpoolblock)+pool_classes[cls]);
+		}
+		if(!b) return NULL;
+	}
+	b->cls=cls;
+	return b+1;
+}
+
+void hpg_pool_free(void *ptr)
+{
+	hpgpoolblock *b;
+	int cls;
+
+	if(!ptr) return;
+	b=((hpgpoolblock *)ptr)-1;
+	cls=b->cls;
+	if(cls<0 || pool_nfree[cls]>=POOL_MAXBLOCKS) {
+		free(b);
+		return;
+	}
+	b->next=pool_free[cls];
+	pool_free[cls]=b;
+	++pool_nfree[cls];
+	++pool_stats.idleblocks;
+	pool_stats.idlebytes+=pool_classes[cls];
+}
+
+void hpg_pool_trim(void)
+{
+	hpgpoolblock *b;
+	int k;
+
+	for(k=0;k<HPG_POOL_MAXIMAGES;++k) {
+		if(pool_images[k].img && !pool_images[k].inuse) {
+			hpg_free_image(pool_images[k].img);
+			pool_images[k].img=NULL;
+		}
+	}
+	for(k=0;k<POOL_NCLASSES;++k) {
+		while((b=pool_free[k])) {
+			pool_free[k]=b->next;
+			free(b);
+		}
+		pool_nfree[k]=0;
+	}
+	pool_stats.idleimages=pool_stats.idleblocks=pool_stats.idlebytes=0;
+}
+
+int hpg_pool_reset(void)
+{
+	int k,held=0;
+
+	// FREEING AN IMAGE IN USE WOULD LEAVE ITS OWNER A DANGLING POINTER, AND
+	// A DOUBLE FREE IN hpg_pool_free_image
+	for(k=0;k<HPG_POOL_MAXIMAGES;++k) if(pool_images[k].img && pool_images[k].inuse) ++held;
+	if(held) return held;
+
+	hpg_pool_trim();
+	// GLYPH STRIPS AND PATTERNS KEPT BY THE TEXT ROUTINES
+	hpg_flush_text_cache(NULL);
+	return 0;
+}
+
+void hpg_pool_get_stats(hpg_pool_stats_t *stats)
+{
+	*stats=pool_stats;
+}
+
+void hpg_pool_reset_stats(void)
+{
+	pool_stats.requests=pool_stats.hits=0;
+}
@@ -0,0 +1,240 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#include <stdlib.h>
+#include <string.h>
+#include <hpgraphics.h>
+
+// TEXT THROUGH 8-PIXEL STRIPS
+// GLYPHS ARE RENDERED ONCE PER FONT BY hpg_draw_letter_on ON A SCRATCH MONO
+// IMAGE AND KEPT AS ONE BYTE PER ROW, LEAST SIGNIFICANT BIT = LEFT PIXEL,
+// WHICH IS THE FORMAT OF HPG PATTERNS (THE ADVANCE IS AT MOST 8).
+// A LINE OF TEXT IS COMPOSED WITH SHIFTED ORs INTO STRIPS 8 PIXELS WIDE, AND
+// EACH NON-EMPTY STRIP IS DRAWN BY ONE hpg_fill_rect_on WITH A FLOATING
+// PATTERN MADE OF ITS ROWS. THE LINE IS CLIPPED TO THE IMAGE ONCE, WHOLE
+// STRIPS AT A TIME, AND THE LIBRARY CLIPS THE EDGES, APPLIES THE MODE AND
+// LEAVES THE PAPER PIXELS UNTOUCHED AS ITS OWN TEXT ROUTINES DO.
+// THE STRIP BUFFER AND ITS PATTERNS BELONG TO THE FONT CACHE AND ONLY GROW,
+// SO DRAWING TEXT DOES NOT ALLOCATE
+
+#define TEXT_GROUP 32			// GLYPHS RENDERED PER SCRATCH IMAGE
+
+typedef struct hpgglyphs {
+	hpg_font_t *font;
+	int height,advance;
+	unsigned char *bits;		// 256 GLYPHS OF height BYTES
+	unsigned int loaded;		// ONE BIT PER GROUP OF TEXT_GROUP GLYPHS
+	unsigned char *strips;		// nstrips STRIPS OF height BYTES
+	hpg_pattern_t **pats;		// PATTERN OF EACH STRIP, CREATED ON FIRST USE
+	int nstrips;
+	struct hpgglyphs *next;
+} hpgglyphs;
+
+static hpgglyphs *text_cache=NULL;
+
+
+// RENDER ONE GROUP OF GLYPHS, RETURN 0 IF OUT OF MEMORY
+static int text_load(hpgglyphs *gc,int group)
+{
+	hpg_t *img;
+	unsigned char *p;
+	int k,x,y,c;
+
+	img=hpg_pool_alloc_mono_image(8*TEXT_GROUP,gc->height);
+	if(!img) return 0;
+	hpg_clear_on(img);
+	hpg_set_font(img,gc->font);
+	hpg_set_color(img,HPG_COLOR_BLACK);
+	for(k=0;k<TEXT_GROUP;++k) {
+		c=group*TEXT_GROUP+k;
+		if(c) hpg_draw_letter_on(img,(char)c,8*k,0);
+	}
+	for(k=0;k<TEXT_GROUP;++k) {
+		p=gc->bits+(group*TEXT_GROUP+k)*gc->height;
+		for(y=0;y<gc->height;++y) {
+			c=0;
+			for(x=0;x<gc->advance;++x) if(hpg_get_pixel(img,8*k+x,y)) c|=1<<x;
+			p[y]=(unsigned char)c;
+		}
+	}
+	hpg_pool_free_image(img);
+	gc->loaded|=1U<<group;
+	return 1;
+}
+
+static void text_freestrips(hpgglyphs *gc)
+{
+	int k;
+
+	for(k=0;k<gc->nstrips;++k) if(gc->pats[k]) hpg_free_pattern(gc->pats[k]);
+	free(gc->pats);
+	free(gc->strips);
+	gc->strips=NULL;
+	gc->pats=NULL;
+	gc->nstrips=0;
+}
+
+// MAKE ROOM FOR n STRIPS, RETURN 0 IF OUT OF MEMORY
+static int text_strips(hpgglyphs *gc,int n)
+{
+	if(n<=gc->nstrips) return 1;
+	text_freestrips(gc);
+	n=(n+15)&~15;
+	gc->strips=(unsigned char *)malloc(n*gc->height);
+	gc->pats=(hpg_pattern_t **)malloc(n*sizeof(hpg_pattern_t *));
+	if(!gc->strips || !gc->pats) {
+		free(gc->strips);
+		free(gc->pats);
+		gc->strips=NULL;
+		gc->pats=NULL;
+		return 0;
+	}
+	memset((char *)gc->pats,0,n*sizeof(hpg_pattern_t *));
+	gc->nstrips=n;
+	return 1;
+}
+
+static hpgglyphs *text_get(hpg_font_t *font)
+{
+	hpgglyphs *gc;
+
+	for(gc=text_cache;gc;gc=gc->next) if(gc->font==font) return gc;
+
+	gc=(hpgglyphs *)malloc(sizeof(hpgglyphs));
+	if(!gc) return NULL;
+	gc->font=font;
+	gc->height=hpg_font_get_height(font);
+	gc->advance=hpg_font_get_advance(font);
+	if(gc->advance>8) gc->advance=8;
+	gc->bits=(unsigned char *)malloc(256*gc->height);
+	if(!gc->bits) {
+		free(gc);
+		return NULL;
+	}
+	gc->loaded=0;
+	gc->strips=NULL;
+	gc->pats=NULL;
+	gc->nstrips=0;
+	gc->next=text_cache;
+	text_cache=gc;
+	return gc;
+}
+
+// DRAW len CHARACTERS OF ONE LINE, THE STRIPS HOLD ROOM FOR THE WHOLE LINE
+static void text_line(hpg_t *g,hpgglyphs *gc,const unsigned char *s,int len,int x,int y,int width)
+{
+	unsigned char *glyph,*strip,*strips=gc->strips;
+	int k,r,pos,sh,nstrips,first,last,h=gc->height,adv=gc->advance;
+
+	if(len<=0 || y>=hpg_get_height(g) || y+h<=0) return;
+
+	// WHOLE STRIPS OUTSIDE THE IMAGE ARE NEVER COMPOSED NOR DRAWN
+	nstrips=(len*adv+7)>>3;
+	first=(x<0)? (-x)>>3:0;
+	last=(width-x+7)>>3;
+	if(last>nstrips) last=nstrips;
+	if(first>=last) return;
+
+	memset((char *)strips,0,nstrips*h);
+	for(k=first*8/adv;k<len;++k) {
+		pos=k*adv;
+		if((pos>>3)>=last) break;
+		if(!(gc->loaded&(1U<<(s[k]/TEXT_GROUP))) && !text_load(gc,s[k]/TEXT_GROUP)) return;
+		glyph=gc->bits+s[k]*h;
+		strip=strips+(pos>>3)*h;
+		sh=pos&7;
+		for(r=0;r<h;++r) strip[r]|=glyph[r]<<sh;
+		if(sh+adv>8) {
+			strip+=h;
+			for(r=0;r<h;++r) strip[r]|=glyph[r]>>(8-sh);
+		}
+	}
+
+	for(k=first;k<last;++k) {
+		strip=strips+k*h;
+		for(r=0;r<h && !strip[r];++r) ;
+		if(r==h) continue;			// BLANK, e.g. SPACES
+		if(!gc->pats[k]) gc->pats[k]=hpg_alloc_pattern((char *)strip,h,0);
+		if(!gc->pats[k]) return;
+		hpg_set_pattern(g,gc->pats[k]);
+		r=x+8*k+7;
+		if(r>x+len*adv-1) r=x+len*adv-1;
+		hpg_fill_rect_on(g,x+8*k,y,r,y+h-1);
+	}
+}
+
+
+void hpg_draw_text_fast_on(hpg_t *g,char *s,int x,int y)
+{
+	hpgglyphs *gc;
+	hpg_pattern_t *oldpat;
+	int len,maxlen,width;
+	char *p;
+
+	gc=text_get(hpg_get_font(g));
+	if(!gc || gc->advance<1 || gc->height<1) return;
+
+	// STRIPS FOR THE LONGEST LINE
+	maxlen=0;
+	for(p=s;*p;p+=len+(p[len]!=0)) {
+		for(len=0;p[len] && p[len]!='\n';++len) ;
+		if(len>maxlen) maxlen=len;
+	}
+	if(!maxlen) return;
+	if(!text_strips(gc,(maxlen*gc->advance+7)>>3)) return;
+
+	oldpat=hpg_get_pattern(g);
+	width=hpg_get_width(g);
+	for(p=s;*p;p+=len+(p[len]!=0),y+=gc->height) {
+		for(len=0;p[len] && p[len]!='\n';++len) ;
+		text_line(g,gc,(const unsigned char *)p,len,x,y,width);
+	}
+	hpg_set_pattern(g,oldpat);
+}
+
+void hpg_text_extent(hpg_font_t *font,char *s,int *width,int *height)
+{
+	int len,maxlen=0,lines=0;
+
+	while(*s) {
+		for(len=0;s[len] && s[len]!='\n';++len) ;
+		if(len>maxlen) maxlen=len;
+		++lines;
+		s+=len;
+		if(*s) ++s;
+	}
+	if(width) *width=maxlen*hpg_font_get_advance(font);
+	if(height) *height=lines*hpg_font_get_height(font);
+}
+
+const unsigned char *hpg_font_get_glyph(hpg_font_t *font,int c)
+{
+	hpgglyphs *gc;
+
+	c&=0xff;
+	gc=text_get(font);
+	if(!gc) return NULL;
+	if(!(gc->loaded&(1U<<(c/TEXT_GROUP))) && !text_load(gc,c/TEXT_GROUP)) return NULL;
+	return gc->bits+c*gc->height;
+}
+
+void hpg_flush_text_cache(hpg_font_t *font)
+{
+	hpgglyphs **ptr=&text_cache,*gc;
+
+	while(*ptr) {
+		gc=*ptr;
+		if(!font || gc->font==font) {
+			*ptr=gc->next;
+			text_freestrips(gc);
+			free(gc->bits);
+			free(gc);
+		}
+		else ptr=&gc->next;
+	}
+}
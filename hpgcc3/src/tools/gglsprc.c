@@ -0,0 +1,144 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+// GGL SPRITE COMPILER - HOST TOOL
+// CONVERTS AN XPM IMAGE OR A RAW GRAY16 DUMP INTO A C ARRAY IN THE
+// PRECOMPILED SPRITE FORMAT OF ggl_spriteblt, USING THE SAME ENCODER
+// AS ggl_mksprite
+//
+// USAGE: gglsprc [-n name] [-t tcol] [-w width] [-h height] file
+// XPM AND PGM FILES ARE DETECTED BY THEIR HEADER. XPM 'None' PIXELS ARE
+// TRANSPARENT AND COLORS ARE CONVERTED TO 16 GRAYS (0=WHITE, 15=BLACK)
+// RAW FILES ARE PACKED GRAY16 ROWS OF 'width' PIXELS, AS IN A gglsurface,
+// -w IS REQUIRED AND -h DEFAULTS TO THE WHOLE FILE. PIXELS OF COLOR
+// tcol ARE TRANSPARENT, WITHOUT -t THE SPRITE IS FULLY OPAQUE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ggl.h>
+#include "toolimg.h"
+
+static void putpix(int *buf,int off,int color)
+{
+	unsigned *p=((unsigned *)buf)+(off>>3);
+	int sh=(off&7)<<2;
+	*p=(*p&~(0xfU<<sh))|((unsigned)(color&0xf)<<sh);
+}
+
+static int *allocsurface(int width,int height)
+{
+	int *buf=(int *)calloc(((width*height+7)>>3)+1,sizeof(int));
+	if(!buf) tool_die("out of memory",NULL);
+	return buf;
+}
+
+
+// CONVERT A LUMINANCE IMAGE TO GRAY16 SURFACES, 'None' PIXELS CLEAR THE MASK
+static void togray16(toolimage *img,int **pixels,int **mask)
+{
+	int k;
+
+	*pixels=allocsurface(img->width,img->height);
+	*mask=allocsurface(img->width,img->height);
+	for(k=0;k<img->width*img->height;++k) {
+		if(!img->opaque[k]) continue;
+		putpix(*pixels,k,15-(img->lum[k]*15+127)/255);
+		putpix(*mask,k,15);
+	}
+}
+
+static void usage()
+{
+	fprintf(stderr,"usage: %s [-n name] [-t tcol] [-w width] [-h height] file\n",tool_progname);
+	exit(1);
+}
+
+int main(int argc,char *argv[])
+{
+	const char *name="sprite",*file=NULL;
+	int tcol=-1,width=0,height=0,k,size;
+	char *text;
+	long fsize;
+	int *pixels,*mask=NULL;
+	unsigned int *sprite;
+	gglsurface src,msk;
+	toolimage img;
+
+	tool_progname="gglsprc";
+
+	for(k=1;k<argc;++k) {
+		if(argv[k][0]=='-' && argv[k][1] && !argv[k][2] && k+1<argc) {
+			switch(argv[k][1]) {
+			case 'n': name=argv[++k]; continue;
+			case 't': tcol=atoi(argv[++k]); continue;
+			case 'w': width=atoi(argv[++k]); continue;
+			case 'h': height=atoi(argv[++k]); continue;
+			}
+			usage();
+		}
+		if(file) usage();
+		file=argv[k];
+	}
+	if(!file) usage();
+	if(tcol>15) tool_die("transparent color must be 0-15",NULL);
+
+	text=tool_readfile(file,&fsize);
+
+	if(tool_isxpm(text) || tool_ispgm(text)) {
+		if(tool_isxpm(text)) tool_readxpm(text,&img);
+		else tool_readpgm(text,fsize,&img);
+		width=img.width;
+		height=img.height;
+		togray16(&img,&pixels,&mask);
+		tool_freeimage(&img);
+		if(tcol>=0) {
+			// THE TRANSPARENT COLOR ALSO APPLIES TO XPM FILES
+			for(k=0;k<width*height;++k)
+				if(((((unsigned *)pixels)[k>>3]>>((k&7)<<2))&0xf)==(unsigned)tcol) putpix(mask,k,0);
+		}
+	}
+	else {
+		if(width<=0) tool_die("raw gray16 input needs -w",NULL);
+		if(height<=0) height=(int)(fsize*2/width);
+		if((long)width*height>fsize*2) tool_die("raw file too short for the given size",NULL);
+		pixels=allocsurface(width,height);
+		memcpy(pixels,text,(width*height+1)>>1);
+	}
+
+	src.addr=pixels; src.width=width; src.x=src.y=0;
+	msk.addr=mask; msk.width=width; msk.x=msk.y=0;
+
+	// NO TRANSPARENT COLOR, USE AN ALL-OPAQUE MASK
+	if(!mask && tcol<0) {
+		mask=allocsurface(width,height);
+		memset(mask,0xff,((width*height+7)>>3)*sizeof(int));
+		msk.addr=mask;
+	}
+
+	if(mask) size=ggl_mkspritemask(NULL,&src,&msk,width,height);
+	else size=ggl_mksprite(NULL,&src,width,height,tcol);
+	if(!size) tool_die("invalid sprite size",NULL);
+
+	sprite=(unsigned int *)malloc(size*sizeof(unsigned int));
+	if(!sprite) tool_die("out of memory",NULL);
+	if(mask) ggl_mkspritemask(sprite,&src,&msk,width,height);
+	else ggl_mksprite(sprite,&src,width,height,tcol);
+
+	printf("// GENERATED BY gglsprc FROM %s, %dx%d, %d WORDS\n",file,width,height,size);
+	printf("// DRAW WITH ggl_spriteblt(&surface,%s)\n\n",name);
+	printf("const unsigned int %s[%d]={",name,size);
+	for(k=0;k<size;++k) printf("%s0x%08x%s",(k%8)? " ":"\n\t",sprite[k],(k<size-1)? ",":"");
+	printf("\n};\n");
+
+	free(sprite);
+	free(pixels);
+	if(mask) free(mask);
+	free(text);
+	return 0;
+}
@@ -0,0 +1,85 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+// HPG IMAGE COMPILER - HOST TOOL
+// CONVERTS AN XPM OR PGM IMAGE INTO A C SOURCE FILE THAT DEFINES A
+// const hpg_static_t, READY FOR hpg_image_from_static
+//
+// USAGE: hpgimgc [-n name] [-d depth] file
+// depth IS THE NUMBER OF BITS PER PIXEL: 1 (MONO), 2 (4 GRAYS) OR
+// 4 (16 GRAYS, THE DEFAULT). PIXELS ARE PACKED AS IN A gglsurface OF THAT
+// DEPTH: OFFSET y*width+x, LEAST SIGNIFICANT BITS FIRST, 0=WHITE.
+// XPM 'None' PIXELS ARE WHITE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "toolimg.h"
+
+static void usage()
+{
+	fprintf(stderr,"usage: %s [-n name] [-d 1|2|4] file\n",tool_progname);
+	exit(1);
+}
+
+int main(int argc,char *argv[])
+{
+	const char *name="image",*file=NULL;
+	int bpp=4,k,nwords,maxv,v,off;
+	char *text;
+	long fsize;
+	unsigned int *bits;
+	toolimage img;
+
+	tool_progname="hpgimgc";
+
+	for(k=1;k<argc;++k) {
+		if(argv[k][0]=='-' && argv[k][1] && !argv[k][2] && k+1<argc) {
+			switch(argv[k][1]) {
+			case 'n': name=argv[++k]; continue;
+			case 'd': bpp=atoi(argv[++k]); continue;
+			}
+			usage();
+		}
+		if(file) usage();
+		file=argv[k];
+	}
+	if(!file) usage();
+	if(bpp!=1 && bpp!=2 && bpp!=4) tool_die("depth must be 1, 2 or 4",NULL);
+
+	text=tool_readfile(file,&fsize);
+	if(tool_isxpm(text)) tool_readxpm(text,&img);
+	else if(tool_ispgm(text)) tool_readpgm(text,fsize,&img);
+	else tool_die("not an XPM or PGM file: ",file);
+
+	nwords=(int)(((long)img.width*img.height*bpp+31)>>5);
+	bits=(unsigned int *)calloc(nwords,sizeof(unsigned int));
+	if(!bits) tool_die("out of memory",NULL);
+
+	// SAME ROUNDING AS gglsprc FOR 16 GRAYS
+	maxv=(1<<bpp)-1;
+	for(k=0;k<img.width*img.height;++k) {
+		if(!img.opaque[k]) continue;
+		v=maxv-(img.lum[k]*maxv+127)/255;
+		off=k*bpp;
+		bits[off>>5]|=(unsigned int)v<<(off&31);
+	}
+
+	printf("// GENERATED BY hpgimgc FROM %s, %dx%d, %d BPP\n",file,img.width,img.height,bpp);
+	printf("// LOAD WITH hpg_image_from_static(&%s)\n\n",name);
+	printf("#include <hpgraphics.h>\n\n");
+	printf("static const unsigned int %s_bits[%d]={",name,nwords);
+	for(k=0;k<nwords;++k) printf("%s0x%08x%s",(k%8)? " ":"\n\t",bits[k],(k<nwords-1)? ",":"");
+	printf("\n};\n\n");
+	printf("const hpg_static_t %s={ %d, %d, %d, %s_bits };\n",name,img.width,img.height,bpp,name);
+
+	free(bits);
+	tool_freeimage(&img);
+	free(text);
+	return 0;
+}
@@ -0,0 +1,223 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+// IMAGE READERS SHARED BY THE HOST TOOLS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "toolimg.h"
+
+const char *tool_progname="tool";
+
+void tool_die(const char *msg,const char *arg)
+{
+	fprintf(stderr,"%s: %s%s\n",tool_progname,msg,(arg)? arg:"");
+	exit(1);
+}
+
+char *tool_readfile(const char *name,long *size)
+{
+	FILE *f=fopen(name,"rb");
+	char *buf;
+	if(!f) tool_die("cannot open ",name);
+	fseek(f,0,SEEK_END);
+	*size=ftell(f);
+	fseek(f,0,SEEK_SET);
+	buf=(char *)malloc(*size+1);
+	if(!buf) tool_die("out of memory",NULL);
+	if(fread(buf,1,*size,f)!=(size_t)*size) tool_die("cannot read ",name);
+	buf[*size]=0;
+	fclose(f);
+	return buf;
+}
+
+static void allocimage(toolimage *img)
+{
+	img->lum=(unsigned char *)malloc(img->width*img->height);
+	img->opaque=(unsigned char *)malloc(img->width*img->height);
+	if(!img->lum || !img->opaque) tool_die("out of memory",NULL);
+	memset(img->lum,255,img->width*img->height);
+	memset(img->opaque,1,img->width*img->height);
+}
+
+void tool_freeimage(toolimage *img)
+{
+	free(img->lum);
+	free(img->opaque);
+	img->lum=img->opaque=NULL;
+}
+
+
+// XPM READER
+
+// RETURN THE NEXT QUOTED STRING, NUL-TERMINATED IN PLACE
+static char *xpm_next(char **ptr)
+{
+	char *p=*ptr,*start;
+	while(*p && *p!='"') {
+		// SKIP C COMMENTS, THEY MAY CONTAIN QUOTES
+		if(p[0]=='/' && p[1]=='*') {
+			p=strstr(p+2,"*/");
+			if(!p) tool_die("unterminated comment in XPM file",NULL);
+		}
+		++p;
+	}
+	if(!*p) tool_die("unexpected end of XPM file",NULL);
+	start=++p;
+	while(*p && *p!='"') ++p;
+	if(!*p) tool_die("unterminated string in XPM file",NULL);
+	*p=0;
+	*ptr=p+1;
+	return start;
+}
+
+static int hexval(int c)
+{
+	if(c>='0' && c<='9') return c-'0';
+	c=tolower(c);
+	if(c>='a' && c<='f') return c-'a'+10;
+	return -1;
+}
+
+// CONVERT AN XPM COLOR TO LUMINANCE 0-255, -1 = TRANSPARENT
+static int xpm_color(const char *spec)
+{
+	int len,digits,k,c[3],v;
+
+	if(!strcasecmp(spec,"none")) return -1;
+	if(!strcasecmp(spec,"black")) return 0;
+	if(!strcasecmp(spec,"white")) return 255;
+	if(spec[0]!='#') tool_die("unsupported XPM color ",spec);
+
+	len=strlen(spec+1);
+	if(len%3 || !len) tool_die("bad XPM color ",spec);
+	digits=len/3;
+	for(k=0;k<3;++k) {
+		const char *p=spec+1+k*digits;
+		int d;
+		// KEEP THE 8 MOST SIGNIFICANT BITS OF EACH COMPONENT
+		v=0;
+		for(d=0;d<digits;++d) {
+			if(hexval(p[d])<0) tool_die("bad XPM color ",spec);
+			if(d<2) v=(v<<4)|hexval(p[d]);
+		}
+		if(digits==1) v*=17;
+		c[k]=v;
+	}
+	return (int)((c[0]*299L+c[1]*587L+c[2]*114L)/1000);
+}
+
+// XPM FILES START WITH THE /* XPM */ MARKER
+int tool_isxpm(const char *text)
+{
+	while(isspace((unsigned char)*text)) ++text;
+	return !strncmp(text,"/* XPM */",9);
+}
+
+void tool_readxpm(char *text,toolimage *img)
+{
+	char *ptr=text,*s;
+	int ncolors,cpp,k,i,j;
+	char *keys;
+	int *colors;
+
+	s=xpm_next(&ptr);
+	if(sscanf(s,"%d %d %d %d",&img->width,&img->height,&ncolors,&cpp)!=4) tool_die("bad XPM header",NULL);
+	if(img->width<=0 || img->height<=0 || ncolors<=0 || cpp<=0) tool_die("bad XPM header",NULL);
+
+	keys=(char *)malloc(ncolors*cpp);
+	colors=(int *)malloc(ncolors*sizeof(int));
+	if(!keys || !colors) tool_die("out of memory",NULL);
+
+	for(k=0;k<ncolors;++k) {
+		char *tok,*value=NULL,*key;
+		s=xpm_next(&ptr);
+		if((int)strlen(s)<cpp) tool_die("bad XPM color line",NULL);
+		memcpy(keys+k*cpp,s,cpp);
+		// FIND THE 'c' KEY, FALL BACK TO 'g' OR 'm'
+		tok=strtok(s+cpp," \t");
+		while(tok) {
+			key=tok;
+			tok=strtok(NULL," \t");
+			if(!tok) break;
+			if(!strcmp(key,"c") || ((!strcmp(key,"g") || !strcmp(key,"m")) && !value)) value=tok;
+			tok=strtok(NULL," \t");
+		}
+		if(!value) tool_die("XPM color without a value",NULL);
+		colors[k]=xpm_color(value);
+	}
+
+	allocimage(img);
+
+	for(j=0;j<img->height;++j) {
+		s=xpm_next(&ptr);
+		if((int)strlen(s)<img->width*cpp) tool_die("short XPM pixel row",NULL);
+		for(i=0;i<img->width;++i,s+=cpp) {
+			for(k=0;k<ncolors;++k) if(!memcmp(keys+k*cpp,s,cpp)) break;
+			if(k>=ncolors) tool_die("undefined XPM pixel",NULL);
+			if(colors[k]<0) img->opaque[j*img->width+i]=0;
+			else img->lum[j*img->width+i]=(unsigned char)colors[k];
+		}
+	}
+	free(keys);
+	free(colors);
+}
+
+
+// PGM READER, BINARY (P5) AND ASCII (P2)
+
+int tool_ispgm(const char *text)
+{
+	return text[0]=='P' && (text[1]=='2' || text[1]=='5') && isspace((unsigned char)text[2]);
+}
+
+// READ THE NEXT DECIMAL NUMBER OF THE HEADER, SKIPPING # COMMENTS
+static int pgm_number(const char **ptr,const char *end)
+{
+	const char *p=*ptr;
+	int v=0;
+	for(;;) {
+		while(p<end && isspace((unsigned char)*p)) ++p;
+		if(p<end && *p=='#') {
+			while(p<end && *p!='\n') ++p;
+			continue;
+		}
+		break;
+	}
+	if(p>=end || !isdigit((unsigned char)*p)) tool_die("bad PGM file",NULL);
+	while(p<end && isdigit((unsigned char)*p)) v=v*10+(*p++-'0');
+	*ptr=p;
+	return v;
+}
+
+void tool_readpgm(const char *text,long size,toolimage *img)
+{
+	const char *p=text+2,*end=text+size;
+	int maxval,k,n,v,binary=(text[1]=='5');
+
+	img->width=pgm_number(&p,end);
+	img->height=pgm_number(&p,end);
+	maxval=pgm_number(&p,end);
+	if(img->width<=0 || img->height<=0 || maxval<=0 || maxval>65535) tool_die("bad PGM header",NULL);
+	// EXACTLY ONE WHITESPACE CHARACTER BEFORE BINARY DATA
+	++p;
+
+	allocimage(img);
+	n=img->width*img->height;
+	if(binary && (long)n*((maxval>255)? 2:1)>end-p) tool_die("PGM file too short",NULL);
+
+	for(k=0;k<n;++k) {
+		if(!binary) v=pgm_number(&p,end);
+		else if(maxval>255) { v=((unsigned char)p[0]<<8)|(unsigned char)p[1]; p+=2; }
+		else v=(unsigned char)*p++;
+		if(v>maxval) v=maxval;
+		img->lum[k]=(unsigned char)((v*255+maxval/2)/maxval);
+	}
+}
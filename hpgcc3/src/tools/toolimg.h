@@ -0,0 +1,33 @@
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+//& Claudio Lapilli
+//& Ingo Blank
+//&
+//& This file is licensed under the terms and conditions of the
+//& HPGCC3 license that is included with the source distribution.
+//& *** (c) 2006-2011 The HPGCC3 Team ***
+
+#ifndef TOOLIMG_H_
+#define TOOLIMG_H_
+
+// IMAGE READERS SHARED BY THE HOST TOOLS
+// IMAGES ARE READ AS ONE BYTE PER PIXEL: LUMINANCE (0=BLACK, 255=WHITE)
+// AND OPACITY (0 FOR XPM 'None' PIXELS, 1 OTHERWISE)
+
+typedef struct {
+	int width,height;
+	unsigned char *lum;
+	unsigned char *opaque;
+} toolimage;
+
+extern const char *tool_progname;	// SET BY EACH TOOL, USED IN ERROR MESSAGES
+
+void tool_die(const char *msg,const char *arg);
+char *tool_readfile(const char *name,long *size);
+
+int tool_isxpm(const char *text);
+int tool_ispgm(const char *text);
+void tool_readxpm(char *text,toolimage *img);
+void tool_readpgm(const char *text,long size,toolimage *img);
+void tool_freeimage(toolimage *img);
+
+#endif /*TOOLIMG_H_*/
@@ -31,6 +31,10 @@ for DEP in */ ; do
 done
 cd make_rom && make all
 cd ../install_all && make all
+
+# build the add-on modules and merge them into the installed libraries
+cp -f /hpgcc3/addon/include/*.h /hpgcc3/include/
+make -C /hpgcc3/addon/src install
 chmod 777 -R /hpgcc3/bin
 chmod 777 /hpgcc3/*
 